@@ -0,0 +1,381 @@
+#!/usr/bin/env perl
+
+# Simulator throughput benchmark. Runs a fixed matrix of
+# build x benchmark x TM protocol x number of cores for a bounded number
+# of instructions, and reports how fast the simulator runs (host seconds,
+# simulated KIPS, peak RSS). The results can be saved and compared
+# against a previous run (-baseline) to catch slowdowns.
+#
+# Example:
+#  simbench.pl -build tm=bin/sesc.trans -build stat=bin-stat/sesc.trans \
+#              -save base.res
+#  (...apply some change...)
+#  simbench.pl -build tm=bin/sesc.trans -build stat=bin-stat/sesc.trans \
+#              -baseline base.res
+
+BEGIN {
+  my $tmp = $0;
+  my $tmp2;
+
+  $tmp = readlink($tmp) if( -l $tmp );
+  $tmp =~ s/simbench.pl//;
+  unshift(@INC, $tmp);
+
+  $tmp2 = $0;
+  $tmp2 =~ s/simbench.pl//;
+  $tmp2 .= $tmp;
+  unshift(@INC, $tmp2);
+}
+
+use sesc;
+use strict;
+use Getopt::Long;
+use File::Spec;
+use File::Path;
+use Time::HiRes qw(time);
+
+###########################################
+# Parameters section:
+# All the parameters start with op_
+
+my @op_build;
+my $op_bhome;
+my $op_confdir;
+my $op_ninst=10000000; # 10M instructions per run
+my $op_bench;
+my $op_tm="ee,ll";
+my $op_cores="1,4";
+my $op_rep=1;
+my $op_workdir="simbench.runs";
+my $op_save;
+my $op_baseline;
+my $op_threshold=5;   # % slowdown that is flagged as regression
+my $op_keep;
+my $op_help;
+
+my $result = GetOptions("build=s",\@op_build,
+                        "bhome=s",\$op_bhome,
+                        "confdir=s",\$op_confdir,
+                        "ninst=i",\$op_ninst,
+                        "bench=s",\$op_bench,
+                        "tm=s",\$op_tm,
+                        "cores=s",\$op_cores,
+                        "rep=i",\$op_rep,
+                        "workdir=s",\$op_workdir,
+                        "save=s",\$op_save,
+                        "baseline=s",\$op_baseline,
+                        "threshold=f",\$op_threshold,
+                        "keep",\$op_keep,
+                        "help",\$op_help
+                       );
+
+###########################################
+# Benchmark matrix. @PNUM@ is replaced by the number of cores, and
+# @BDIR@ by the directory of the benchmark.
+
+my %benchs = (
+  "cholesky"  => "splash2/cholesky.mips.tm -p\@PNUM\@ -B32 -C16384 -t -s \@BDIR\@/cholesky.input.tk15.O",
+  "oceancon"  => "splash2/oceancon.mips.tm -s -o -p\@PNUM\@ -n258",
+  "raytrace"  => "splash2/raytrace.mips.tm -p\@PNUM\@ \@BDIR\@/raytrace.input.teapot.env",
+  "genome"    => "stamp/genome.mips.tm -g256 -s16 -n16384 -t\@PNUM\@",
+  "intruder"  => "stamp/intruder.mips.tm -t\@PNUM\@ -a10 -l4 -n2038 -s1",
+  "kmeans"    => "stamp/kmeans.mips.tm -m40 -n40 -t0.05 -p\@PNUM\@ -i \@BDIR\@/random1000_12",
+  "vacation"  => "stamp/vacation.mips.tm -c\@PNUM\@ -n2 -q90 -u98 -r16384 -t4096",
+  "ssca2"     => "stamp/ssca2.mips.tm -t\@PNUM\@ -s11 -i1.0 -u1.0 -l3 -p3",
+  );
+
+# TM protocols: conflictDetect/versioning in trans.conf
+my %tmModes = (
+  "ee" => [1, 1],  # Eager/Eager
+  "el" => [1, 0],  # Eager/Lazy
+  "ll" => [0, 0],  # Lazy/Lazy
+  );
+
+# Fields of each result (in order)
+my @resFields = ("build", "bench", "tm", "cores", "nInst", "hostSecs", "KIPS", "maxRSSKB", "nCycles");
+
+my %baseline;
+my $nRegress = 0;
+
+exit &main();
+
+###########################################
+sub main {
+
+  processParams();
+
+  readBaseline($op_baseline) if( defined $op_baseline );
+
+  my $savefp;
+  if( defined $op_save ) {
+    open($savefp, ">$op_save") or die "simbench.pl: could not create [$op_save]";
+    print $savefp "#" . join("\t", @resFields) . "\n";
+  }
+
+  printHeader();
+
+  my @benchList = defined $op_bench ? split(/,/, $op_bench) : sort keys %benchs;
+  my @tmList    = split(/,/, $op_tm);
+  my @coreList  = split(/,/, $op_cores);
+
+  foreach my $b (@op_build) {
+    my ($bname, $bpath) = split(/=/, $b, 2);
+
+    foreach my $bench (@benchList) {
+      die "simbench.pl: unknown benchmark [$bench]" unless( defined $benchs{$bench} );
+
+      foreach my $tm (@tmList) {
+        die "simbench.pl: unknown TM mode [$tm]" unless( defined $tmModes{$tm} );
+
+        foreach my $cores (@coreList) {
+          my $res = runBest($bname, $bpath, $bench, $tm, $cores);
+          next unless( defined $res );
+
+          printResult($res);
+          print $savefp join("\t", map { $res->{$_} } @resFields) . "\n" if( defined $savefp );
+        }
+      }
+    }
+  }
+
+  close($savefp) if( defined $savefp );
+
+  if( defined $op_baseline ) {
+    printf "# %d regression(s) above %g%%\n", $nRegress, $op_threshold;
+    return $nRegress ? 1 : 0;
+  }
+
+  return 0;
+}
+
+###########################################
+sub processParams {
+  my $badparams = 0;
+
+  if( @op_build == 0 ) {
+    print "You must specify at least one build (-build)\n";
+    $badparams = 1;
+  }
+
+  foreach my $b (@op_build) {
+    my ($bname, $bpath) = split(/=/, $b, 2);
+    unless( defined $bpath and -x $bpath ) {
+      print "Build [$b] is not name=executable\n";
+      $badparams = 1;
+    }
+  }
+
+  $op_bhome   = "$ENV{'BENCHDIR'}" unless( defined $op_bhome );
+  $op_confdir = "$ENV{'SESCBUILDDIR'}" unless( defined $op_confdir );
+
+  unless( -f "$op_confdir/sesc.conf" and -f "$op_confdir/trans.conf" ) {
+    print "Could not find sesc.conf and trans.conf in [$op_confdir] (-confdir)\n";
+    $badparams = 1;
+  }
+
+  if( $op_help or $badparams ) {
+    showUsage();
+    exit 0;
+  }
+
+  $op_bhome   = File::Spec->rel2abs($op_bhome);
+  $op_confdir = File::Spec->rel2abs($op_confdir);
+  $op_workdir = File::Spec->rel2abs($op_workdir);
+}
+
+###########################################
+sub showUsage {
+  print "usage:\n\tsimbench.pl [options] -build name=sesc [-build name2=sesc2]\n";
+  print "Options:\n";
+  print "\t-build name=exe : Simulator to measure (repeat for TM, STAT, PROFILE builds)\n";
+  print "\t-bhome dir      : Benchmark directory (default \$BENCHDIR)\n";
+  print "\t-confdir dir    : Directory with sesc.conf and trans.conf (default \$SESCBUILDDIR)\n";
+  print "\t-ninst=i        : Instructions to simulate per run (default $op_ninst)\n";
+  print "\t-bench=a,b      : Subset of benchmarks (default all)\n";
+  print "\t-tm=ee,el,ll    : TM protocols (Eager/Eager, Eager/Lazy, Lazy/Lazy) (default $op_tm)\n";
+  print "\t-cores=1,4      : Number of cores (default $op_cores)\n";
+  print "\t-rep=i          : Repetitions per point, the fastest is kept (default $op_rep)\n";
+  print "\t-workdir dir    : Where to run the simulations (default $op_workdir)\n";
+  print "\t-save file      : Save the results\n";
+  print "\t-baseline file  : Compare against saved results\n";
+  print "\t-threshold=f    : Slowdown in % flagged as regression (default $op_threshold)\n";
+  print "\t-keep           : Do not remove the run directories\n";
+  print "\nBenchmarks: " . join(" ", sort keys %benchs) . "\n";
+}
+
+###########################################
+sub key {
+  my ($build, $bench, $tm, $cores) = @_;
+
+  return "$build/$bench/$tm/$cores";
+}
+
+###########################################
+sub readBaseline {
+  my ($file) = @_;
+
+  open(FILE, "<$file") or die "simbench.pl: could not open baseline [$file]";
+  while(<FILE>) {
+    chomp;
+    next if( /^\#/ );
+
+    my @f = split(/\t/);
+    my %res;
+    @res{@resFields} = @f;
+
+    $baseline{key($res{build}, $res{bench}, $res{tm}, $res{cores})} = \%res;
+  }
+  close(FILE);
+}
+
+###########################################
+# Copies the configuration to a private directory with the number of
+# cores and the TM protocol patched.
+sub prepareConf {
+  my ($dir, $tm, $cores) = @_;
+
+  mkpath($dir);
+
+  open(IN, "<$op_confdir/sesc.conf") or die "simbench.pl: could not open sesc.conf";
+  open(OUT, ">$dir/sesc.conf") or die "simbench.pl: could not create $dir/sesc.conf";
+  while(<IN>) {
+    s/^procsPerNode\s*=\s*\d+/procsPerNode  = $cores/;
+    print OUT;
+  }
+  close(OUT);
+  close(IN);
+
+  my ($conflictDetect, $versioning) = @{$tmModes{$tm}};
+
+  open(IN, "<$op_confdir/trans.conf") or die "simbench.pl: could not open trans.conf";
+  open(OUT, ">$dir/trans.conf") or die "simbench.pl: could not create $dir/trans.conf";
+  while(<IN>) {
+    s/^conflictDetect(\s*)=\s*\d+/conflictDetect$1= $conflictDetect/;
+    s/^versioning(\s*)=\s*\d+/versioning$1= $versioning/;
+    print OUT;
+  }
+  close(OUT);
+  close(IN);
+}
+
+###########################################
+# Runs a point op_rep times and keeps the fastest run
+sub runBest {
+  my ($bname, $bpath, $bench, $tm, $cores) = @_;
+
+  my $best;
+  for(my $i=0;$i<$op_rep;$i++) {
+    my $res = runOne($bname, $bpath, $bench, $tm, $cores);
+    return undef unless( defined $res );
+
+    $best = $res if( !defined $best or $res->{hostSecs} < $best->{hostSecs} );
+  }
+
+  return $best;
+}
+
+###########################################
+sub runOne {
+  my ($bname, $bpath, $bench, $tm, $cores) = @_;
+
+  my $dir = "$op_workdir/" . key($bname, $bench, $tm, $cores);
+  rmtree($dir);
+  prepareConf($dir, $tm, $cores);
+
+  my $cmd = $benchs{$bench};
+  my ($suite) = split(/\//, $cmd);
+  $cmd =~ s/\@PNUM\@/$cores/g;
+  $cmd =~ s/\@BDIR\@/$op_bhome\/$suite/g;
+
+  my $sesc = File::Spec->rel2abs($bpath);
+  my $time = "/usr/bin/time";
+  my $rssFile = "$dir/rss";
+
+  my $exe = "$sesc -csesc.conf -y${op_ninst} -dsimbench $op_bhome/$cmd";
+  $exe = "$time -f %M -o $rssFile $exe" if( -x $time );
+
+  my $start = time();
+  my $ret = system("cd $dir && $exe >sim.out 2>&1");
+  my $hostSecs = time() - $start;
+
+  if( $ret ) {
+    print "# $bname $bench $tm $cores failed (see $dir/sim.out)\n";
+    return undef;
+  }
+
+  my @rep = glob("$dir/simbench.*");
+  if( @rep == 0 ) {
+    print "# $bname $bench $tm $cores did not generate a report\n";
+    return undef;
+  }
+
+  my $cf = sesc->new($rep[0]);
+
+  my $nInst = 0;
+  for(my $i=0;$i<$cores;$i++) {
+    $nInst += $cf->getResultField("PendingWindow(${i})_iBJ","n")
+      + $cf->getResultField("PendingWindow(${i})_iLoad","n")
+      + $cf->getResultField("PendingWindow(${i})_iStore","n")
+      + $cf->getResultField("PendingWindow(${i})_iALU","n")
+      + $cf->getResultField("PendingWindow(${i})_iComplex","n")
+      + $cf->getResultField("PendingWindow(${i})_fpALU","n")
+      + $cf->getResultField("PendingWindow(${i})_fpComplex","n")
+      + $cf->getResultField("PendingWindow(${i})_other","n");
+  }
+
+  my $maxRSS = "NA";
+  if( open(RSS, "<$rssFile") ) {
+    while(<RSS>) {
+      $maxRSS = $1 if( /^(\d+)\s*$/ );
+    }
+    close(RSS);
+  }
+
+  my %res;
+  $res{build}    = $bname;
+  $res{bench}    = $bench;
+  $res{tm}       = $tm;
+  $res{cores}    = $cores;
+  $res{nInst}    = $nInst;
+  $res{hostSecs} = sprintf("%.3f", $hostSecs);
+  $res{KIPS}     = sprintf("%.2f", $hostSecs > 0 ? $nInst/$hostSecs/1000 : 0);
+  $res{maxRSSKB} = $maxRSS;
+  $res{nCycles}  = $cf->getResultField("OSSim","nCycles");
+
+  rmtree($dir) unless( $op_keep );
+
+  return \%res;
+}
+
+###########################################
+sub printHeader {
+  printf "#%-8s %-10s %-3s %5s %12s %9s %10s %10s", "build", "bench", "tm", "cores", "nInst", "hostSecs", "KIPS", "maxRSSKB";
+  printf " %9s", "KIPS%" if( defined $op_baseline );
+  print "\n";
+}
+
+###########################################
+sub printResult {
+  my ($res) = @_;
+
+  printf " %-8s %-10s %-3s %5d %12d %9.2f %10.2f %10s"
+    , $res->{build}, $res->{bench}, $res->{tm}, $res->{cores}
+    , $res->{nInst}, $res->{hostSecs}, $res->{KIPS}, $res->{maxRSSKB};
+
+  if( defined $op_baseline ) {
+    my $base = $baseline{key($res->{build}, $res->{bench}, $res->{tm}, $res->{cores})};
+    if( defined $base and $base->{KIPS} > 0 ) {
+      my $delta = 100*($res->{KIPS} - $base->{KIPS})/$base->{KIPS};
+      printf " %+8.1f%%", $delta;
+      if( -$delta > $op_threshold ) {
+        print " REGRESSION";
+        $nRegress++;
+      }
+      # Different simulated results with the same configuration
+      print " (nCycles changed)" if( $base->{nCycles} != $res->{nCycles} );
+    }else{
+      printf " %9s", "new";
+    }
+  }
+  print "\n";
+}
@@ -976,14 +976,18 @@ BPOgehl::BPOgehl(int i, int fetchWidth,const char *section)
   SescConf->isBetween(section, "tcbits", 1, 15);
   SescConf->isBetween(section, "mtables", 6, 32);
 
+  predTables = new char[M_SIZ << logpred];
+  for (int j = 0; j < (M_SIZ << logpred); j++)
+    predTables[j] = 0;
   pred = new char*[M_SIZ];
-  for (int i = 0; i < M_SIZ; i++) {
-    pred[i] = new char[1 << logpred];
-    for (int j = 0; j < (1 << logpred); j++)
-      pred[i][j] = 0;
-  }
-
-  T = new int[nentry * logpred + 1];
+  for (int i = 0; i < M_SIZ; i++)
+    pred[i] = &predTables[i << logpred];
+
+  tStride = nentry * logpred + 1;
+  geoT  = new int[M_SIZ * tStride];
+  geoTm = new int[M_SIZ];
+  for (int i = 0; i < M_SIZ; i++)
+    geoTm[i] = -1;
   ghist = new long long[(glength >> 6) + 1];
   MINITAG = new char[(1 << (logpred - 1))];
   
@@ -1012,6 +1016,10 @@ BPOgehl::BPOgehl(int i, int fetchWidth,const char *section)
 
 BPOgehl::~BPOgehl()
 {
+  delete [] pred;
+  delete [] predTables;
+  delete [] geoT;
+  delete [] geoTm;
 }
 
 PredType BPOgehl::predict(const Instruction *inst, InstID oracleID, bool doUpdate)
@@ -1031,7 +1039,7 @@ PredType BPOgehl::predict(const Instruction *inst, InstID oracleID, bool doUpdat
   for (int i = 0; i < M_SIZ; i++) {
     if (i == 1)
       logpred--;
-    iID[i] = geoidx(inst->currentID(), ghist, phist, usedHistLength[i], (i & 3) + 1);    
+    iID[i] = geoidx(inst->currentID(), ghist, phist, usedHistLength[i], (i & 3) + 1, i);
     if (i == 1)
       logpred++;
     S += pred[i][iID[i]];
@@ -1116,7 +1124,7 @@ PredType BPOgehl::predict(const Instruction *inst, InstID oracleID, bool doUpdat
   return ptaken ? btb.predict(inst, oracleID, doUpdate) : CorrectPrediction;
 }
 
-int BPOgehl::geoidx(long long Add, long long *histo, long long phisto, int m, int funct)
+int BPOgehl::geoidx(long long Add, long long *histo, long long phisto, int m, int funct, int table)
 {
   long long inter, Hh, Res;
   int x, i, shift;
@@ -1139,11 +1147,15 @@ int BPOgehl::geoidx(long long Add, long long *histo, long long phisto, int m, in
       ((Add & ((1 << MinAdd) - 1)) << plength) +
       ((phisto & ((1 << plength) - 1)));
   }else{
-    for (x = 0; x < nentry * logpred; x++) {
-      T[x] = ((x * (addwidth + m + plength - 1)) / (nentry * logpred - 1));
-    }
+    int *T = &geoT[table * tStride];
+    if (geoTm[table] != m) {
+      geoTm[table] = m;
+      for (x = 0; x < nentry * logpred; x++) {
+        T[x] = ((x * (addwidth + m + plength - 1)) / (nentry * logpred - 1));
+      }
 
-    T[nentry * logpred] = addwidth + m + plength;
+      T[nentry * logpred] = addwidth + m + plength;
+    }
     inter = 0;
 
     Hh = histo[0];
@@ -1201,6 +1213,513 @@ void BPOgehl::switchOut(Pid_t pid)
 {
 }
 
+/*****************************************
+ * BPTage
+ *
+ * TAGE-SC-L, after "TAGE-SC-L Branch Predictors" by Andre Seznec (CBP
+ * 2014/2016): TAGE, a loop predictor and a statistical corrector
+ */
+
+static inline void tageCtrUpdate(signed char &ctr, bool taken, int nbits)
+{
+  if (taken) {
+    if (ctr < ((1 << (nbits - 1)) - 1))
+      ctr++;
+  }else{
+    if (ctr > -(1 << (nbits - 1)))
+      ctr--;
+  }
+}
+
+BPTage::BPTage(int i, int fetchWidth, const char *section)
+  :BPred(i, fetchWidth, section, "tage")
+  ,btb(  i, fetchWidth, section)
+  ,nTables(SescConf->checkInt(section, "tageTables") ? SescConf->getInt(section, "tageTables") : 7)
+  ,loopUsed("BPred(%d)_tage:loopUsed", i)
+  ,loopCorrect("BPred(%d)_tage:loopCorrect", i)
+  ,scFlip("BPred(%d)_tage:scFlip", i)
+  ,scFlipCorrect("BPred(%d)_tage:scFlipCorrect", i)
+  ,storageBits("BPred(%d)_tage:storageBits", i)
+{
+  if (SescConf->checkInt(section, "tageTables"))
+    SescConf->isBetween(section, "tageTables", 2, MaxTables - 1);
+
+  int baseTag = 8;
+  if (SescConf->checkInt(section, "tageTagBits")) {
+    SescConf->isBetween(section, "tageTagBits", 4, 12);
+    baseTag = SescConf->getInt(section, "tageTagBits");
+  }
+
+  int minHist = 5;
+  int maxHist = 300;
+  if (SescConf->checkInt(section, "tageMinHist")) {
+    SescConf->isBetween(section, "tageMinHist", 1, 64);
+    minHist = SescConf->getInt(section, "tageMinHist");
+  }
+  if (SescConf->checkInt(section, "tageMaxHist")) {
+    SescConf->isBetween(section, "tageMaxHist", minHist + 1, HistBufferSize/2);
+    maxHist = SescConf->getInt(section, "tageMaxHist");
+  }
+
+  useLoop = true;
+  if (SescConf->checkBool(section, "useLoop"))
+    useLoop = SescConf->getBool(section, "useLoop");
+  logLoop = 6;
+  if (SescConf->checkInt(section, "loopLogSize")) {
+    SescConf->isBetween(section, "loopLogSize", 2, 12);
+    logLoop = SescConf->getInt(section, "loopLogSize");
+  }
+
+  useSC = true;
+  if (SescConf->checkBool(section, "useSC"))
+    useSC = SescConf->getBool(section, "useSC");
+  logSC = 10;
+  if (SescConf->checkInt(section, "scLogSize")) {
+    SescConf->isBetween(section, "scLogSize", 4, 16);
+    logSC = SescConf->getInt(section, "scLogSize");
+  }
+
+  // Geometric history lengths, longer tables get longer tags
+  int tagSum = 0;
+  for (int t = 1; t <= nTables; t++) {
+    tagBits[t] = baseTag + (4*(t - 1))/(nTables - 1);
+    histLen[t] = (int)(minHist * pow((double)maxHist/minHist, (double)(t - 1)/(nTables - 1)) + 0.5);
+    tagSum += tagBits[t];
+  }
+
+  long long fixedBits = 0;
+  if (useLoop)
+    fixedBits += (1LL << logLoop) * (10 + 10 + 10 + 2 + 8 + 1);
+  if (useSC)
+    fixedBits += (NumSC + 1) * (1LL << logSC) * 6;
+
+  // Per 2^logSize: one entry per tagged table (3 bit ctr, 2 bit u, tag)
+  // and 4 base entries (2 bits)
+  long long unitBits = 5*nTables + tagSum + 8;
+  if (SescConf->checkInt(section, "tageBudget")) {
+    SescConf->isGT(section, "tageBudget", 0);
+    long long budget = SescConf->getInt(section, "tageBudget") * 8192LL;
+
+    logSize = 4;
+    while (logSize < 20 && (unitBits << (logSize + 1)) + fixedBits <= budget)
+      logSize++;
+  }else{
+    logSize = 10;
+    if (SescConf->checkInt(section, "tageLogSize")) {
+      SescConf->isBetween(section, "tageLogSize", 4, 20);
+      logSize = SescConf->getInt(section, "tageLogSize");
+    }
+  }
+  logBase = logSize + 2;
+  storageBits.add((unitBits << logSize) + fixedBits);
+
+  baseTable = new uchar[1 << logBase];
+  for (int j = 0; j < (1 << logBase); j++)
+    baseTable[j] = 2;
+
+  tables[0] = 0;
+  for (int t = 1; t <= nTables; t++) {
+    tables[t] = new TageEntry[1 << logSize];
+    for (int j = 0; j < (1 << logSize); j++) {
+      tables[t][j].ctr = 0;
+      tables[t][j].tag = 0;
+      tables[t][j].u   = 0;
+    }
+    idxFold[t].init(histLen[t], logSize);
+    tagFold0[t].init(histLen[t], tagBits[t]);
+    tagFold1[t].init(histLen[t], tagBits[t] - 1);
+  }
+
+  for (int j = 0; j < HistBufferSize; j++)
+    ghist[j] = 0;
+  ptGhist = 0;
+  phist   = 0;
+  ghr     = 0;
+
+  useAltOnNA = 0;
+  uTick      = 0;
+  seed       = 1;
+
+  loopTable = new LoopEntry[1 << logLoop];
+  for (int j = 0; j < (1 << logLoop); j++) {
+    loopTable[j].tag     = 0;
+    loopTable[j].curIter = 0;
+    loopTable[j].nbIter  = 0;
+    loopTable[j].conf    = 0;
+    loopTable[j].age     = 0;
+    loopTable[j].dir     = false;
+  }
+  withLoop = -1;
+
+  scBias = new signed char[1 << logSC];
+  for (int j = 0; j < (1 << logSC); j++)
+    scBias[j] = 0;
+  for (int k = 0; k < NumSC; k++) {
+    scTables[k] = new signed char[1 << logSC];
+    for (int j = 0; j < (1 << logSC); j++)
+      scTables[k][j] = 0;
+  }
+  scThreshold = 10;
+  scTC        = 0;
+
+  providerHit = new GStatsCntr *[nTables + 1];
+  allocs      = new GStatsCntr *[nTables + 1];
+  allocs[0]   = 0;
+  for (int t = 0; t <= nTables; t++) {
+    providerHit[t] = new GStatsCntr("BPred(%d)_tage_T(%d):hit", i, t);
+    if (t)
+      allocs[t] = new GStatsCntr("BPred(%d)_tage_T(%d):alloc", i, t);
+  }
+}
+
+BPTage::~BPTage()
+{
+  delete [] baseTable;
+  for (int t = 1; t <= nTables; t++)
+    delete [] tables[t];
+  delete [] loopTable;
+  delete [] scBias;
+  for (int k = 0; k < NumSC; k++)
+    delete [] scTables[k];
+}
+
+int BPTage::gindex(uint pc, int i) const
+{
+  int  hl   = histLen[i] < PathBits ? histLen[i] : PathBits;
+  uint path = phist & ((1 << hl) - 1);
+  path ^= path >> (logSize - (i % logSize));
+
+  int  shift = (logSize > i ? logSize - i : i - logSize) + 1;
+  uint idx   = pc ^ (pc >> shift) ^ idxFold[i].comp ^ (path << (i & 3));
+
+  return idx & ((1 << logSize) - 1);
+}
+
+ushort BPTage::gtag(uint pc, int i) const
+{
+  return (pc ^ tagFold0[i].comp ^ (tagFold1[i].comp << 1)) & ((1 << tagBits[i]) - 1);
+}
+
+// SC table i uses the last 4<<i outcomes
+int BPTage::scIndex(uint pc, int i, bool pred) const
+{
+  int hl = 4 << i;
+  HistoryType h = hl >= 64 ? ghr : (ghr & ((1ULL << hl) - 1));
+  uint f = (uint)(h ^ (h >> logSC) ^ (h >> (2*logSC)) ^ (h >> (3*logSC)));
+
+  uint idx = pc ^ (pc >> 2) ^ f ^ (i << 1);
+
+  return ((idx << 1) | (pred ? 1 : 0)) & ((1 << logSC) - 1);
+}
+
+bool BPTage::loopLookup(uint pc, bool &pred) const
+{
+  const LoopEntry &e = loopTable[loopIndex(pc)];
+  if (e.tag != loopTag(pc) || e.conf < 3)
+    return false;
+
+  pred = (e.curIter + 1 == e.nbIter) ? !e.dir : e.dir;
+  return true;
+}
+
+void BPTage::loopUpdate(uint pc, bool taken, bool tagePred, bool loopValid, bool loopPred)
+{
+  LoopEntry &e = loopTable[loopIndex(pc)];
+
+  if (e.tag != loopTag(pc)) {
+    // Only the branches that TAGE mispredicts get an entry, once in a while
+    if (taken != tagePred && (rand() & 3) == 0) {
+      if (e.age) {
+        e.age--;
+      }else{
+        e.tag     = loopTag(pc);
+        e.dir     = !taken;
+        e.curIter = 0;
+        e.nbIter  = 0;
+        e.conf    = 0;
+        e.age     = 7;
+      }
+    }
+    return;
+  }
+
+  if (loopValid) {
+    if (taken != loopPred) {
+      // not a loop anymore, free the entry
+      e.curIter = 0;
+      e.nbIter  = 0;
+      e.conf    = 0;
+      e.age     = 0;
+      return;
+    }
+    if (loopPred != tagePred && e.age < 255)
+      e.age++;
+  }
+
+  e.curIter = (e.curIter + 1) & 0x3ff;
+  if (e.curIter > e.nbIter) {
+    e.conf   = 0;
+    e.nbIter = 0;
+  }
+
+  if (taken != e.dir) {
+    // loop exit
+    if (e.curIter == e.nbIter) {
+      if (e.conf < 3)
+        e.conf++;
+      if (e.nbIter < 3) {
+        // too short to be predicted by the loop predictor
+        e.dir    = taken;
+        e.nbIter = 0;
+        e.age    = 0;
+        e.conf   = 0;
+      }
+    }else{
+      if (e.nbIter == 0) {
+        // first complete execution of the loop
+        e.conf   = 0;
+        e.nbIter = e.curIter;
+      }else{
+        // different trip count
+        e.nbIter = 0;
+        e.conf   = 0;
+      }
+    }
+    e.curIter = 0;
+  }
+}
+
+void BPTage::updateHistory(uint pc, bool taken)
+{
+  ptGhist = (ptGhist - 1) & (HistBufferSize - 1);
+  ghist[ptGhist] = taken ? 1 : 0;
+
+  for (int t = 1; t <= nTables; t++) {
+    idxFold[t].update(ghist, ptGhist);
+    tagFold0[t].update(ghist, ptGhist);
+    tagFold1[t].update(ghist, ptGhist);
+  }
+
+  phist = ((phist << 1) ^ (pc & 1)) & ((1 << PathBits) - 1);
+  ghr   = (ghr << 1) | (taken ? 1 : 0);
+}
+
+PredType BPTage::predict(const Instruction *inst, InstID oracleID, bool doUpdate)
+{
+  bpredEnergy->inc();
+
+  if( inst->isBranchTaken() )
+    return btb.predict(inst, oracleID, doUpdate);
+
+  bool taken = (inst->calcNextInstID() != oracleID);
+  uint pc    = inst->currentID();
+
+  // TAGE: the longest matching table provides the prediction, the next
+  // one (or the base table) the alternate prediction
+  for (int t = 1; t <= nTables; t++) {
+    gIdx[t] = gindex(pc, t);
+    gTag[t] = gtag(pc, t);
+  }
+
+  int provider = 0;
+  int alt      = 0;
+  for (int t = nTables; t > 0; t--) {
+    if (tables[t][gIdx[t]].tag != gTag[t])
+      continue;
+    if (provider == 0) {
+      provider = t;
+    }else{
+      alt = t;
+      break;
+    }
+  }
+
+  int  bIdx         = pc & ((1 << logBase) - 1);
+  bool basePred     = baseTable[bIdx] >= 2;
+  bool altPred      = alt ? tables[alt][gIdx[alt]].ctr >= 0 : basePred;
+  bool providerPred = basePred;
+  bool weakNew      = false;
+  int  conf         = 3; // |2*ctr+1| of the provider
+
+  if (provider) {
+    const TageEntry &e = tables[provider][gIdx[provider]];
+    providerPred = e.ctr >= 0;
+    conf         = 2*e.ctr + 1;
+    if (conf < 0)
+      conf = -conf;
+    weakNew      = conf == 1 && e.u == 0;
+  }
+  bool tagePred = (weakNew && useAltOnNA >= 0) ? altPred : providerPred;
+
+  // Loop predictor
+  bool loopPred  = false;
+  bool loopValid = useLoop && loopLookup(pc, loopPred);
+  bool pred1     = tagePred;
+  if (loopValid && withLoop >= 0) {
+    pred1 = loopPred;
+    conf  = 15;
+  }
+
+  // Statistical corrector: bias and global history tables plus the
+  // confidence of the prediction so far
+  bool ptaken  = pred1;
+  int  scSum   = 0;
+  int  biasIdx = 0;
+  int  scIdx[NumSC];
+  if (useSC) {
+    biasIdx = ((pc << 1) | (pred1 ? 1 : 0)) & ((1 << logSC) - 1);
+    scSum   = 2*scBias[biasIdx] + 1;
+    for (int k = 0; k < NumSC; k++) {
+      scIdx[k] = scIndex(pc, k, pred1);
+      scSum   += 2*scTables[k][scIdx[k]] + 1;
+    }
+    scSum += (pred1 ? 4 : -4) * conf;
+
+    ptaken = scSum >= 0;
+  }
+
+  if (doUpdate) {
+    if (useSC) {
+      if (ptaken != pred1) {
+        scFlip.inc();
+        scFlipCorrect.cinc(ptaken == taken);
+      }
+
+      int absSum = scSum < 0 ? -scSum : scSum;
+      if (ptaken != taken || absSum < scThreshold) {
+        tageCtrUpdate(scBias[biasIdx], taken, 6);
+        for (int k = 0; k < NumSC; k++)
+          tageCtrUpdate(scTables[k][scIdx[k]], taken, 6);
+      }
+
+      // Same dynamic threshold as O-GEHL
+      if (ptaken != taken) {
+        scTC++;
+        if (scTC > 31) {
+          scTC = 0;
+          scThreshold++;
+        }
+      }else if (absSum < scThreshold) {
+        scTC--;
+        if (scTC < -32) {
+          scTC = 0;
+          if (scThreshold > 1)
+            scThreshold--;
+        }
+      }
+    }
+
+    if (loopValid) {
+      if (withLoop >= 0) {
+        loopUsed.inc();
+        loopCorrect.cinc(loopPred == taken);
+      }
+      if (loopPred != tagePred) {
+        if (loopPred == taken) {
+          if (withLoop < 63)
+            withLoop++;
+        }else if (withLoop > -64) {
+          withLoop--;
+        }
+      }
+    }
+    if (useLoop)
+      loopUpdate(pc, taken, tagePred, loopValid, loopPred);
+
+    if (weakNew && providerPred != altPred) {
+      if (altPred == taken) {
+        if (useAltOnNA < 7)
+          useAltOnNA++;
+      }else if (useAltOnNA > -8) {
+        useAltOnNA--;
+      }
+    }
+
+    // Allocate a longer entry on a TAGE misprediction, starting in one of
+    // the next two tables. Age them if all of them are useful
+    if (tagePred != taken && provider < nTables) {
+      int start = provider + 1;
+      if (start < nTables && (rand() & 1))
+        start++;
+
+      bool done = false;
+      for (int t = start; t <= nTables && !done; t++) {
+        TageEntry &e = tables[t][gIdx[t]];
+        if (e.u == 0) {
+          e.tag = gTag[t];
+          e.ctr = taken ? 0 : -1;
+          allocs[t]->inc();
+          done = true;
+        }
+      }
+      if (!done) {
+        for (int t = provider + 1; t <= nTables; t++) {
+          if (tables[t][gIdx[t]].u)
+            tables[t][gIdx[t]].u--;
+        }
+      }
+    }
+
+    providerHit[provider]->inc();
+    if (provider) {
+      TageEntry &e = tables[provider][gIdx[provider]];
+      if (weakNew) {
+        if (alt) {
+          tageCtrUpdate(tables[alt][gIdx[alt]].ctr, taken, 3);
+        }else if (taken) {
+          if (baseTable[bIdx] < 3)
+            baseTable[bIdx]++;
+        }else if (baseTable[bIdx] > 0) {
+          baseTable[bIdx]--;
+        }
+      }
+      tageCtrUpdate(e.ctr, taken, 3);
+
+      if (providerPred != altPred) {
+        if (providerPred == taken) {
+          if (e.u < 3)
+            e.u++;
+        }else if (e.u) {
+          e.u--;
+        }
+      }
+    }else if (taken) {
+      if (baseTable[bIdx] < 3)
+        baseTable[bIdx]++;
+    }else if (baseTable[bIdx] > 0) {
+      baseTable[bIdx]--;
+    }
+
+    // Graceful reset of the useful bits
+    uTick++;
+    if (uTick >= (1 << 18)) {
+      uTick = 0;
+      for (int t = 1; t <= nTables; t++) {
+        for (int j = 0; j < (1 << logSize); j++)
+          tables[t][j].u >>= 1;
+      }
+    }
+
+    updateHistory(pc, taken);
+  }
+
+  if (taken != ptaken) {
+    if (doUpdate)
+      btb.updateOnly(inst,oracleID);
+    return MissPrediction;
+  }
+
+  return ptaken ? btb.predict(inst, oracleID, doUpdate) : CorrectPrediction;
+}
+
+void BPTage::switchIn(Pid_t pid)
+{
+}
+
+void BPTage::switchOut(Pid_t pid)
+{
+}
+
 /*****************************************
  * BPredictor
  */
@@ -1233,6 +1752,8 @@ BPred *BPredictor::getBPred(int id, int fetchWidth, const char *sec)
     pred = new BPyags(id, fetchWidth, sec);
   } else if (strcasecmp(type, "ogehl") == 0) {
     pred = new BPOgehl(id, fetchWidth, sec);
+  } else if (strcasecmp(type, "tage") == 0) {
+    pred = new BPTage(id, fetchWidth, sec);
   } else {
     MSG("BPredictor::BPredictor Invalid branch predictor type [%s] in section [%s]", type,sec);
     exit(0);
@@ -30,7 +30,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  *
  * Supported branch predictors models:
  *
- * Oracle, NotTaken, Taken, 2bit, 2Level, 2BCgSkew
+ * Oracle, NotTaken, Taken, 2bit, 2Level, 2BCgSkew, Hybrid, yags, ogehl, tage
  *
  */
 
@@ -370,15 +370,20 @@ private:
   int *histLength;
   int *usedHistLength;
   
-  int *T;
+  // geoidx bit positions, per table. Only depend on the history length
+  // of the table, recomputed when it changes
+  int  tStride;
+  int *geoT;
+  int *geoTm;
   int AC;  
   int miniTag;
   char *MINITAG;
   
+  char  *predTables; // the M tables, one after the other
   char **pred;
   int TC;
 protected:
-  int geoidx(long long Add, long long *histo, long long phisto, int m, int funct);
+  int geoidx(long long Add, long long *histo, long long phisto, int m, int funct, int table);
 public:
   BPOgehl(int i, int fetchWidth, const char *section);
   ~BPOgehl();
@@ -389,6 +394,137 @@ public:
   void switchOut(Pid_t pid);
 };
 
+// TAGE-SC-L: TAGE with a loop predictor and a statistical corrector
+// (Seznec, CBP 2014/2016), type = 'tage'.
+//
+//  tageTables   number of tagged tables (default 7, 2..15)
+//  tageLogSize  log2 entries of each tagged table (default 10). With
+//               tageBudget (KBytes) instead, the largest size that fits
+//               the budget is used (the base table has 4x the entries)
+//  tageTagBits  tag bits of the shortest table (default 8). The longer
+//               tables get up to 4 more bits
+//  tageMinHist, tageMaxHist  geometric history lengths (default 5, 300)
+//  useLoop, loopLogSize      loop predictor (default true, 6)
+//  useSC, scLogSize          statistical corrector (default true, 10)
+//
+// The histories are only updated with conditional branches and are
+// shared by all the threads, like in BPOgehl.
+class BPTage : public BPred {
+private:
+  enum { MaxTables = 16, HistBufferSize = 2048, PathBits = 16, NumSC = 4 };
+
+  class FoldedHistory {
+  public:
+    uint comp;
+    int  compLength;
+    int  origLength;
+    int  outPoint;
+
+    void init(int ol, int cl) {
+      comp       = 0;
+      origLength = ol;
+      compLength = cl;
+      outPoint   = ol % cl;
+    }
+    void update(const uchar *h, int pt) {
+      comp  = (comp << 1) ^ h[pt & (HistBufferSize - 1)];
+      comp ^= h[(pt + origLength) & (HistBufferSize - 1)] << outPoint;
+      comp ^= (comp >> compLength);
+      comp &= (1 << compLength) - 1;
+    }
+  };
+
+  class TageEntry {
+  public:
+    signed char ctr; // 3 bits, -4..3
+    ushort      tag;
+    uchar       u;   // 2 bits
+  };
+
+  class LoopEntry {
+  public:
+    ushort tag;
+    ushort curIter;
+    ushort nbIter;
+    uchar  conf;
+    uchar  age;
+    bool   dir;
+  };
+
+  BPBTB btb;
+
+  const int nTables;
+  int logSize;
+  int logBase;
+  int tagBits[MaxTables];
+  int histLen[MaxTables];
+
+  uchar     *baseTable;          // 2 bit counters
+  TageEntry *tables[MaxTables];  // 1..nTables
+
+  FoldedHistory idxFold[MaxTables];
+  FoldedHistory tagFold0[MaxTables];
+  FoldedHistory tagFold1[MaxTables];
+
+  uchar ghist[HistBufferSize];
+  int   ptGhist;
+  uint  phist;
+  HistoryType ghr;               // last 64 outcomes, for the SC
+
+  int  useAltOnNA;
+  int  uTick;
+  uint seed;
+
+  bool useLoop;
+  int  logLoop;
+  LoopEntry *loopTable;
+  int  withLoop;
+
+  bool useSC;
+  int  logSC;
+  signed char *scBias;
+  signed char *scTables[NumSC];
+  int  scThreshold;
+  int  scTC;
+
+  // lookup of the current branch
+  int    gIdx[MaxTables];
+  ushort gTag[MaxTables];
+
+  GStatsCntr **providerHit; // 0 is the base table
+  GStatsCntr **allocs;
+  GStatsCntr loopUsed;
+  GStatsCntr loopCorrect;
+  GStatsCntr scFlip;
+  GStatsCntr scFlipCorrect;
+  GStatsCntr storageBits;
+
+  uint rand() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+  }
+
+  int  gindex(uint pc, int i) const;
+  ushort gtag(uint pc, int i) const;
+  int  scIndex(uint pc, int i, bool pred) const;
+
+  int  loopIndex(uint pc) const { return pc & ((1 << logLoop) - 1); }
+  ushort loopTag(uint pc) const { return (pc >> logLoop) & 0x3ff; }
+  bool loopLookup(uint pc, bool &pred) const;
+  void loopUpdate(uint pc, bool taken, bool tagePred, bool loopValid, bool loopPred);
+
+  void updateHistory(uint pc, bool taken);
+
+public:
+  BPTage(int i, int fetchWidth, const char *section);
+  ~BPTage();
+
+  PredType predict(const Instruction * inst, InstID oracleID, bool doUpdate);
+
+  void switchIn(Pid_t pid);
+  void switchOut(Pid_t pid);
+};
+
 class BPredictor {
 private:
   const int id;
@@ -0,0 +1,248 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <pthread.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "BPredTrace.h"
+#include "BPred.h"
+#include "ReportGen.h"
+#include "SescConf.h"
+
+static const char  BPTMagic[4] = { 'S', 'B', 'P', 'T' };
+static const uchar BPTVersion  = 1;
+
+/*****************************************
+ * BPredTraceWriter
+ */
+
+std::vector<BPredTraceWriter *> BPredTraceWriter::writers;
+
+BPredTraceWriter::BPredTraceWriter(const char *fname)
+{
+  fd = fopen(fname, "w");
+  if (fd == 0) {
+    MSG("BPredTraceWriter: could not create [%s]", fname);
+    exit(-3);
+  }
+
+  fwrite(BPTMagic, 1, sizeof(BPTMagic), fd);
+  fwrite(&BPTVersion, 1, 1, fd);
+
+  buffPos = 0;
+  lastID  = 0;
+
+  writers.push_back(this);
+}
+
+BPredTraceWriter::~BPredTraceWriter()
+{
+  close();
+}
+
+void BPredTraceWriter::close()
+{
+  if (fd == 0)
+    return;
+
+  flush();
+  fclose(fd);
+  fd = 0;
+
+  for(size_t i = 0; i < writers.size(); i++) {
+    if (writers[i] == this) {
+      writers.erase(writers.begin() + i);
+      break;
+    }
+  }
+}
+
+void BPredTraceWriter::closeAll()
+{
+  while(!writers.empty())
+    writers.back()->close();
+}
+
+void BPredTraceWriter::flush()
+{
+  if (buffPos)
+    fwrite(buff, 1, buffPos, fd);
+  buffPos = 0;
+}
+
+/*****************************************
+ * BPredTuner
+ */
+
+BPredTuner::BPredTuner(const char *traceFile)
+{
+  FILE *fd = fopen(traceFile, "r");
+  if (fd == 0) {
+    MSG("BPredTuner: could not open [%s]", traceFile);
+    exit(-3);
+  }
+
+  char  magic[4];
+  uchar version = 0;
+  if (fread(magic, 1, sizeof(magic), fd) != sizeof(magic)
+      || memcmp(magic, BPTMagic, sizeof(magic)) != 0
+      || fread(&version, 1, 1, fd) != 1
+      || version != BPTVersion) {
+    MSG("BPredTuner: [%s] is not a branch trace", traceFile);
+    exit(-3);
+  }
+
+  // The whole trace stays in memory (a few bytes per branch), every
+  // thread decodes it on the fly
+  unsigned char tmp[64*1024];
+  size_t n;
+  while((n = fread(tmp, 1, sizeof(tmp), fd)) > 0)
+    trace.insert(trace.end(), tmp, tmp + n);
+  fclose(fd);
+
+  nBranches = 0;
+  nInsts    = 0;
+  const unsigned char *p   = trace.empty() ? 0 : &trace[0];
+  const unsigned char *end = p + trace.size();
+  while(p < end) {
+    const unsigned char *rec = p;
+    unsigned long long n, d, t;
+    if (!get(p, end, n) || !get(p, end, d) || !get(p, end, t)) {
+      // Keep the whole records only, the replay never sees the tail
+      MSG("BPredTuner: [%s] ends with a truncated record, ignored", traceFile);
+      trace.resize(rec - &trace[0]);
+      break;
+    }
+    nInsts += n;
+    nBranches++;
+  }
+
+  int nSections = SescConf->getRecordSize("", "bpredTune");
+  if (nSections <= 0) {
+    MSG("BPredTuner: no bpredTune[] sections in the configuration");
+    exit(-3);
+  }
+  for(int i = 0; i < nSections; i++)
+    sections.push_back(SescConf->getCharPtr("", "bpredTune", i));
+  nMiss.resize(nSections, 0);
+
+  fetchWidth = SescConf->getInt("cpucore", "fetchWidth", 0);
+
+  nThreads = 1;
+  if (SescConf->checkInt("", "bpredTuneThreads")) {
+    SescConf->isBetween("", "bpredTuneThreads", 1, 256);
+    nThreads = SescConf->getInt("", "bpredTuneThreads");
+  }
+  if (nThreads > nSections)
+    nThreads = nSections;
+
+  // Built here, not in the threads: the configuration and the
+  // statistics are not thread safe. All of them use id 0, their own
+  // statistics are not reported
+  for(int i = 0; i < nSections; i++)
+    preds.push_back(new BPredictor(0, fetchWidth, sections[i]));
+}
+
+BPredTuner::~BPredTuner()
+{
+  for(size_t k = 0; k < preds.size(); k++)
+    delete preds[k];
+}
+
+void BPredTuner::replay(int k)
+{
+  BPredictor *bpred = preds[k];
+
+  long long miss = 0;
+  InstID    id   = 0;
+
+  const unsigned char *p   = trace.empty() ? 0 : &trace[0];
+  const unsigned char *end = p + trace.size();
+  while(p < end) {
+    unsigned long long n, d, t;
+    if (!get(p, end, n) || !get(p, end, d) || !get(p, end, t))
+      break; // trimmed by the constructor
+
+    id = (InstID)((long long)id + unzigzag(d));
+
+    const Instruction *inst = Instruction::getInst(id);
+    InstID oracleID = t == 0 ? inst->calcNextInstID()
+                             : (InstID)((long long)id + unzigzag(t - 1));
+
+    miss += bpred->predict(inst, oracleID, true) != CorrectPrediction;
+  }
+
+  nMiss[k] = miss;
+}
+
+void *BPredTuner::worker(void *arg)
+{
+  Job *job = static_cast<Job *>(arg);
+  BPredTuner *t = job->tuner;
+
+  for(size_t k = job->first; k < t->sections.size(); k += t->nThreads)
+    t->replay(k);
+
+  return 0;
+}
+
+void BPredTuner::run()
+{
+#if ((defined TRACE_DRIVEN)||(defined MIPS_EMUL)||(defined QEMU_DRIVEN))
+  MSG("BPredTuner: branch trace replay needs the static instruction table (MINT)");
+  exit(-3);
+#else
+  timeval stTime;
+  timeval endTime;
+  gettimeofday(&stTime, 0);
+
+  MSG("BPredTuner: %lld branches, %lld instructions, %d predictors, %d threads"
+      ,nBranches, nInsts, (int)sections.size(), nThreads);
+
+  std::vector<Job> jobs(nThreads);
+  std::vector<pthread_t> threads(nThreads);
+  for(int i = 0; i < nThreads; i++) {
+    jobs[i].tuner = this;
+    jobs[i].first = i;
+  }
+
+  if (nThreads == 1) {
+    worker(&jobs[0]);
+  }else{
+    for(int i = 0; i < nThreads; i++)
+      pthread_create(&threads[i], 0, worker, &jobs[i]);
+    for(int i = 0; i < nThreads; i++)
+      pthread_join(threads[i], 0);
+  }
+
+  gettimeofday(&endTime, 0);
+  double secs = (endTime.tv_sec - stTime.tv_sec)
+    + (endTime.tv_usec - stTime.tv_usec)/1e6;
+
+  Report::field("BPredTune:nInsts=%lld:nBranches=%lld:secs=%.2f", nInsts, nBranches, secs);
+  for(size_t k = 0; k < sections.size(); k++) {
+    double mpki = nInsts ? (1000.0*nMiss[k])/nInsts : 0;
+    Report::field("BPredTune(%d):section=%s:nMiss=%lld:missRate=%.4f:mpki=%.3f"
+                  ,(int)k, sections[k], nMiss[k]
+                  ,nBranches ? (double)nMiss[k]/nBranches : 0, mpki);
+    MSG("BPredTune(%d) %-20s mpki=%.3f", (int)k, sections[k], mpki);
+  }
+#endif
+}
@@ -0,0 +1,160 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef BPREDTRACE_H
+#define BPREDTRACE_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "nanassert.h"
+#include "Instruction.h"
+
+class BPredictor;
+
+/*
+ * Branch trace record and replay.
+ *
+ * Recording: traceFile = "name" in the bpred section. Each FetchEngine
+ * writes the correct path branches it predicts to name.<fetch id>.
+ *
+ * Replay: sesc -B<trace> -c<conf> <same binary as the recording>
+ * The binary is only loaded to build the static instruction table. Every
+ * bpred section in bpredTune[] (root of the configuration) gets its own
+ * BPredictor, and the trace is replayed through them by
+ * bpredTuneThreads threads (default 1). The nBranches, nMiss and MPKI of
+ * each one go to the report file.
+ *
+ * File format: "SBPT" and a version byte, then per branch three
+ * variable length integers (7 bits per byte, low bits first):
+ *   instructions since the previous branch (branch included)
+ *   branch InstID minus the previous branch InstID (zigzag)
+ *   0 if not taken, else target minus branch InstID (zigzag) plus 1
+ */
+
+class BPredTraceWriter {
+private:
+  enum { BuffSize = 64*1024 };
+
+  // Open writers, closed by closeAll at the end of the simulation
+  static std::vector<BPredTraceWriter *> writers;
+
+  FILE *fd;
+
+  unsigned char buff[BuffSize];
+  int  buffPos;
+
+  InstID lastID;
+
+  void flush();
+
+  void put(unsigned long long v) {
+    while(v >= 0x80) {
+      buff[buffPos++] = (unsigned char)(v | 0x80);
+      v >>= 7;
+    }
+    buff[buffPos++] = (unsigned char)v;
+  }
+
+  static unsigned long long zigzag(long long v) {
+    return (v << 1) ^ (v >> 63);
+  }
+
+public:
+  BPredTraceWriter(const char *fname);
+  ~BPredTraceWriter();
+
+  void close();
+
+  // The simulation ends with exit(), FetchEngines are not destroyed
+  static void closeAll();
+
+  void record(const Instruction *inst, InstID oracleID, int nInsts) {
+    I(fd);
+    InstID id = inst->currentID();
+
+    // A record never spans two writes: 3 integers of up to 10 bytes
+    if (buffPos > BuffSize - 30)
+      flush();
+
+    put(nInsts);
+    put(zigzag((long long)id - (long long)lastID));
+    if (oracleID == inst->calcNextInstID())
+      put(0);
+    else
+      put(zigzag((long long)oracleID - (long long)id) + 1);
+
+    lastID = id;
+  }
+};
+
+class BPredTuner {
+private:
+  class Job {
+  public:
+    BPredTuner *tuner;
+    int first;
+  };
+
+  std::vector<unsigned char> trace;
+
+  std::vector<const char *> sections;
+  std::vector<BPredictor *> preds;
+  std::vector<long long>    nMiss;
+
+  long long nBranches;
+  long long nInsts;
+
+  int fetchWidth;
+  int nThreads;
+
+  // false if the integer does not end before end
+  static bool get(const unsigned char *&p, const unsigned char *end
+                  ,unsigned long long &v) {
+    v = 0;
+    int shift = 0;
+    while(p < end && (*p & 0x80)) {
+      if (shift > 63)
+        return false;
+      v |= ((unsigned long long)(*p & 0x7f)) << shift;
+      shift += 7;
+      p++;
+    }
+    if (p >= end)
+      return false;
+    v |= ((unsigned long long)*p) << shift;
+    p++;
+    return true;
+  }
+
+  static long long unzigzag(unsigned long long v) {
+    return (long long)(v >> 1) ^ -(long long)(v & 1);
+  }
+
+  void replay(int k);
+  static void *worker(void *arg);
+
+public:
+  BPredTuner(const char *traceFile);
+  ~BPredTuner();
+
+  void run();
+};
+
+#endif // BPREDTRACE_H
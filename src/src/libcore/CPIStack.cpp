@@ -0,0 +1,268 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "CPIStack.h"
+#include "DInst.h"
+#include "OSSim.h"
+#include "ReportGen.h"
+#include "SescConf.h"
+
+#if (defined TM)
+#include "transReport.h"
+#endif
+
+const char *CPIStack::causeName[MaxCPICause] = {
+  "base",
+  "frontEnd",
+  "iCache",
+  "bpred",
+  "window",
+  "lsq",
+  "exec",
+  "memL1",
+  "memL2",
+  "memory",
+  "store",
+  "fence",
+  "tmStall",
+  "tmAbort"
+};
+
+// First word of a memory section description ("DataL1 DL1")
+static char *firstWord(const char *desc)
+{
+  char *sec = strdup(desc);
+  char *end = strchr(sec, ' ');
+  if (end)
+    *end = 0;
+  return sec;
+}
+
+CPIStack::CPIStack(int id)
+  : Id(id)
+{
+  for(int c = 0; c < MaxCPICause; c++)
+    slots[c] = new GStatsCntr("CPIStack(%d):%s", id, causeName[c]);
+
+  // Hit delays of the L1 and of the first cache below it
+  l1Delay = 1;
+  l2Delay = 0;
+  if (SescConf->checkCharPtr("cpucore", "dataSource", id)) {
+    char *sec = firstWord(SescConf->getCharPtr("cpucore", "dataSource", id));
+    if (SescConf->checkInt(sec, "hitDelay"))
+      l1Delay = SescConf->getInt(sec, "hitDelay");
+
+    TimeDelta_t lat = l1Delay;
+    for(int hop = 0; hop < 4 && SescConf->checkCharPtr(sec, "lowerLevel"); hop++) {
+      char *next = firstWord(SescConf->getCharPtr(sec, "lowerLevel"));
+      free(sec);
+      sec = next;
+
+      if (SescConf->checkInt(sec, "hitDelay"))
+        lat += SescConf->getInt(sec, "hitDelay");
+      else if (SescConf->checkInt(sec, "delay"))
+        lat += SescConf->getInt(sec, "delay"); // buses
+
+      if (SescConf->checkCharPtr(sec, "deviceType")
+          && strcmp(SescConf->getCharPtr(sec, "deviceType"), "cache") == 0) {
+        l2Delay = lat;
+        break;
+      }
+    }
+    free(sec);
+  }
+  if (l2Delay <= l1Delay)
+    l2Delay = 5*l1Delay;
+
+  memHead  = 0;
+  memCid   = -1;
+  memStart = 0;
+  memSlots = 0;
+
+  curMark  = 0;
+  curPhase = &phases[0];
+}
+
+CPIStack::~CPIStack()
+{
+  for(int c = 0; c < MaxCPICause; c++)
+    delete slots[c];
+}
+
+void CPIStack::commit(CPICause c, long long n)
+{
+  slots[c]->add(n);
+
+  uint mark = osSim->getSimulationMark();
+  if (mark != curMark) {
+    curMark  = mark;
+    curPhase = &phases[mark];
+  }
+  curPhase->s[c] += n;
+}
+
+int CPIStack::contextOf(const DInst *dinst)
+{
+  return dinst ? dinst->getContextId() : -1;
+}
+
+void CPIStack::account(CPICause c, long long n, int cid)
+{
+  if (n == 0)
+    return;
+
+  if (open.empty()) {
+    commit(c, n);
+    return;
+  }
+
+  OpenMap::iterator it = open.find(cid);
+  if (it == open.end() && cid < 0 && open.size() == 1)
+    it = open.begin();
+
+  if (it == open.end())
+    commit(c, n);
+  else
+    it->second.pending.s[c] += n;
+}
+
+void CPIStack::closeMem()
+{
+  I(memHead);
+
+  Time_t blocked = globalClock - memStart;
+  CPICause c;
+  if (blocked <= l1Delay)
+    c = CPIMemL1;
+  else if (blocked <= l2Delay)
+    c = CPIMemL2;
+  else
+    c = CPIMemory;
+
+  account(c, memSlots, memCid);
+
+  memHead  = 0;
+  memSlots = 0;
+}
+
+void CPIStack::stalledMem(int n, const DInst *head)
+{
+  if (head != memHead) {
+    if (memHead)
+      closeMem();
+    memHead  = head;
+    memCid   = contextOf(head);
+    memStart = globalClock;
+  }
+  memSlots += n;
+}
+
+void CPIStack::transBegin(int tid, int bcFlag, int cid)
+{
+  if (bcFlag == 2)
+    return; // subsumed
+
+  OpenMap::iterator it = open.find(cid);
+  if (it != open.end()) {
+    const Stack &pending = it->second.pending;
+    TransStack &t = trans[it->second.tid];
+    if (bcFlag == 1) {
+      // The previous attempt aborted, all its slots were wasted
+      long long n = 0;
+      for(int c = 0; c < MaxCPICause; c++)
+        n += pending.s[c];
+      t.aborted.add(pending);
+      t.nAborts++;
+      commit(CPITMAbort, n);
+    }else{
+      t.committed.add(pending);
+      for(int c = 0; c < MaxCPICause; c++)
+        commit(static_cast<CPICause>(c), pending.s[c]);
+    }
+  }
+
+  OpenTrans &o = open[cid];
+  o.tid     = tid;
+  o.pending = Stack();
+}
+
+void CPIStack::transCommit(int bcFlag, int cid)
+{
+  if (bcFlag == 2)
+    return;
+
+  OpenMap::iterator it = open.find(cid);
+  if (it == open.end())
+    return;
+
+  const Stack &pending = it->second.pending;
+  TransStack &t = trans[it->second.tid];
+  t.committed.add(pending);
+  t.nCommits++;
+  for(int c = 0; c < MaxCPICause; c++)
+    commit(static_cast<CPICause>(c), pending.s[c]);
+
+  open.erase(it);
+}
+
+void CPIStack::format(char *str, const Stack &st)
+{
+  str[0] = 0;
+  for(int c = 0; c < MaxCPICause; c++)
+    str += sprintf(str, ":%s=%lld", causeName[c], st.s[c]);
+}
+
+void CPIStack::report(const char *str)
+{
+  char line[1024];
+
+  for(OpenMap::const_iterator it = open.begin(); it != open.end(); it++) {
+    // Still open: its slots are not known to commit or abort yet
+    format(line, it->second.pending);
+    Report::field("CPIStack(%d):tid=%d:open%s", Id, it->second.tid, line);
+  }
+
+  if (phases.size() > 1) {
+    for(PhaseMap::const_iterator it = phases.begin(); it != phases.end(); it++) {
+      format(line, it->second);
+      Report::field("CPIStack(%d):phase=%u%s", Id, it->first, line);
+    }
+  }
+
+  for(TransMap::const_iterator it = trans.begin(); it != trans.end(); it++) {
+    const TransStack &t = it->second;
+
+    format(line, t.committed);
+    Report::field("CPIStack(%d):tid=%d:nCommits=%lld%s", Id, it->first, t.nCommits, line);
+    format(line, t.aborted);
+    Report::field("CPIStack(%d):tid=%d:nAborts=%lld%s", Id, it->first, t.nAborts, line);
+
+#if (defined TM)
+    format(line, t.committed);
+    fprintf(tmReport->getOutfile(), "<Trans> cpiStack: CM :%d:%d:%lld%s\n"
+            ,Id, it->first, t.nCommits, line);
+    format(line, t.aborted);
+    fprintf(tmReport->getOutfile(), "<Trans> cpiStack: AB :%d:%d:%lld%s\n"
+            ,Id, it->first, t.nAborts, line);
+#endif
+  }
+}
@@ -0,0 +1,174 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef CPISTACK_H
+#define CPISTACK_H
+
+#include <map>
+
+#include "nanassert.h"
+#include "GStats.h"
+#include "Snippets.h"
+
+class DInst;
+
+/*
+ * Cycle stacked CPI breakdown.
+ *
+ * Every cycle the processor gives each of its retireWidth retire slots
+ * to one cause: retired (base) or the reason why the slot was lost. The
+ * causes add up to clockTicks*retireWidth of the processor.
+ *
+ * The slots lost behind the same memory access at the head of the ROB
+ * are classified by level when the access finishes, comparing how long
+ * it blocked retirement with the L1 and L2 hit delays of the dataSource.
+ *
+ * With TM, the slots between the outermost begin and its commit are held
+ * apart. A commit adds them to their causes, a replayed begin (BCFlag 1)
+ * adds all the slots of the aborted attempt to tmAbort. The open
+ * transactions are kept per context (SMT): a slot goes to the one of the
+ * context of the instruction that retired or blocked it. The slots with
+ * an empty ROB go to the open transaction if there is only one.
+ *
+ * The slots of a transaction still open at report time are only shown
+ * apart (tid=N:open). They stay pending, so that a report on the fly
+ * does not change the stack, and are not in the totals. Neither are the
+ * slots of a head memory access that has not finished yet.
+ *
+ * Totals are GStats (CPIStack(id):cause). The report also has one stack
+ * per simulation mark phase (when marks are used) and, with TM, one per
+ * static transaction id, also written to the transReport file.
+ */
+
+enum CPICause {
+  CPIBase = 0,  // retired
+  CPIFrontEnd,  // ROB empty: fetch bandwidth, taken branches, decode
+  CPIICache,    // ROB empty, waiting for the instruction cache
+  CPIBPred,     // ROB empty, misprediction resolution and refill
+  CPIWindow,    // head not executed, rename stalled on window/ROB/registers
+  CPILSQ,       // head not executed, rename stalled on the LSQ
+  CPIExec,      // head not executed: dependences, functional units
+  CPIMemL1,     // head memory access, up to the L1 hit delay
+  CPIMemL2,     // head memory access, up to the L2 hit delay
+  CPIMemory,    // head memory access, longer
+  CPIStore,     // head store without cache space or ports
+  CPIFence,     // head waiting for a fence
+  CPITMStall,   // TM NACK stall or abort backoff
+  CPITMAbort,   // any slot of an aborted transaction attempt
+  MaxCPICause
+};
+
+class CPIStack {
+private:
+  class Stack {
+  public:
+    long long s[MaxCPICause];
+    Stack() {
+      for(int c = 0; c < MaxCPICause; c++)
+        s[c] = 0;
+    }
+    void add(const Stack &o) {
+      for(int c = 0; c < MaxCPICause; c++)
+        s[c] += o.s[c];
+    }
+  };
+
+  class TransStack {
+  public:
+    Stack committed;
+    Stack aborted;
+    long long nCommits;
+    long long nAborts;
+    TransStack() : nCommits(0), nAborts(0) { }
+  };
+
+  class OpenTrans {
+  public:
+    int   tid;
+    Stack pending;
+  };
+
+  typedef std::map<uint, Stack>      PhaseMap;
+  typedef std::map<int, TransStack>  TransMap;
+  typedef std::map<int, OpenTrans>   OpenMap;
+
+  static const char *causeName[MaxCPICause];
+
+  const int Id;
+
+  GStatsCntr *slots[MaxCPICause];
+
+  TimeDelta_t l1Delay;
+  TimeDelta_t l2Delay;
+
+  // Memory access blocking the head
+  const DInst *memHead;
+  int    memCid;
+  Time_t memStart;
+  long long memSlots;
+
+  PhaseMap phases;
+  uint   curMark;
+  Stack *curPhase;
+
+  // Open transactions, by context
+  OpenMap open;
+
+  TransMap trans;
+
+  static int contextOf(const DInst *dinst);
+
+  void closeMem();
+  void account(CPICause c, long long n, int cid);
+  void commit(CPICause c, long long n);
+
+  static void format(char *str, const Stack &st);
+
+public:
+  CPIStack(int id);
+  ~CPIStack();
+
+  // n slots retired by context cid
+  void retired(int n, int cid) {
+    if (n == 0)
+      return;
+    if (memHead)
+      closeMem();
+    account(CPIBase, n, cid);
+  }
+
+  // n slots lost for c behind head (0 if the ROB is empty)
+  void stalled(int n, CPICause c, const DInst *head) {
+    if (memHead)
+      closeMem();
+    account(c, n, open.empty() ? -1 : contextOf(head));
+  }
+
+  // n slots lost behind head, a memory access
+  void stalledMem(int n, const DInst *head);
+
+  // Retired begin/commit of a transaction of context cid (BCFlag: 0 first
+  // attempt, 1 replay after an abort, 2 subsumed)
+  void transBegin(int tid, int bcFlag, int cid);
+  void transCommit(int bcFlag, int cid);
+
+  void report(const char *str);
+};
+
+#endif // CPISTACK_H
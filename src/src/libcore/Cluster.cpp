@@ -258,6 +258,10 @@ void ExecutedCluster::executed(DInst *dinst)
 {
   dinst->markExecuted();
 
+  ThreadUse *tuse = gproc->getThreadUse(dinst);
+  if (tuse)
+    tuse->executed(dinst->getInst());
+
   delEntry();
 
   window.executed(dinst);
@@ -282,6 +286,10 @@ void ExecutedCluster::retire(DInst *dinst)
 void RetiredCluster::executed(DInst *dinst)
 {
   dinst->markExecuted();
+
+  ThreadUse *tuse = gproc->getThreadUse(dinst);
+  if (tuse)
+    tuse->executed(dinst->getInst());
   window.executed(dinst);
 }
 
@@ -32,7 +32,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "Epoch.h"
 #endif
 
-pool<DInst> DInst::dInstPool(512, "DInst");
+spool<DInst> DInst::dInstPool(512, "DInst");
 
 #ifdef DEBUG
 int DInst::currentID=0;
@@ -228,7 +228,7 @@ DInst *DInst::createDInst(const Instruction *inst, VAddr va, int cId)
     return 0;
 #endif
 
-  DInst *i = dInstPool.out();
+  DInst *i = dInstPool.out(cId);
 
 #if (defined MIPS_EMUL)
   i->context=context;
@@ -255,6 +255,7 @@ DInst *DInst::createDInst(const Instruction *inst, VAddr va, int cId)
   i->resource  = 0;
   i->RATEntry  = 0;
   i->pendEvent = 0;
+  i->robState  = 0;
   i->fetch = 0;
   i->loadForwarded= false;
   i->issued       = false;
@@ -340,6 +341,16 @@ DInst *DInst::clone()
   newDInst->setLVID(lvid, lvidVersion);
 #endif
 
+#if (defined TM)
+  // the flow tagged the original, the replayed copy must retire the same
+  newDInst->transType   = transType;
+  newDInst->synchType   = synchType;
+  newDInst->utid        = utid;
+  newDInst->transTid    = transTid;
+  newDInst->transPid    = transPid;
+  newDInst->transBCFlag = transBCFlag;
+#endif
+
 #ifdef SESC_BAAD
   I(0);
 #endif
@@ -23,6 +23,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #define DINST_H
 
 #include "pool.h"
+#include "spool.h"
 #include "nanassert.h"
 
 #include "ThreadContext.h"
@@ -96,37 +97,12 @@ class DInst {
   // In a typical RISC processor MAX_PENDING_SOURCES should be 2
   static const int MAX_PENDING_SOURCES=2;
 
-private:
-
-  static pool<DInst> dInstPool;
-
-  DInstNext pend[MAX_PENDING_SOURCES];
-  DInstNext *last;
-  DInstNext *first;
-  
-  int cId;
-
-  // BEGIN Boolean flags
-  bool loadForwarded;
-  bool issued;
-  bool executed;
-  bool depsAtRetire;
-  bool deadStore;
-  bool deadInst;
-  bool waitOnMemory;
-
-  bool resolved; // For load/stores when the address is computer, for
-		 // the rest of instructions when it is executed
+  // Bits of the per ROB slot state (GProcessor::robState)
+  enum { ROBExecuted = 1, ROBDead = 2, ROBMemory = 4 };
 
+private:
 
-#ifdef SESC_MISPATH
-  bool fake;
-#endif
-  // END Boolean flags
-
-  // BEGIN Time counters
-  Time_t wakeUpTime;
-  // END Time counters
+  static spool<DInst> dInstPool;
 
 #ifdef SESC_BAAD
   static int fetch1QSize;
@@ -172,7 +148,75 @@ private:
   static GStatsHist **avgRetireQTime;
 
   static GStatsHist *brdistHist1;
+#endif
+
+  // The field order matters. The rename, wakeup, issue, execute and
+  // retire stages only touch the fields in the HOT section. Keep them
+  // together at the beginning of the object (the pool aligns each DInst
+  // to a cache line) and add new profiling/TM/debug state in the COLD
+  // section at the end.
+  //
+  // The executed/dead/memory state of the instructions in the ROB is
+  // also kept per ROB slot by the processor (GProcessor::robState), so
+  // that the retire and replay walks over the ROB do not have to load
+  // the DInst. robState points to this instruction's slot (0 when the
+  // instruction is not in the ROB).
+
+  // BEGIN HOT fields
+  DInstNext pend[MAX_PENDING_SOURCES];
+  DInstNext *last;
+  DInstNext *first;
+
+  const Instruction *inst;
+  VAddr vaddr;
+  Resource    *resource;
+  DInst      **RATEntry;
+  FetchEngine *fetch;
+
+  CallbackBase *pendEvent;
+
+  uchar *robState;
+
+  // BEGIN Time counters
+  Time_t wakeUpTime;
+  // END Time counters
+
+  int cId;
+
+  char nDeps;              // 0, 1 or 2 for RISC processors
+
+  // BEGIN Boolean flags
+  bool loadForwarded;
+  bool issued;
+  bool executed;
+  bool depsAtRetire;
+  bool deadStore;
+  bool deadInst;
+  bool waitOnMemory;
+
+  bool resolved; // For load/stores when the address is computer, for
+		 // the rest of instructions when it is executed
+
+
+#ifdef SESC_MISPATH
+  bool fake;
+#endif
+  // END Boolean flags
+
+ public:
+  void doAtSimTime();
+  StaticCallbackMember0<DInst,&DInst::doAtSimTime>  doAtSimTimeCB;
+
+  void doAtSelect();
+  StaticCallbackMember0<DInst,&DInst::doAtSelect>  doAtSelectCB;
+
+  void doAtExecuted();
+  StaticCallbackMember0<DInst,&DInst::doAtExecuted> doAtExecutedCB;
+  // END HOT fields
 
+ private:
+  // BEGIN COLD fields
+#ifdef SESC_BAAD
   Time_t fetch1Time;
   Time_t fetch2Time;
   Time_t renameTime;
@@ -186,12 +230,6 @@ private:
   InstID oracleID;
 #endif
 
-  const Instruction *inst;
-  VAddr vaddr;
-  Resource    *resource;
-  DInst      **RATEntry;
-  FetchEngine *fetch;
-
 #ifdef TASKSCALAR
   int         dataDepViolationID;
   HVersion   *restartVer;
@@ -202,15 +240,10 @@ private:
 
 #endif
 
-  CallbackBase *pendEvent;
-
 #if (defined TLS)
   tls::Epoch *myEpoch;
 #endif // (defined TLS)
 
-
-  char nDeps;              // 0, 1 or 2 for RISC processors
-
 #if (defined TM)
 public:
    transInstType  transType;     // Type of Transaction Instruction
@@ -245,17 +278,8 @@ public:
  public:
   DInst();
 
-  void doAtSimTime();
-  StaticCallbackMember0<DInst,&DInst::doAtSimTime>  doAtSimTimeCB;
-
-  void doAtSelect();
-  StaticCallbackMember0<DInst,&DInst::doAtSelect>  doAtSelectCB;
-
   DInst *clone();
 
-  void doAtExecuted();
-  StaticCallbackMember0<DInst,&DInst::doAtExecuted> doAtExecutedCB;
-
 #if (defined MIPS_EMUL)
   static DInst *createInst(InstID pc, VAddr va, int cId, ThreadContext *context);
   static DInst *createDInst(const Instruction *inst, VAddr va, int cId, ThreadContext *context);
@@ -553,6 +577,8 @@ public:
     I(issued);
     I(!executed);
     executed = true;
+    if (robState)
+      *robState |= ROBExecuted;
   }
 
   bool isDeadStore() const { return deadStore; }
@@ -562,8 +588,22 @@ public:
     deadStore = true; 
   }
 
-  void setDeadInst() { deadInst = true; }
+  void setDeadInst() {
+    deadInst = true;
+    if (robState)
+      *robState |= ROBDead;
+  }
   bool isDeadInst() { return deadInst; }
+
+  // Called when the instruction is pushed into the ROB slot st
+  void setROBState(uchar *st) {
+    robState = st;
+    *st = inst->isMemory() ? ROBMemory : 0;
+    if (executed)
+      *st |= ROBExecuted;
+    if (deadInst)
+      *st |= ROBDead;
+  }
   
   bool hasDepsAtRetire() const { return depsAtRetire; }
   void setDepsAtRetire() { 
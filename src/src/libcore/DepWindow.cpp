@@ -84,6 +84,13 @@ DepWindow::DepWindow(GProcessor *gp, const char *clusterName)
 
   SescConf->isInt("cpucore"    , "regFileDelay");
   SescConf->isBetween("cpucore" , "regFileDelay", 0, 1024);
+
+  useWheel = false;
+  if (SescConf->checkBool(clusterName, "wakeupWheel"))
+    useWheel = SescConf->getBool(clusterName, "wakeupWheel") && !InOrderCore;
+
+  if (useWheel)
+    wheel.resize(WheelSize);
 }
 
 DepWindow::~DepWindow()
@@ -148,6 +155,44 @@ void DepWindow::wakeUpDeps(DInst *dinst)
   }
 }
 
+bool DepWindow::deferTo(DInst *dinst, bool simTime, Time_t when)
+{
+  I(when > globalClock);
+
+  if (when - globalClock >= WheelSize)
+    return false;
+
+  WheelBucket &b = wheel[when % WheelSize];
+  if (b.empty())
+    tickCB::scheduleAbs(when, this, when % WheelSize);
+
+  WheelEntry e;
+  e.dinst   = dinst;
+  e.simTime = simTime;
+  b.push_back(e);
+
+  return true;
+}
+
+void DepWindow::tick(int bucket)
+{
+  I((int)(globalClock % WheelSize) == bucket);
+
+  // Everything scheduled from here is at least one cycle away, so the
+  // bucket does not change while it is walked
+  WheelBucket &b = wheel[bucket];
+  I(!b.empty());
+
+  for(size_t i = 0; i < b.size(); i++) {
+    if (b[i].simTime)
+      b[i].dinst->doAtSimTime();
+    else
+      select(b[i].dinst);
+  }
+
+  b.clear();
+}
+
 void DepWindow::preSelect(DInst *dinst)
 {
   // At the end of the wakeUp, we can start to read the register file
@@ -158,6 +203,8 @@ void DepWindow::preSelect(DInst *dinst)
   IS(dinst->setWakeUpTime(0));
 
   if (wakeTime > globalClock) {
+    if (useWheel && deferTo(dinst, false, wakeTime))
+      return;
     dinst->doAtSelectCB.scheduleAbs(wakeTime);
   }else{
     select(dinst);
@@ -174,6 +221,9 @@ void DepWindow::select(DInst *dinst)
 
   Time_t schedTime = schedPort->nextSlot() + SchedDelay;
 
+  if (useWheel && schedTime > globalClock && deferTo(dinst, true, schedTime))
+    return;
+
   dinst->doAtSimTimeCB.scheduleAbs(schedTime);
 }
 
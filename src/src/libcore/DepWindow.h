@@ -22,6 +22,8 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #ifndef DEPWINDOW_H
 #define DEPWINDOW_H
 
+#include <vector>
+
 #include "Instruction.h"
 #include "EnergyMgr.h"
 #include "nanassert.h"
@@ -33,8 +35,23 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 class DInst;
 class GProcessor;
 
+// Optional wakeup wheel (wakeupWheel = true in the cluster section).
+// Instead of one select and one simTime callback per instruction, each
+// future cycle of a small timing wheel keeps the list of instructions
+// that reach select or simTime that cycle, in the order the callbacks
+// would have been scheduled. A single callback per busy cycle walks the
+// list, so the select order (and the ports given when they are
+// oversubscribed) is the same as with the callbacks. The delays
+// (InterClusterLat, WakeUpDelay, RegFileDelay, SchedDelay) and the ports
+// are the same. The entries of a cycle run together, where the first
+// one would have run in the event queue, so other events of that cycle
+// can see a different order and the results are close to, not identical
+// to, the callbacks. Delays longer than the wheel fall back to the
+// callbacks. There is no wakeup bitmap or matrix.
 class DepWindow {
 private:
+  enum { WheelSize = 64 };
+
   GProcessor *gproc;
 
   const int Id;
@@ -60,6 +77,22 @@ private:
   PortGeneric *wakeUpPort;
   PortGeneric *schedPort;
 
+  bool useWheel;
+
+  class WheelEntry {
+  public:
+    DInst *dinst;
+    bool   simTime; // doAtSimTime, otherwise select
+  };
+  typedef std::vector<WheelEntry> WheelBucket;
+
+  std::vector<WheelBucket> wheel;
+
+  // true if dinst got an entry in the wheel for cycle when
+  bool deferTo(DInst *dinst, bool simTime, Time_t when);
+
+  void tick(int bucket);
+  typedef CallbackMember1<DepWindow, int, &DepWindow::tick> tickCB;
 
 protected:
   void preSelect(DInst *dinst);
@@ -89,11 +89,32 @@ FetchEngine::FetchEngine(int cId
   else
     bpred = new BPredictor(i, FetchWidth, bpredSection);
 
+  bpTrace = 0;
+  if (SescConf->checkCharPtr(bpredSection, "traceFile")) {
+    const char *tfile = SescConf->getCharPtr(bpredSection, "traceFile");
+    char *fname = (char *)malloc(strlen(tfile) + 16);
+    sprintf(fname, "%s.%d", tfile, Id);
+    bpTrace = new BPredTraceWriter(fname);
+    free(fname);
+  }
+
+  sTrace = 0;
+  if (SescConf->checkCharPtr("", "sescTraceFile")) {
+    const char *tfile = SescConf->getCharPtr("", "sescTraceFile");
+    char *fname = (char *)malloc(strlen(tfile) + 16);
+    sprintf(fname, "%s.%d", tfile, Id);
+    sTrace = new SescTraceWriter(fname);
+    free(fname);
+  }
+
   SescConf->isInt(bpredSection, "BTACDelay");
   SescConf->isBetween(bpredSection, "BTACDelay", 0, 1024);
   BTACDelay = SescConf->getInt(bpredSection, "BTACDelay");
 
   missInstID = 0;
+  refillTime = 0;
+  refillDelay = SescConf->getInt("cpucore", "decodeDelay", cId)
+    + SescConf->getInt("cpucore", "renameDelay", cId);
 #ifdef SESC_MISPATH
   issueWrongPath = SescConf->getBool("cpucore","issueWrongPath",cId);
 #endif
@@ -140,6 +161,11 @@ FetchEngine::~FetchEngine()
 #endif
 
   
+  if (bpTrace)
+    delete bpTrace;
+  if (sTrace)
+    delete sTrace;
+
   delete bpred;
 }
 
@@ -295,6 +321,16 @@ void FetchEngine::realFetch(IBucket *bucket, int fetchMax)
 
     const Instruction *inst = dinst->getInst();
 
+    if (sTrace && !dinst->isFake()) {
+#if (defined TM)
+      sTrace->record(inst, dinst->getVaddr(), flow.getNextID()
+                     ,dinst->transType != transNT
+                     ,dinst->transPid, dinst->transTid, dinst->transBCFlag);
+#else
+      sTrace->record(inst, dinst->getVaddr(), flow.getNextID());
+#endif
+    }
+
 #if !(defined MIPS_EMUL)
     if (inst->isStore()) {
 #if (defined TLS)
@@ -317,6 +353,8 @@ void FetchEngine::realFetch(IBucket *bucket, int fetchMax)
     fbSize++;
     if(inst->isBranch()) {
       szBB.sample(bbSize);
+      if (bpTrace && !dinst->isFake())
+        bpTrace->record(inst, flow.getNextID(), bbSize);
       bbSize=0;
       
       if (!processBranch(dinst, n2Fetched)) {
@@ -437,6 +475,23 @@ void FetchEngine::unBlockFetch()
   nDelayInst1.add(n);
 
   missFetchTime=0;
+  refillTime = globalClock + IL1HitDelay + refillDelay;
+}
+
+CPICause FetchEngine::getStallCause(const Pipeline &pipeLine) const
+{
+#if (defined TM)
+  if (pid >= 0 && transGCM->checkStall(pid))
+    return CPITMStall;
+#endif
+
+  if (missInstID || globalClock < refillTime)
+    return CPIBPred;
+
+  if (pipeLine.isWaitingFetch())
+    return CPIICache;
+
+  return CPIFrontEnd;
 }
 
 void FetchEngine::switchIn(Pid_t i) 
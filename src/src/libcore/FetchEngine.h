@@ -30,6 +30,9 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "ExecutionFlow.h"
 #include "TraceFlow.h"
 #include "BPred.h"
+#include "BPredTrace.h"
+#include "CPIStack.h"
+#include "SescTrace.h"
 #include "GStats.h"
 #include "Events.h"
 
@@ -46,6 +49,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 class GMemorySystem;
 class IBucket;
+class Pipeline;
 class GProcessor;
 
 class FetchEngine {
@@ -63,6 +67,8 @@ private:
   Pid_t pid;
 
   BPredictor *bpred;
+  BPredTraceWriter *bpTrace; // 0 if the branches are not recorded
+  SescTraceWriter  *sTrace;  // 0 if the instructions are not recorded
   
 #ifdef QEMU_DRIVEN
   QEMUFlow flow;
@@ -96,6 +102,8 @@ private:
   // InstID of the address that generated a misprediction
   InstID missInstID;
   Time_t missFetchTime;
+  Time_t refillTime;   // end of the refill after a misprediction
+  TimeDelta_t refillDelay;
 
 #ifdef SESC_MISPATH
   bool issueWrongPath;
@@ -183,6 +191,9 @@ public:
   void unBlockFetch();
   StaticCallbackMember0<FetchEngine,&FetchEngine::unBlockFetch> unBlockFetchCB;
 
+  // Why no instructions reach the ROB (CPI stack)
+  CPICause getStallCause(const Pipeline &pipeLine) const;
+
   void dump(const char *str) const;
 
   void switchIn(Pid_t i);
@@ -24,6 +24,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include <math.h>
 #include "GMemorySystem.h"
+#include "MemSampler.h"
 
 ushort GMemorySystem::Log2PageSize=0;
 unsigned int GMemorySystem::PageMask;
@@ -101,6 +102,7 @@ GMemorySystem::GMemorySystem(int processorId)
 
   dataSource = 0;
   instrSource= 0;
+  memSampler = 0;
 }
 
 GMemorySystem::~GMemorySystem() 
@@ -158,6 +160,11 @@ void GMemorySystem::buildMemorySystem()
   }
 
   memoryOS = buildMemoryOS(def_block);
+
+  if (dataSource && SescConf->checkCharPtr(def_block, "memSampler")) {
+    const char *section = SescConf->getCharPtr(def_block, "memSampler");
+    memSampler = new MemSampler(section, "P(%d)_MemSampler", Id);
+  }
 }
 
 char *GMemorySystem::buildUniqueName(const char *device_type)
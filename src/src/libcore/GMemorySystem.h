@@ -35,6 +35,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #endif
 
 class HVersion;
+class MemSampler;
 
 //Class for comparison to be used in hashes of char * where the
 //content is to be compared
@@ -85,6 +86,7 @@ private:
   MemObj *instrSource;
   MemObj *dataSource;
   GMemoryOS *memoryOS;
+  MemSampler *memSampler; // 0 unless the data references are sampled
 
 protected:
   const int Id;
@@ -125,6 +127,7 @@ public:
   MemObj *getDataSource()  const;
   MemObj *getInstrSource() const;
   GMemoryOS *getMemoryOS() const;
+  MemSampler *getMemSampler() const { return memSampler; }
 #ifdef TASKSCALAR
   virtual GLVID *findCreateLVID(HVersion *ver) = 0;
 #endif
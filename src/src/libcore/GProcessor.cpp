@@ -95,8 +95,11 @@ GProcessor::GProcessor(GMemorySystem *gm, CPU_t i, size_t numFlows)
   ,ROB(MaxROBSize)
   ,replayQ(2*MaxROBSize)
   ,lsq(this, i)
+  ,threadUse(0)
+  ,threadUseBase(0)
   ,clusterManager(gm, this)
   ,robUsed("Proc(%d)_robUsed", i)
+  ,cpiStack(i)
   ,noFetch("Processor(%d)_noFetch", i)
   ,noFetch2("Processor(%d)_noFetch2", i)
   ,retired("ExeEngine(%d)_retired", i)
@@ -127,6 +130,9 @@ GProcessor::GProcessor(GMemorySystem *gm, CPU_t i, size_t numFlows)
   regPool[1] = SescConf->getInt("cpucore", "fpRegs",i);
   regPool[2] = 262144; // Unlimited registers for invalid output
 
+  robState  = new uchar[ROB.capacity()];
+  robOpcode = new InstType[ROB.capacity()];
+
 #ifdef SESC_MISPATH
   for (int j = 0 ; j < INSTRUCTION_MAX_DESTPOOL; j++)
     misRegPool[j] = 0;
@@ -143,6 +149,9 @@ GProcessor::GProcessor(GMemorySystem *gm, CPU_t i, size_t numFlows)
   nStall[PortConflictStall] = new GStatsCntr("ExeEngine(%d):PortConflict",i);
   nStall[SwitchStall]       = new GStatsCntr("ExeEngine(%d):switch",i);
 
+  renameStall     = NoStall;
+  renameStallTime = 0;
+
   for(unsigned r = 0; r < MaxNoRetResp; r++) {
     for(unsigned s = 0; s < MaxInstType; s++) {
       for(unsigned t = 0; t < MaxRetOutcome; t++) {
@@ -269,6 +278,9 @@ GProcessor::GProcessor(GMemorySystem *gm, CPU_t i, size_t numFlows)
 
 GProcessor::~GProcessor()
 {
+  delete [] robState;
+  delete [] robOpcode;
+
 #if defined(STAT_COMMON)
    for(UINT_32 counter = 0; counter < instructionQueueVector.size(); counter++)
    {
@@ -343,6 +355,77 @@ StallCause GProcessor::sharedAddInst(DInst *dinst)
     return SmallREGStall;
 #endif
 
+  StallCause sc = scheduleInst(dinst);
+  if (sc != NoStall)
+    return sc;
+
+  renameEnergy->inc(); // Rename RAT
+  robEnergy->inc(); // one for insert
+
+  rdRegEnergy[inst->getSrc1Pool()]->inc();
+  rdRegEnergy[inst->getSrc2Pool()]->inc();
+  wrRegEnergy[inst->getDstPool()]->inc();
+
+  return NoStall;
+}
+
+int GProcessor::renameRoom(IBucket *bucket, int n, StallCause &sc)
+{
+  // Steps 1 and 2 of sharedAddInst for the first n instructions of the
+  // bucket at once. Returns how many get a ROB entry and a register
+  I(n <= (int)bucket->size());
+
+  sc = NoStall;
+
+  int room = (int)(MaxROBSize - ROB.size());
+  if (room <= 0) {
+    sc = SmallROBStall;
+    return 0;
+  }
+  if (n > room) {
+    sc = SmallROBStall;
+    n  = room;
+  }
+
+#if SESC_INORDER
+  if (switching) {
+    if(!ROB.empty()) {
+      sc = SwitchStall;
+      return 0;
+    }
+    switching = false;
+  } 
+#endif
+
+  signed int regs[INSTRUCTION_MAX_DESTPOOL];
+  for(int p = 0; p < INSTRUCTION_MAX_DESTPOOL; p++) {
+#ifdef SESC_MISPATH
+    regs[p] = regPool[p] - misRegPool[p];
+#else
+    regs[p] = regPool[p];
+#endif
+  }
+
+  unsigned int id = bucket->getIdFromTop(0);
+  for(int i = 0; i < n; i++) {
+    int pool = bucket->getData(id)->getInst()->getDstPool();
+    I(pool<3);
+    if (regs[pool] == 0) {
+      sc = SmallREGStall;
+      return i;
+    }
+    regs[pool]--;
+    id = bucket->getNextId(id);
+  }
+
+  return n;
+}
+
+StallCause GProcessor::scheduleInst(DInst *dinst)
+{
+  // Step 3 of sharedAddInst. The ROB entry and the register were checked
+  const Instruction *inst = dinst->getInst();
+
   Resource *res = clusterManager.getResource(inst->getOpcode());
   I(res);
 
@@ -375,21 +458,59 @@ StallCause GProcessor::sharedAddInst(DInst *dinst)
   regPool[inst->getDstPool()]--;
 #endif
 
-  renameEnergy->inc(); // Rename RAT
-  robEnergy->inc(); // one for insert
-
-  rdRegEnergy[inst->getSrc1Pool()]->inc();
-  rdRegEnergy[inst->getSrc2Pool()]->inc();
-  wrRegEnergy[inst->getDstPool()]->inc();
-
   ROB.push(dinst);
-
+  {
+    unsigned int slot = ROB.getIdFromTop(ROB.size()-1);
+    robOpcode[slot] = inst->getOpcode();
+    dinst->setROBState(&robState[slot]);
+  }
 
   dinst->setResource(res);
 
   return NoStall;
 }
 
+void GProcessor::renameRegs(DInst **RAT, DInst *dinst)
+{
+  const Instruction *inst = dinst->getInst();
+
+  I(dinst->getResource() != 0); // Resource::schedule must set the resource field
+
+  if(!dinst->isSrc2Ready()) {
+    // It already has a src2 dep. It means that it is solved at
+    // retirement (Memory consistency. coherence issues)
+    if( RAT[inst->getSrc1()] )
+      RAT[inst->getSrc1()]->addSrc1(dinst);
+  }else{
+    if( RAT[inst->getSrc1()] )
+      RAT[inst->getSrc1()]->addSrc1(dinst);
+
+    if( RAT[inst->getSrc2()] )
+      RAT[inst->getSrc2()]->addSrc2(dinst);
+  }
+
+  dinst->setRATEntry(&RAT[inst->getDest()]);
+  RAT[inst->getDest()] = dinst;
+
+  dinst->getResource()->getCluster()->addInst(dinst);
+}
+
+void GProcessor::addRenameEnergy(const RenameCount &rc)
+{
+  if (rc.n == 0)
+    return;
+
+  renameEnergy->add(rc.n); // Rename RAT
+  robEnergy->add(rc.n); // one per insert
+
+  for(int p = 0; p < 3; p++) {
+    if (rc.rdReg[p])
+      rdRegEnergy[p]->add(rc.rdReg[p]);
+    if (rc.wrReg[p])
+      wrRegEnergy[p]->add(rc.wrReg[p]);
+  }
+}
+
 int GProcessor::issue(PipeQueue &pipeQ)
 {
   int i=0; // Instructions executed counter
@@ -400,6 +521,7 @@ int GProcessor::issue(PipeQueue &pipeQ)
   if(!replayQ.empty()) {
     issueFromReplayQ();
     nStall[ReplayStall]->add(RealisticWidth);
+    markRenameStall(ReplayStall);
     return 0;  // we issued 0 from the instQ;
     // FIXME:check if we can issue from replayQ and 
     // fetchQ during the same cycle
@@ -413,10 +535,8 @@ int GProcessor::issue(PipeQueue &pipeQ)
         return i+j;
       }
 
-      I(!bucket->empty());
-
-      DInst *dinst = bucket->top();
 #ifdef TASKSCALAR
+      DInst *dinst = bucket->top();
       if (!dinst->isFake()) {
         if (dinst->getLVID()==0 || dinst->getLVID()->isKilled()) {
           // Task got killed. Just swallow the instruction
@@ -426,17 +546,25 @@ int GProcessor::issue(PipeQueue &pipeQ)
           continue;
         }
       }
+      // Killed tasks are swallowed between instructions
+      int n = 1;
+#else
+      // The whole fetch bundle (up to the issue width) in one pass
+      int n = bucket->size();
+      if (n > IssueWidth - i)
+        n = IssueWidth - i;
 #endif
 
-      StallCause c = addInst(dinst);
-      if (c != NoStall) {
+      StallCause c;
+      int nRenamed = addBundle(bucket, n, c);
+      i += nRenamed;
+      if (nRenamed < n) {
+        I(c != NoStall);
         if (i < RealisticWidth)
           nStall[c]->add(RealisticWidth - i);
+        markRenameStall(c);
         return i+j;
       }
-      i++;
-        
-      bucket->pop();
 
     }while(!bucket->empty());
     
@@ -457,6 +585,7 @@ int GProcessor::issueFromReplayQ()
     if (c != NoStall) {
       if (nIssued < RealisticWidth)
         nStall[c]->add(RealisticWidth - nIssued);
+      markRenameStall(c);
       break;
     }
     nIssued++;
@@ -467,13 +596,14 @@ int GProcessor::issueFromReplayQ()
   return nIssued;
 }
 
-void GProcessor::replay(DInst *dinst)
+void GProcessor::replay(DInst *dinst, bool force)
 {
   //traverse the ROB for instructions younger than dinst
   //and add them to the replayQ.
 
 #ifndef DOREPLAY
-  return;
+  if (!force)
+    return;
 #endif
 
   if(dinst->isDeadInst())
@@ -482,11 +612,11 @@ void GProcessor::replay(DInst *dinst)
   bool pushInst = false;
   unsigned int robPos = ROB.getIdFromTop(0); // head or top
   while(1) {
-    DInst *robDInst = ROB.getData(robPos);
-    if(robDInst == dinst)
+    if (!pushInst && ROB.getData(robPos) == dinst)
       pushInst = true;
 
-    if(pushInst && !robDInst->isDeadInst()) {
+    if(pushInst && !(robState[robPos] & DInst::ROBDead)) {
+      DInst *robDInst = ROB.getData(robPos);
       replayQ.push(robDInst->clone());
       robDInst->setDeadInst();
     }
@@ -500,6 +630,7 @@ void GProcessor::replay(DInst *dinst)
 void GProcessor::report(const char *str)
 {
   Report::field("Proc(%d):clockTicks=%lld", Id, clockTicks);
+  cpiStack.report(str);
   memorySystem->getMemoryOS()->report(str);
 }
 
@@ -537,22 +668,34 @@ void GProcessor::retire()
   robUsed.sample(ROB.size());
 
   ushort i;
+  ushort flushed = 0;  // slots already given to cpiStack this cycle
+  int    retCid  = -1; // context of the slots retired since then
   
   for(i=0;i<RetireWidth && !ROB.empty();i++) {
-    DInst *dinst = ROB.top();
-
-    if( !dinst->isExecuted() ) {
-      addStatsNoRetire(i, dinst, NotExecuted);
+    unsigned int slot = ROB.getIdFromTop(0);
+
+    // Waiting for the head is the common case, decided from the ROB slot
+    // state without loading the DInst
+    if( !(robState[slot] & DInst::ROBExecuted) ) {
+      addStatsNoRetire(i, robOpcode[slot], NotExecuted);
+      cpiStack.retired(i - flushed, retCid);
+      if (robState[slot] & DInst::ROBMemory)
+        cpiStack.stalledMem(RetireWidth - i, ROB.top());
+      else
+        cpiStack.stalled(RetireWidth - i, headStall(), ROB.top());
       return;
     }
 
+    DInst *dinst = ROB.top();
+    I(dinst->isExecuted());
+
     // save it now because retire can destroy DInst
     int rp = dinst->getInst()->getDstPool();
 
 //BEGIN STAT --------------------------------------------------------------------------------------------------------
 #if defined(STAT)
 
-   ConfObject* statConf = new ConfObject;
+   ConfObject* statConf = ConfObject::getConf();
    THREAD_ID threadID = dinst->get_threadID();
 
    //Check to see if we're profling or not
@@ -580,14 +723,12 @@ void GProcessor::retire()
 //          }
 //       }
    }
-
-   delete statConf;
 #endif
 //END STAT ----------------------------------------------------------------------------------------------------------
 
 //BEGIN PROFILING --------------------------------------------------------------------------------------------------------
 #if defined(PROFILE)
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    THREAD_ID threadID = dinst->get_threadID();
    if(statConf->return_enableProfiling() == 1)
    {
@@ -686,7 +827,6 @@ void GProcessor::retire()
          Profiling::analysis(instruction_cycle);
       }
    }
-   delete statConf;
 #endif
 //END PROFILING --------------------------------------------------------------------------------------------------------
 
@@ -697,29 +837,64 @@ void GProcessor::retire()
     int transPid = dinst->transPid;
     int transTid = dinst->transTid;
     int transBCFlag = dinst->transBCFlag;
+    int transCid = dinst->getContextId();
 #endif
 
     bool fake = dinst->isFake();
+    const Instruction *inst = dinst->getInst();
+    ThreadUse *tuse = getThreadUse(dinst);
 
     I(dinst->getResource());
     RetOutcome retOutcome = dinst->getResource()->retire(dinst);
     if( retOutcome != Retired) {
-      addStatsNoRetire(i, dinst, retOutcome);
+      addStatsNoRetire(i, robOpcode[slot], retOutcome);
+      cpiStack.retired(i - flushed, retCid);
+      switch(retOutcome) {
+      case NotFinished:
+        cpiStack.stalledMem(RetireWidth - i, dinst);
+        break;
+      case NoCacheSpace:
+      case NoCachePorts:
+        cpiStack.stalled(RetireWidth - i, CPIStore, dinst);
+        break;
+      case WaitForFence:
+        cpiStack.stalled(RetireWidth - i, CPIFence, dinst);
+        break;
+      default:
+        cpiStack.stalled(RetireWidth - i, headStall(), dinst);
+      }
       return;
     }
     // dinst CAN NOT be used beyond this point
 
+    if (tuse)
+      tuse->retired(inst);
+
 #if (defined TM)
       instCountTM++;
+      if (transCid != retCid) {
+        // SMT: each context has its own open transaction
+        cpiStack.retired(i - flushed, retCid);
+        flushed = i;
+        retCid  = transCid;
+      }
+      if (tempTransType == transCommit || tempTransType == transBegin) {
+        // The slots retired so far (this one too) and the head memory
+        // stall go to the stack before the transaction opens or closes
+        cpiStack.retired(i + 1 - flushed, retCid);
+        flushed = i + 1;
+      }
       // Call the proper reporting function based on the type of instruction
       switch(tempTransType){
       case transCommit:
         if(transBCFlag != 2)
           tmReport->reportCommit(transPid);
+        cpiStack.transCommit(transBCFlag, transCid);
         break;
       case transBegin:
         if(transBCFlag != 2)
           tmReport->reportBegin(transPid, this->Id);
+        cpiStack.transBegin(transTid, transBCFlag, transCid);
         break;
       case transLoad:
         tmReport->reportLoad(transPid);
@@ -759,6 +934,28 @@ void GProcessor::retire()
 
   if(!ROB.empty() || i != 0) 
     addStatsRetire(i);
-  
+
+  cpiStack.retired(i - flushed, retCid);
+  if (i < RetireWidth)
+    cpiStack.stalled(RetireWidth - i, frontEndStall(), 0);
+}
+
+CPICause GProcessor::headStall() const
+{
+  if (renameStallTime != globalClock)
+    return CPIExec;
+
+  switch(renameStall) {
+  case SmallWinStall:
+  case SmallROBStall:
+  case SmallREGStall:
+  case OutsBranchesStall:
+    return CPIWindow;
+  case OutsLoadsStall:
+  case OutsStoresStall:
+    return CPILSQ;
+  default:
+    return CPIExec;
+  }
 }
 
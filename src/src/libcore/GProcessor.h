@@ -34,6 +34,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "callback.h"
 #include "Cluster.h"
+#include "CPIStack.h"
 #include "Events.h"
 #include "Instruction.h"
 #include "FastQueue.h"
@@ -59,6 +60,39 @@ class BPredictor;
 class XactionManager;
 #endif
 
+// In flight instructions of a hardware thread
+class ThreadUse {
+ public:
+  int frontEnd;  // fetched, not renamed
+  int window;    // renamed, not executed
+  int rob;
+  int lsq;       // loads and stores in the LDSTQ
+  int branches;  // renamed, not executed
+  int memLoads;  // loads in the memory hierarchy
+
+  ThreadUse() 
+    : frontEnd(0), window(0), rob(0), lsq(0), branches(0), memLoads(0) { }
+
+  void renamed(const Instruction *inst) {
+    window++;
+    rob++;
+    if (inst->isLoad() || inst->isStore())
+      lsq++;
+    if (inst->isBranch())
+      branches++;
+  }
+  void executed(const Instruction *inst) {
+    window--;
+    if (inst->isBranch())
+      branches--;
+  }
+  void retired(const Instruction *inst) {
+    rob--;
+    if (inst->isLoad() || inst->isStore())
+      lsq--;
+  }
+};
+
 class GProcessor {
 private:
 protected:
@@ -76,10 +110,19 @@ protected:
   GMemorySystem *memorySystem;
 
   FastQueue<DInst *> ROB;
+  // Hot state of the ROB entries, indexed by ROB id (same ids as
+  // ROB). One DInst::ROBxxx byte and the opcode per slot
+  uchar    *robState;
+  InstType *robOpcode;
 
   FastQueue<DInst *> replayQ;
   LDSTQ lsq;
 
+  // Per hardware thread occupancy, only kept by the SMTProcessor (fetch
+  // policies and resource partitioning). 0 in the other processors
+  ThreadUse *threadUse;
+  int threadUseBase; // context id of threadUse[0]
+
 
 
 #ifdef XACTION
@@ -116,6 +159,12 @@ protected:
   ID(int prevDInstID);
 
   GStatsCntr *nStall[MaxStall];
+
+  // Last rename stall (retire slot attribution)
+  StallCause renameStall;
+  Time_t     renameStallTime;
+
+  CPIStack cpiStack;
   GStatsCntr *nInst[MaxInstType];
 #ifdef SESC_MISPATH
   GStatsCntr *nInstFake[MaxInstType];
@@ -139,8 +188,38 @@ protected:
 
   GProcessor(GMemorySystem *gm, CPU_t i, size_t numFlows);
 
+  // Register file accesses of a renamed bundle, added to the energy
+  // counters once per bundle
+  class RenameCount {
+  public:
+    int n;
+    int rdReg[3];
+    int wrReg[3];
+    RenameCount() : n(0) {
+      for(int i = 0; i < 3; i++) {
+        rdReg[i] = 0;
+        wrReg[i] = 0;
+      }
+    }
+    void add(const Instruction *inst) {
+      n++;
+      rdReg[inst->getSrc1Pool()]++;
+      rdReg[inst->getSrc2Pool()]++;
+      wrReg[inst->getDstPool()]++;
+    }
+  };
+
   virtual StallCause addInst(DInst *dinst) = 0;
+  // Rename up to n instructions from the top of the bucket in program
+  // order and pop them. Returns how many, sc is the stall cause when
+  // less than n
+  virtual int addBundle(IBucket *bucket, int n, StallCause &sc) = 0;
+
   StallCause sharedAddInst(DInst *dinst);
+  int renameRoom(IBucket *bucket, int n, StallCause &sc);
+  StallCause scheduleInst(DInst *dinst);
+  void renameRegs(DInst **RAT, DInst *dinst);
+  void addRenameEnergy(const RenameCount &rc);
   int issue(PipeQueue &pipeQ);
   int issueFromReplayQ();
   void retire();
@@ -149,17 +228,24 @@ protected:
 
   virtual FetchEngine *currentFlow() = 0;
 
+  // Why the front end is not delivering instructions (ROB empty)
+  virtual CPICause frontEndStall() = 0;
+
+  void markRenameStall(StallCause c) {
+    renameStall     = c;
+    renameStallTime = globalClock;
+  }
+  CPICause headStall() const;
+
   void addStatsRetire(ushort index) {
     retired.sample(index);
   }
 
-  void addStatsNoRetire(ushort index, DInst *dinst, RetOutcome cause) {
-    I(dinst);
-
+  void addStatsNoRetire(ushort index, InstType op, RetOutcome cause) {
     addStatsRetire(index);
 
-    notRetired[Self][dinst->getInst()->getOpcode()][cause]->inc();
-    notRetired[Other][dinst->getInst()->getOpcode()][cause]->add(RetireWidth - index - 1);
+    notRetired[Self][op][cause]->inc();
+    notRetired[Other][op][cause]->add(RetireWidth - index - 1);
   }
 
 public:
@@ -178,7 +264,15 @@ public:
   GMemorySystem *getMemorySystem() const { return memorySystem; }
   LDSTQ *getLSQ() { return &lsq; }
 
-  virtual void replay(DInst *dinst);
+  ThreadUse *getThreadUse(const DInst *dinst) const {
+    if (threadUse == 0)
+      return 0;
+    return &threadUse[dinst->getContextId() - threadUseBase];
+  }
+
+  // Squash dinst and the younger instructions and issue them again. Only
+  // with DOREPLAY, or when force is set (store set violations)
+  virtual void replay(DInst *dinst, bool force = false);
 
   // Returns the maximum number of flows this processor can support 
   size_t getMaxFlows(void) const { return MaxFlows; }
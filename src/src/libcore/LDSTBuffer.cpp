@@ -117,7 +117,7 @@ void LDSTBuffer::getStoreEntry(DInst *dinst)
   stores[calcWord(dinst)] = dinst;
 }
 
-void LDSTBuffer::getLoadEntry(DInst *dinst) 
+void LDSTBuffer::getLoadEntry(DInst *dinst, bool enforce) 
 {
   I(dinst->getInst()->isLoad());
 
@@ -162,6 +162,9 @@ void LDSTBuffer::getLoadEntry(DInst *dinst)
   }
 #endif
 
+  if (!enforce)
+    return; // LDSTQ predicts the dependence and decides the forwarding
+
 #ifndef LDSTQ_FWD
   dinst->setLoadForwarded();
 #endif
@@ -78,8 +78,10 @@ public:
    *
    * The request is in the same order than the instructions are feched.
    *
+   * enforce=false leaves the dependences inside the same context to the
+   * memory dependence predictor of the LDSTQ (store sets)
    */
-  static void getLoadEntry(DInst *dinst);
+  static void getLoadEntry(DInst *dinst, bool enforce = true);
 
   static void storeLocallyPerformed(DInst *dinst);
 
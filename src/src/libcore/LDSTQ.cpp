@@ -21,6 +21,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "LDSTQ.h"
 #include "GProcessor.h"
+#include "SescConf.h"
 
 LDSTQ::LDSTQ(GProcessor *gp, const int id) 
   :ldldViolations("LDSTQ(%d)_ldldViolations", id)
@@ -28,15 +29,124 @@ LDSTQ::LDSTQ(GProcessor *gp, const int id)
   ,ststViolations("LDSTQ(%d)_ststViolations", id)
   ,stldForwarding("LDSTQ(%d)_stldForwarding", id)
   ,gproc(gp)
+  ,ssDeps("LDSTQ(%d)_ssDeps", id)
+  ,ssTrain("LDSTQ(%d)_ssTrain", id)
+  ,ssReplays("LDSTQ(%d)_ssReplays", id)
 {
+  ring.resize(256);
+  head = 0;
+  tail = 0;
+
+  storeSets = false;
+  if (SescConf->checkBool("cpucore", "storeSets", id))
+    storeSets = SescConf->getBool("cpucore", "storeSets", id);
+
+  int ssitSize = 4096;
+  if (SescConf->checkInt("cpucore", "ssitSize", id)) {
+    SescConf->isPower2("cpucore", "ssitSize", id);
+    ssitSize = SescConf->getInt("cpucore", "ssitSize", id);
+  }
+  ssitMask = ssitSize - 1;
+
+  lfstSize = 256;
+  if (SescConf->checkInt("cpucore", "lfstSize", id)) {
+    SescConf->isGT("cpucore", "lfstSize", 0, id);
+    lfstSize = SescConf->getInt("cpucore", "lfstSize", id);
+  }
+
+  ssitClear = 1000000;
+  if (SescConf->checkInt("cpucore", "ssitClear", id))
+    ssitClear = SescConf->getInt("cpucore", "ssitClear", id);
+
+  nextClear = ssitClear;
+  nextSSID  = 0;
+
+  if (storeSets) {
+    ssit.resize(ssitSize, -1);
+    lfst.resize(lfstSize, 0);
+  }
+}
+
+void LDSTQ::grow()
+{
+  unsigned n = tail - head;
+  std::vector<Entry> nring(2*ring.size());
+  for(unsigned i = 0; i < n; i++)
+    nring[i] = at(head + i);
+
+  ring.swap(nring);
+  head = 0;
+  tail = n;
+}
+
+int LDSTQ::getSSID(const DInst *dinst)
+{
+  if (ssitClear && globalClock >= nextClear) {
+    // Periodic clear, so that the sets do not keep growing
+    for(size_t i = 0; i < ssit.size(); i++)
+      ssit[i] = -1;
+    for(size_t i = 0; i < lfst.size(); i++)
+      lfst[i] = 0;
+    nextClear = globalClock + ssitClear;
+  }
+
+  return ssit[calcSSIT(dinst)];
+}
+
+void LDSTQ::train(DInst *ld, DInst *st)
+{
+  int li = calcSSIT(ld);
+  int si = calcSSIT(st);
+
+  int lid = ssit[li];
+  int sid = ssit[si];
+
+  ssTrain.inc();
+
+  if (lid < 0 && sid < 0) {
+    ssit[li] = ssit[si] = nextSSID;
+    nextSSID = (nextSSID + 1) % lfstSize;
+  }else if (lid < 0) {
+    ssit[li] = sid;
+  }else if (sid < 0) {
+    ssit[si] = lid;
+  }else{
+    // Merge: both go to the smaller set
+    ssit[li] = ssit[si] = lid < sid ? lid : sid;
+  }
 }
 
 void LDSTQ::insert(DInst *dinst)
 {
-  I(inflightInsts.find(dinst) == inflightInsts.end());
-  instMap[calcWord(dinst)].push_back(dinst);
-  
-  inflightInsts.insert(dinst);
+  if (tail - head == ring.size())
+    grow();
+
+  Entry &e = at(tail++);
+  e.dinst = dinst;
+  e.word  = calcWord(dinst);
+  e.ssid  = -1;
+
+  if (!storeSets)
+    return;
+
+  e.ssid = getSSID(dinst);
+  if (e.ssid < 0)
+    return;
+
+  if (dinst->getInst()->isStore()) {
+    lfst[e.ssid] = dinst;
+    return;
+  }
+
+  // Load: wait for the last store of its set. pend[1] is shared with the
+  // second source and with the cross context dependences of LDSTBuffer
+  DInst *st = lfst[e.ssid];
+  if (st && !st->isExecuted() 
+      && st->getContextId() == dinst->getContextId()
+      && dinst->isSrc2Ready()) {
+    st->addFakeSrc(dinst);
+    ssDeps.inc();
+  }
 }
 
 bool LDSTQ::executed(DInst *dinst)
@@ -45,21 +155,113 @@ bool LDSTQ::executed(DInst *dinst)
     return false;
 
   bool doReplay = false;
-  I(inflightInsts.find(dinst) != inflightInsts.end());
 
   const Instruction *inst = dinst->getInst();
-  AddrDInstQMap::iterator addrIt = instMap.find(calcWord(dinst));
-  
-  I(addrIt != instMap.end());
+  VAddr word = calcWord(dinst);
 
   dinst->markResolved();
 
+  if (!storeSets)
+    return executedOracle(dinst, word);
+
+  // From the youngest entry to the oldest. oldest is the oldest younger
+  // load that executed before dinst; a younger store to the same word
+  // hides the loads after it from the stores before it
+  DInst *oldest = 0;
+  int   nViol   = 0;
+  unsigned pos  = tail;
+  bool  found   = false;
+  while(pos != head) {
+    pos--;
+    Entry &e = at(pos);
+    DInst *qdinst = e.dinst;
+    if (qdinst == 0)
+      continue;
+
+    // A replay leaves the dead originals ahead of their clones. Only the
+    // clones can be replayed again
+    if (qdinst->isDeadInst())
+      continue;
+
+    if (qdinst == dinst) {
+      found = true;
+      if (inst->isStore() && e.ssid >= 0 && lfst[e.ssid] == dinst)
+        lfst[e.ssid] = 0;
+      if (inst->isStore())
+        break;
+      continue;
+    }
+
+    if (e.word != word)
+      continue;
+
+    const Instruction *qinst = qdinst->getInst();
+
+    if (!found) {
+      if (qinst->isStore()) {
+        if (inst->isStore()) {
+          if (qdinst->isResolved())
+            ststViolations.inc();
+          oldest = 0; // those loads are checked by qdinst
+          nViol  = 0;
+        }
+      }else if (qdinst->isResolved()) {
+        oldest = qdinst;
+        nViol++;
+      }
+      continue;
+    }
+
+    // Older than a load: the closest older store to the word
+    if (qinst->isStore()) {
+      if (qdinst->isResolved()) {
+        dinst->setLoadForwarded();
+        stldForwarding.inc();
+      }
+      break;
+    }
+  }
+  I(found);
+
+  if (oldest == 0)
+    return false;
+
+  doReplay = true;
+  if (inst->isLoad()) {
+    ldldViolations.add(nViol);
+    gproc->replay(oldest);
+  }else{
+    stldViolations.add(nViol);
+    train(oldest, dinst);
+    ssReplays.inc();
+    gproc->replay(oldest, true);
+  }
+
+  return doReplay;
+}
+
+bool LDSTQ::executedOracle(DInst *dinst, VAddr word)
+{
+  // Same checks (and stats) as the per word queues used before the ring:
+  // every younger resolved entry is a violation and is replayed, and the
+  // oldest entry to the word is never looked at
+  unsigned first = head;
+  while(first != tail && (at(first).dinst == 0 || at(first).word != word))
+    first++;
+  I(first != tail);
+
+  const Instruction *inst = dinst->getInst();
+  bool doReplay   = false;
   bool beforeInst = true;
 
-  DInstQueue::iterator instIt = addrIt->second.end();
-  instIt--;
-  while(instIt != addrIt->second.begin()) {
-    DInst *qdinst = *instIt;
+  unsigned pos = tail;
+  while(pos != first) {
+    pos--;
+    Entry &e = at(pos);
+    DInst *qdinst = e.dinst;
+    if (qdinst == 0 || e.word != word)
+      continue;
+
     if(qdinst == dinst) 
       beforeInst = false;
 
@@ -69,29 +271,24 @@ bool LDSTQ::executed(DInst *dinst)
       if(inst->isLoad() && qinst->isLoad()) {
 	ldldViolations.inc();
 	doReplay = true;
-	if(!dinst->isDeadInst())
-	  gproc->replay(qdinst);
+	gproc->replay(qdinst);
       } else if(inst->isStore() && qinst->isStore()) {
 	ststViolations.inc();
       } else if(inst->isStore() && qinst->isLoad()) {
 	stldViolations.inc();
 	doReplay = true;
-	if(!dinst->isDeadInst())
-	  gproc->replay(qdinst);
+	gproc->replay(qdinst);
       }
     }
 
-
     if(!beforeInst && inst->isLoad() 
        && qinst->isStore() && qdinst->isResolved()) {
 #ifdef LDSTQ_FWD
       dinst->setLoadForwarded();
 #endif
-	stldForwarding.inc();
-	break; // found if forwarded no need to check the rest of the entries
+      stldForwarding.inc();
+      break; // found if forwarded no need to check the rest of the entries
     }
-    
-    instIt--;
   }
 
   return doReplay;
@@ -99,23 +296,20 @@ bool LDSTQ::executed(DInst *dinst)
 
 void LDSTQ::remove(DInst *dinst)
 {
-  I(inflightInsts.find(dinst) != inflightInsts.end());
-  AddrDInstQMap::iterator addrIt = instMap.find(calcWord(dinst));
-  
-  I(addrIt != instMap.end());
-
-  DInstQueue::iterator instIt = addrIt->second.begin();
-  while(instIt != addrIt->second.end()) {
-    if(*instIt == dinst)
-      break;
-    instIt++;
-  }
+  // Retirement is in order, the entry is usually at the head
+  unsigned pos = head;
+  while(pos != tail && at(pos).dinst != dinst)
+    pos++;
+
+  I(pos != tail);
+  if (pos == tail)
+    return;
 
-  I(instIt != addrIt->second.end());
-  addrIt->second.erase(instIt);
+  Entry &e = at(pos);
+  if (storeSets && e.ssid >= 0 && lfst[e.ssid] == dinst)
+    lfst[e.ssid] = 0;
+  e.dinst = 0;
 
-  if(addrIt->second.size() == 0)
-    instMap.erase(addrIt);
-  
-  inflightInsts.erase(dinst);
+  while(head != tail && at(head).dinst == 0)
+    head++;
 }
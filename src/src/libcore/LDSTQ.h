@@ -24,7 +24,6 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #define LDSTQ_H
 
 #include <vector>
-#include <set>
 #include "estl.h"
 #include "GStats.h"
 
@@ -32,14 +31,41 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 class GProcessor;
 
+// In flight loads and stores of a processor, in program order, kept in a
+// flat ring (the entries of retired instructions are just cleared). When
+// a load or store executes, the younger entries to the same word detect
+// ordering violations and st-ld forwarding.
+//
+// Memory dependence prediction (storeSets = true in the cpucore section):
+// store sets (Chrysos and Emer, ISCA 98). By default the LDSTBuffer makes
+// every load wait for the older store to the same word (oracle). With
+// store sets the load only waits for the last fetched store of its set
+// (SSIT indexed by PC gives the set, LFST the store). The loads that go
+// ahead of an aliasing store are caught here when the store executes:
+// the load and the younger instructions are replayed, and the load and
+// the store are put in the same set. Only the oldest violating load is
+// replayed, and a younger store to the word hides the loads behind it.
+// Without store sets the violation and forwarding stats are counted as
+// before (executedOracle).
+//
+//  ssitSize  = 4096     SSIT entries (power of 2)
+//  lfstSize  = 256      number of store sets
+//  ssitClear = 1000000  cycles between SSIT clears (0 never)
 class LDSTQ {
  private:
-  typedef std::set<DInst *> DInstSet;
-  DInstSet inflightInsts;
+  class Entry {
+  public:
+    DInst *dinst; // 0 if already removed
+    VAddr  word;
+    int    ssid;  // store set when inserted, -1 none
+  };
 
-  typedef std::vector<DInst *> DInstQueue;
-  typedef HASH_MAP<PAddr, DInstQueue> AddrDInstQMap;
-  AddrDInstQMap instMap;
+  std::vector<Entry> ring;
+  unsigned head;  // oldest entry
+  unsigned tail;  // next free entry (head == tail, empty)
+
+  Entry &at(unsigned pos) { return ring[pos & (ring.size() - 1)]; }
+  void grow();
 
   GStatsCntr ldldViolations;
   GStatsCntr stldViolations;
@@ -47,7 +73,30 @@ class LDSTQ {
   GStatsCntr stldForwarding;
 
   GProcessor *gproc;
-  
+
+  // Store sets
+  bool storeSets;
+  int  ssitMask;
+  int  lfstSize;
+  Time_t ssitClear;
+  Time_t nextClear;
+  int  nextSSID;
+
+  std::vector<int>     ssit; // -1 invalid
+  std::vector<DInst *> lfst;
+
+  GStatsCntr ssDeps;
+  GStatsCntr ssTrain;
+  GStatsCntr ssReplays;
+
+  int calcSSIT(const DInst *dinst) const {
+    uint pc = dinst->getInst()->currentID();
+    return (pc ^ (pc >> 12)) & ssitMask;
+  }
+  int getSSID(const DInst *dinst);
+  void train(DInst *ld, DInst *st);
+  bool executedOracle(DInst *dinst, VAddr word);
+
  public:
   LDSTQ(GProcessor *gp, const int id);
   ~LDSTQ() { }
@@ -56,6 +105,10 @@ class LDSTQ {
   bool executed(DInst *dinst);
   void remove(DInst *dinst);
 
+  // true if loads can go ahead of older stores (the LDSTBuffer should
+  // not enforce the dependences in the same context)
+  bool hasStoreSets() const { return storeSets; }
+
   static VAddr calcWord(const DInst *dinst) {
     return (dinst->getVaddr()) >> 2;
   }
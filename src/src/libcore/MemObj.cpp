@@ -80,6 +80,40 @@ void MemObj::computenUpperCaches()
   }
 }
 
+int MemObj::ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst)
+{
+  if (lowerLevel.empty())
+    return 0;
+
+  return lowerLevel[0]->ffAccess(addr, write, this, dinst);
+}
+
+void MemObj::ffWriteBack(PAddr addr)
+{
+  if (!lowerLevel.empty())
+    lowerLevel[0]->ffWriteBack(addr);
+}
+
+bool MemObj::ffInvUpperLevel(PAddr addr)
+{
+  bool dirty = false;
+
+  for(uint i=0; i<upperLevel.size(); i++) {
+    if (upperLevel[i]->ffInvalidate(addr))
+      dirty = true;
+  }
+
+  return dirty;
+}
+
+int MemObj::ffLevel(PAddr addr)
+{
+  if (lowerLevel.empty())
+    return 0;
+
+  return lowerLevel[0]->ffLevel(addr);
+}
+
 void MemObj::dump() const
 {
   LOG("MemObj name [%s]",symbolicName);
@@ -40,6 +40,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #endif
 
 class MemRequest;      // Memory Request (from processor to cache)
+class DInst;
 
 class MemObj {
 public:
@@ -74,6 +75,9 @@ protected:
       upperLevel[i]->invalidate(addr, size, oc);    
   }
 
+  // Functional inclusion, true if an upper level had the line dirty
+  bool ffInvUpperLevel(PAddr addr);
+
 
 public:
   MemObj(const char *section, const char *sName);
@@ -119,6 +123,29 @@ public:
   virtual bool canAcceptStore(PAddr addr) = 0;
   virtual bool canAcceptLoad(PAddr addr) { return true; }
 
+  // Functional interface used by MemSampler between detailed windows. No
+  // timing and no MemRequest, only the tags and states are updated. Both
+  // return the number of cache levels missed, starting at this object
+  // (0 is a hit here). Objects that are not caches just pass it down.
+  //
+  // ffAccess brings the line (write: with write permission). src is the
+  // upper level that sent it (0 from the processor). dinst is the
+  // instruction (0 if there is none, like in fast forward)
+  // ffLevel  only looks, it stops at the first level that has the line
+  virtual int  ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst);
+  virtual int  ffLevel(PAddr addr);
+  // Functional access of another cache to the line (coherence)
+  virtual void ffSnoop(PAddr addr, bool write) { }
+  // A dirty line replaced in an upper level
+  virtual void ffWriteBack(PAddr addr);
+  // The lower level drops the line (inclusion). Returns true if it was
+  // dirty here or in an upper level
+  virtual bool ffInvalidate(PAddr addr) { return ffInvUpperLevel(addr); }
+
+  // The upper level src does not have the line anymore (replaced or
+  // invalidated). Used by the snoop filters
+  virtual void lineDropped(PAddr addr, MemObj *src) { }
+
   // Print stats
   virtual void dump() const;
 };
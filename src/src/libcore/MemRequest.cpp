@@ -32,12 +32,15 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "Pipeline.h"
 #include "Resource.h"
 #include "Cluster.h"
+#include "GProcessor.h"
+#include "HostProf.h"
+#include "MemSampler.h"
 
 
 ID(int MemRequest::numMemReqs = 0;);
 
 #ifdef SESC_SMP_DEBUG
-pool<ReqPathEntry> ReqPathEntry::pPool(4096, "ReqPathEntry");
+spool<ReqPathEntry> ReqPathEntry::pPool(4096, "ReqPathEntry");
 #endif
 
 /************************************************
@@ -61,11 +64,13 @@ MemRequest::~MemRequest()
 
 void MemRequest::access()
 {
+  HOSTPROF_SCOPE(HP_MemAccess);
   currentMemObj->access(this);
 }
 
 void MemRequest::returnAccess()
 {
+  HOSTPROF_SCOPE(HP_MemReturnAccess);
   mutateReadToWrite();
   currentMemObj->returnAccess(this);
 }
@@ -74,7 +79,7 @@ void MemRequest::returnAccess()
  *        DMemRequest 
  ************************************************/
 
-pool<DMemRequest, true>  DMemRequest::actPool(32, "DMemRequest");
+spool<DMemRequest>  DMemRequest::actPool(32, "DMemRequest");
 
 void DMemRequest::destroy() 
 {
@@ -104,12 +109,22 @@ void DMemRequest::dinstAck(DInst *dinst, MemOperation memOp, TimeDelta_t lat)
     I(memOp == MemRead);
     I(dinst->getResource());
 
+    ThreadUse *tuse = dinst->getResource()->getCluster()->getGProcessor()->getThreadUse(dinst);
+    if (tuse)
+      tuse->memLoads--;
+
     dinst->doAtExecutedCB.schedule(lat);
   }
 }
 
 void DMemRequest::create(DInst *dinst, GMemorySystem *gmem, MemOperation mop)
 {
+  if (mop == MemRead) {
+    ThreadUse *tuse = dinst->getResource()->getCluster()->getGProcessor()->getThreadUse(dinst);
+    if (tuse)
+      tuse->memLoads++; // until dinstAck
+  }
+
   // turn off address translation
   int old_addr = dinst->getVaddr();
 
@@ -125,10 +140,20 @@ void DMemRequest::create(DInst *dinst, GMemorySystem *gmem, MemOperation mop)
   }
 #endif
 
-  DMemRequest *r = actPool.out();
-
   I(dinst != 0);
 
+  int ph_addr = gmem->getMemoryOS()->TLBTranslate(old_addr);
+
+  MemSampler *ms = gmem->getMemSampler();
+  if (ms && ph_addr != -1 && !ms->isDetailed()) {
+    // functional, the caches are kept warm
+    TimeDelta_t lat = ms->doFunctional(gmem->getDataSource(), ph_addr, mop == MemWrite, dinst);
+    dinstAck(dinst, mop, lat);
+    return;
+  }
+
+  DMemRequest *r = actPool.out(dinst->getContextId());
+
   IS(r->acknowledged = false);
   I(r->memStack.empty());
   r->currentClockStamp = (Time_t) -1;
@@ -141,13 +166,18 @@ void DMemRequest::create(DInst *dinst, GMemorySystem *gmem, MemOperation mop)
   	r->clearStall();
   #endif
  
+  r->sampler = 0;
 
-  int ph_addr = gmem->getMemoryOS()->TLBTranslate(old_addr);
   if (ph_addr == -1) {
     gmem->getMemoryOS()->solveRequest(r);
     return;
   }
 
+  if (ms && mop == MemRead) {
+    r->sampler     = ms;
+    r->sampleLevel = ms->startDetailed(gmem->getDataSource(), ph_addr);
+    r->sampleStart = globalClock;
+  }
 
   r->setPAddr(ph_addr);
   r->access();
@@ -161,6 +191,9 @@ void DMemRequest::ack(TimeDelta_t lat)
   I(!acknowledged);           // no double ack
   IS(acknowledged = true);
 
+  if (sampler)
+    sampler->learn(sampleLevel, globalClock + lat - sampleStart);
+
   dinstAck(dinst, memOp, lat);
 
   dinst = 0;
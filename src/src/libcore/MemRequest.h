@@ -63,6 +63,7 @@ class MemObj;
 class GMemorySystem;
 class GProcessor;
 class IBucket;
+class MemSampler;
 
 #ifdef TASKSCALAR
 class VMemReq;
@@ -71,8 +72,8 @@ class VMemReq;
 #ifdef SESC_SMP_DEBUG
 class ReqPathEntry {
 private:
-  static pool<ReqPathEntry> pPool;
-  friend class pool<ReqPathEntry>;
+  static spool<ReqPathEntry> pPool;
+  friend class spool<ReqPathEntry>;
 
 public:
   const char *memobj;
@@ -480,8 +481,13 @@ public:
 class DMemRequest : public MemRequest {
   // MemRequest specialized for dcache
  private:
-  static pool<DMemRequest, true> actPool;
-  friend class pool<DMemRequest, true>;
+  static spool<DMemRequest> actPool;
+  friend class spool<DMemRequest>;
+
+  // detailed load observed by a MemSampler (sampler 0 otherwise)
+  MemSampler *sampler;
+  int         sampleLevel;
+  Time_t      sampleStart;
 
   void destroy();
   static void dinstAck(DInst *dinst, MemOperation memOp, TimeDelta_t lat);
@@ -0,0 +1,218 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <math.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "SescConf.h"
+#include "ReportGen.h"
+#include "MemObj.h"
+#include "MemSampler.h"
+
+MemSampler::MemSampler(const char *section, const char *format, ...)
+{
+  char *str;
+  va_list ap;
+
+  va_start(ap, format);
+  str = getText(format, ap);
+  va_end(ap);
+
+  name = str;
+  subscribe();
+
+  skip = 0;
+  if (SescConf->checkInt(section, "skip")) {
+    SescConf->isGT(section, "skip", -1);
+    skip = SescConf->getInt(section, "skip");
+  }
+
+#if (defined TM)
+  if (skip) {
+    // goFunctional would run through transactions without the TM tags,
+    // the conflict checks and the begin backoff
+    MSG("MemSampler:skip is not supported with TM in section [%s]", section);
+    SescConf->notCorrect();
+    skip = 0;
+  }
+#endif
+
+  if (skip) {
+    SescConf->isGT(section, "detailed", 0);
+    detailed = SescConf->getInt(section, "detailed");
+    period   = detailed;
+  }else{
+    SescConf->isGT(section, "period", 0);
+    SescConf->isBetween(section, "detailed", 1, SescConf->getInt(section, "period"));
+
+    period   = SescConf->getInt(section, "period");
+    detailed = SescConf->getInt(section, "detailed");
+  }
+
+  curWindow   = 0;
+  windowStart = 0;
+
+  for(int i = 0; i < MaxLevels; i++) {
+    latSum[i] = 0;
+    latN[i]   = 0;
+    ffRefs[i] = 0;
+  }
+
+  nDetailed   = 0;
+  nFunctional = 0;
+
+  winLatSum = 0;
+  winLatN   = 0;
+  winRefs   = 0;
+  winMisses = 0;
+
+  detailedMode = true;
+  modeStart    = hostNow();
+  hostSecs[0]  = 0;
+  hostSecs[1]  = 0;
+  nInsts[0]    = 0;
+  nInsts[1]    = 0;
+}
+
+double MemSampler::hostNow()
+{
+  timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec/1e6;
+}
+
+void MemSampler::flushHost()
+{
+  double t = hostNow();
+  hostSecs[detailedMode] += t - modeStart;
+  modeStart = t;
+}
+
+void MemSampler::closeWindow()
+{
+  if (winLatN)
+    winLat.sample(winLatSum/winLatN);
+  if (winRefs)
+    winMissRate.sample(static_cast<double>(winMisses)/winRefs);
+
+  winLatSum = 0;
+  winLatN   = 0;
+  winRefs   = 0;
+  winMisses = 0;
+}
+
+int MemSampler::startDetailed(MemObj *dataSource, PAddr addr)
+{
+  nDetailed++;
+
+  int level = dataSource->ffLevel(addr);
+  if (level >= MaxLevels)
+    level = MaxLevels - 1;
+
+  winRefs++;
+  if (level)
+    winMisses++;
+
+  return level;
+}
+
+void MemSampler::learn(int level, Time_t lat)
+{
+  I(level >= 0 && level < MaxLevels);
+
+  latSum[level] += lat;
+  latN[level]++;
+
+  winLatSum += lat;
+  winLatN++;
+}
+
+bool MemSampler::newInst(Time_t &flowWindow)
+{
+  if (skip == 0) {
+    setMode(isDetailed());
+    nInsts[detailedMode]++;
+    return false;
+  }
+
+  nInsts[1]++;
+
+  if (globalClock - windowStart >= detailed) {
+    closeWindow();
+    curWindow++;
+    windowStart = globalClock;
+  }
+
+  if (flowWindow == curWindow)
+    return false;
+
+  flowWindow = curWindow;
+  return true;
+}
+
+TimeDelta_t MemSampler::doFunctional(MemObj *dataSource, PAddr addr, bool write, DInst *dinst)
+{
+  nFunctional++;
+
+  int level = dataSource->ffAccess(addr, write, 0, dinst);
+  if (level >= MaxLevels)
+    level = MaxLevels - 1;
+
+  ffRefs[level]++;
+
+  // closest level with samples, deeper first
+  for(int i = level; i < MaxLevels; i++) {
+    if (latN[i])
+      return static_cast<TimeDelta_t>(latSum[i]/latN[i]);
+  }
+  for(int i = level - 1; i >= 0; i--) {
+    if (latN[i])
+      return static_cast<TimeDelta_t>(latSum[i]/latN[i]);
+  }
+
+  return 1;
+}
+
+void MemSampler::reportValue() const
+{
+  Report::field("%s:period=%lld:detailed=%lld:skip=%lld", name, period, detailed, skip);
+  Report::field("%s:detailedRefs=%lld", name, nDetailed);
+  Report::field("%s:functionalRefs=%lld", name, nFunctional);
+
+  for(int i = 0; i < MaxLevels; i++) {
+    if (latN[i] == 0 && ffRefs[i] == 0)
+      continue;
+    Report::field("%s_L(%d):lat=%.2f:samples=%lld:ffRefs=%lld", name, i
+                  ,latN[i] ? latSum[i]/latN[i] : 0.0, latN[i], ffRefs[i]);
+  }
+
+  Report::field("%s:windows=%lld", name, winLat.n);
+  Report::field("%s:avgLat=%.3f:ci95=%.3f", name, winLat.mean, winLat.ci95());
+  Report::field("%s:missRate=%.5f:ci95=%.5f", name, winMissRate.mean, winMissRate.ci95());
+
+  // host time of the whole run at the detailed speed over the real one
+  double speedup = 0;
+  if (nInsts[1] && hostSecs[0] + hostSecs[1] > 0)
+    speedup = hostSecs[1]/nInsts[1]*(nInsts[0] + nInsts[1])/(hostSecs[0] + hostSecs[1]);
+
+  Report::field("%s:detailedInsts=%lld:functionalInsts=%lld", name, nInsts[1], nInsts[0]);
+  Report::field("%s:hostDetailed=%.3f:hostFunctional=%.3f:speedup=%.2f", name
+                ,hostSecs[1], hostSecs[0], speedup);
+}
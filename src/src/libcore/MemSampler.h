@@ -0,0 +1,177 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef MEMSAMPLER_H
+#define MEMSAMPLER_H
+
+#include <math.h>
+
+#include "nanassert.h"
+#include "callback.h"
+#include "GStats.h"
+
+class MemObj;
+class DInst;
+
+// Sampled memory hierarchy (memSampler = 'section' in the cpucore
+// section). Time is split in periods of 'period' cycles. The first
+// 'detailed' cycles of each period the data references go through the
+// normal MemRequest path. The rest of the period they only update the
+// caches functionally (MemObj::ffAccess) and the load latency comes
+// from a model learned in the detailed windows: the average latency of
+// the loads that hit at each level of the hierarchy (level found with
+// MemObj::ffLevel when the request starts).
+//
+// With skip the core does not stay in the timing model between windows:
+// after each detailed window every flow of the processor fast forwards
+// 'skip' instructions (ExecutionFlow::goFunctional, as rabbit mode)
+// and their data references warm the caches functionally. The windows
+// are back to back in simulated time and period is not used. Not
+// supported with TLS, TASKSCALAR, MIPS_EMUL nor TM (configuration
+// error). The instruction caches are not warmed.
+//
+// Instruction fetches are always detailed.
+//
+// Each detailed window gives one sample of the average load latency and
+// of the first level miss rate. They are reported with the 95%
+// confidence interval of the mean over the windows. The host time and
+// instructions of the detailed and functional parts are reported too,
+// speedup is the host time the run would take at the detailed
+// instructions per second over the measured host time.
+//
+// Configuration section:
+//   period   = 1000000
+//   detailed = 100000
+//   skip     = 0       # instructions fast forwarded per window
+class MemSampler : public GStats {
+private:
+  enum { MaxLevels = 8 };
+
+  // mean and variance of the per window samples (Welford)
+  class WindowStat {
+  public:
+    long long n;
+    double    mean;
+    double    m2;
+
+    WindowStat() : n(0), mean(0), m2(0) { }
+
+    void sample(double v) {
+      n++;
+      double d = v - mean;
+      mean += d/n;
+      m2   += d*(v - mean);
+    }
+    double ci95() const {
+      if (n < 2)
+        return 0;
+      return 1.96*sqrt(m2/(n-1)/n);
+    }
+  };
+
+  Time_t period;
+  Time_t detailed;
+  long long skip;
+
+  Time_t curWindow;
+  Time_t windowStart; // skip mode
+
+  // learned model, detailed loads
+  double    latSum[MaxLevels];
+  long long latN[MaxLevels];
+
+  // functional references per level
+  long long ffRefs[MaxLevels];
+
+  long long nDetailed;
+  long long nFunctional;
+
+  // current window
+  double    winLatSum;
+  long long winLatN;
+  long long winRefs;
+  long long winMisses;
+
+  WindowStat winLat;
+  WindowStat winMissRate;
+
+  // host seconds and instructions, [0] functional [1] detailed
+  bool      detailedMode;
+  double    modeStart;
+  double    hostSecs[2];
+  long long nInsts[2];
+
+  void closeWindow();
+
+  static double hostNow();
+  // host time up to now goes to the current mode
+  void flushHost();
+  void setMode(bool d) {
+    if (d == detailedMode)
+      return;
+    flushHost();
+    detailedMode = d;
+  }
+
+protected:
+  void prepareReport() {
+    closeWindow();
+    flushHost();
+  }
+
+public:
+  MemSampler(const char *section, const char *format, ...);
+
+  bool isDetailed() {
+    if (skip)
+      return true; // the core skips instead (newInst)
+
+    Time_t w = globalClock / period;
+    if (w != curWindow) {
+      closeWindow();
+      curWindow = w;
+    }
+    return (globalClock % period) < detailed;
+  }
+
+  // Detailed request: level of the hierarchy that has the line
+  int startDetailed(MemObj *dataSource, PAddr addr);
+  // Detailed load finished, lat cycles since startDetailed
+  void learn(int level, Time_t lat);
+
+  // Functional reference, returns the modeled latency
+  TimeDelta_t doFunctional(MemObj *dataSource, PAddr addr, bool write, DInst *dinst);
+
+  // A flow executes a timing instruction. In skip mode it returns true
+  // when the flow has to fast forward getSkip() instructions now, once
+  // per window (flowWindow is kept by the flow, 0 at the beginning)
+  bool newInst(Time_t &flowWindow);
+  long long getSkip() const { return skip; }
+
+  // The flow fast forwards (between the two calls)
+  void beginSkip() { setMode(false); }
+  void endSkip(long long n) {
+    nInsts[0] += n;
+    setMode(true);
+  }
+
+  void reportValue() const;
+};
+
+#endif // MEMSAMPLER_H
@@ -40,9 +40,12 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "SescConf.h"
 #include "Instruction.h"
 #include "GStats.h"
+#include "HostProf.h"
 #include "GMemorySystem.h"
 #include "GProcessor.h"
 #include "FetchEngine.h"
+#include "BPredTrace.h"
+#include "SescTrace.h"
 
 #ifdef SESC_THERM
 #include "ReportTherm.h"
@@ -73,6 +76,7 @@ namespace Profiling
 #include <ctime>
 #include "transReport.h"
 #include "transCoherence.h"
+#include "transConfig.h"
 #endif
 
 #ifdef TASKSCALAR
@@ -247,6 +251,7 @@ void OSSim::processParams(int argc, char **argv, char **envp)
   const char *confName=0;
   const char *extension=0;
   justTest=false;
+  bpredReplay=0;
 
   if( argc < 2 ) {
     fprintf(stderr,"%s usage:\n",argv[0]);
@@ -257,6 +262,7 @@ void OSSim::processParams(int argc, char **argv, char **envp)
     fprintf(stderr,"\t-t          ; Do not execute, just test the configuration file\n");
     fprintf(stderr,"\t-yINT       ; Number of instructions to simulate\n");
     fprintf(stderr,"\t-bTEXT      ; Benchmark specific configuration section\n");
+    fprintf(stderr,"\t-BTEXT      ; Replay branch trace TEXT through the bpredTune[] predictors\n");
 
 #ifdef TRACE_DRIVEN
     fprintf(stderr,"\n\nExample:\n");
@@ -371,6 +377,15 @@ void OSSim::processParams(int argc, char **argv, char **envp)
           benchSection = argv[i];
         }
       }
+      else if( argv[i][1] == 'B' ) {
+        if( argv[i][2] != 0 )
+          bpredReplay = &argv[i][2];
+        else {
+          i++;
+          bpredReplay = argv[i];
+        }
+        justTest = true; // the application is not executed
+      }
       else if( argv[i][1] == 'c' ) {
         if( argv[i][2] != 0 )
           confName = &argv[i][2];
@@ -455,6 +470,12 @@ void OSSim::processParams(int argc, char **argv, char **envp)
 
   SescConf = new SConfig(confName);   // First thing to do
 
+#if (defined TM)
+  // Threads are created by Instruction::initialize, bind the TM
+  // parameters before
+  tmConfig = new transConfig(SescConf);
+#endif
+
   Instruction::initialize(nargc, nargv, envp);
 
   if( reportTo ) {
@@ -488,14 +509,14 @@ void OSSim::processParams(int argc, char **argv, char **envp)
   tmReport = new transReport(finalReportFile);
   if(1)
     transGCM = new transCoherence(tmReport->getOutfile(),
-                                  SescConf->getInt("TransactionalMemory","conflictDetect"),
-                                  SescConf->getInt("TransactionalMemory","versioning"),
-                                  SescConf->getInt("TransactionalMemory","cacheLineSize"));
+                                  tmConfig->conflictDetect,
+                                  tmConfig->versioning,
+                                  tmConfig->cacheLineSize);
   else
     transGCM = new transCoherence(NULL,
-                                  SescConf->getInt("TransactionalMemory","conflictDetect"),
-                                  SescConf->getInt("TransactionalMemory","versioning"),
-                                  SescConf->getInt("TransactionalMemory","cacheLineSize"));
+                                  tmConfig->conflictDetect,
+                                  tmConfig->versioning,
+                                  tmConfig->cacheLineSize);
     
 #endif
 
@@ -994,6 +1015,13 @@ void OSSim::preBoot()
   alreadyBoot = true;
 
   SescConf->dump();
+#if (defined TM)
+  tmConfig->dump();
+#endif
+
+  BPredTuner *bpredTuner = 0;
+  if (bpredReplay)
+    bpredTuner = new BPredTuner(bpredReplay);
 
   SescConf->lock();       // All the objects should be loaded
 
@@ -1028,11 +1056,17 @@ void OSSim::preBoot()
 #endif
 
   if( justTest ) {
-    MSG("Configuration tested");
+    if (bpredTuner) {
+      bpredTuner->run();
+      delete bpredTuner;
+    }else{
+      MSG("Configuration tested");
+    }
     return;
   }
 
   gettimeofday(&stTime, 0);
+  HOSTPROF_PHASE("rabbit");
 #if (defined MIPS_EMUL)
   MSG("Begin skipping: requested %lld instructions\n",nInst2Skip);
   MSG("End skipping: requested %lld skipped %lld\n",nInst2Skip,ThreadContext::skipInsts(nInst2Skip));
@@ -1086,6 +1120,7 @@ void OSSim::preBoot()
     //MSG("...End Skipping Initialization (Rabbit mode)");
   }
 #endif // Else of (defined MIPS_EMUL)
+  HOSTPROF_PHASE("timing");
 }
 
 void OSSim::postBoot()
@@ -1101,6 +1136,10 @@ void OSSim::simFinish()
   // Work finished, dump statistics
   report("Final");
 
+  // Nothing is destroyed on the way out (exit)
+  BPredTraceWriter::closeAll();
+  SescTraceWriter::closeAll();
+
 #ifdef TASKSCALAR
   TaskContext::finish();
 #endif
@@ -1156,6 +1195,10 @@ void OSSim::report(const char *str)
 
   Report::field("OSSim:pseudoreset=%lld",snapshotGlobalClock);
 
+#ifdef SESC_HOSTPROF
+  HostProf::report();
+#endif
+
 #ifdef SESC_ENERGY
   const char *procName = SescConf->getCharPtr("","cpucore",0);
   double totPower      = 0.0;
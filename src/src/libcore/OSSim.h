@@ -76,6 +76,7 @@ private:
   char *benchRunning;
   char *benchSection;
   bool justTest;
+  char *bpredReplay; // -B: replay this branch trace and exit
 
   bool NoMigration; // Configuration option that dissables migration (optional)
   // Number of instructions to skip passed as parameter when the
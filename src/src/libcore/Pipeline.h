@@ -131,6 +131,10 @@ public:
     // bucketPool.size() has lineal time O(n)
     return !buffer.empty() || !received.empty() || nIRequests < MaxIRequests;
   } 
+  // Nothing ready to decode, instruction cache requests outstanding
+  bool isWaitingFetch() const {
+    return buffer.empty() && nIRequests < MaxIRequests;
+  }
   void readyItem(IBucket *b);
   void doneItem(IBucket *b) {
     I(b->getPipelineId() < minItemCntr);
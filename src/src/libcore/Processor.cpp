@@ -32,6 +32,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "GMemorySystem.h"
 #include "ExecutionFlow.h"
 #include "OSSim.h"
+#include "HostProf.h"
 
 #if (defined TM)
 #include "transReport.h"
@@ -67,6 +68,11 @@ FetchEngine *Processor::currentFlow()
   return &IFID;
 }
 
+CPICause Processor::frontEndStall()
+{
+  return IFID.getStallCause(pipeQ.pipeLine);
+}
+
 #if !(defined MIPS_EMUL)
 void Processor::saveThreadContext(Pid_t pid)
 {
@@ -142,6 +148,8 @@ void Processor::goRabbitMode(long long n2Skip)
 
 void Processor::advanceClock()
 {
+  HOSTPROF_SCOPE(HP_AdvanceClock);
+
 #ifdef TS_STALL
   if (isStall()) return;
 #endif  
@@ -213,29 +221,44 @@ StallCause Processor::addInst(DInst *dinst)
   if (sc != NoStall)
     return sc;
 
+  renameRegs(RAT, dinst);
 
-  I(dinst->getResource() != 0); // Resource::schedule must set the resource field
+  return NoStall;
+}
 
-  if(!dinst->isSrc2Ready()) {
-    // It already has a src2 dep. It means that it is solved at
-    // retirement (Memory consistency. coherence issues)
-    if( RAT[inst->getSrc1()] )
-      RAT[inst->getSrc1()]->addSrc1(dinst);
-  }else{
-    if( RAT[inst->getSrc1()] )
-      RAT[inst->getSrc1()]->addSrc1(dinst);
+int Processor::addBundle(IBucket *bucket, int n, StallCause &sc)
+{
+  int room = renameRoom(bucket, n, sc);
+
+  RenameCount rc;
+  while(rc.n < room) {
+    DInst *dinst = bucket->top();
+    const Instruction *inst = dinst->getInst();
+
+    if (InOrderCore) {
+      if(RAT[inst->getSrc1()] != 0 || RAT[inst->getSrc2()] != 0 
+         || RAT[inst->getDest()] != 0
+         ) {
+        sc = SmallWinStall;
+        break;
+      }
+    }
 
-    if( RAT[inst->getSrc2()] )
-      RAT[inst->getSrc2()]->addSrc2(dinst);
-  }
+    StallCause c = scheduleInst(dinst);
+    if (c != NoStall) {
+      sc = c;
+      break;
+    }
 
-  dinst->setRATEntry(&RAT[inst->getDest()]);
-  RAT[inst->getDest()] = dinst;
+    renameRegs(RAT, dinst);
+    rc.add(inst);
 
-  I(dinst->getResource());
-  dinst->getResource()->getCluster()->addInst(dinst);
+    bucket->pop();
+  }
 
-  return NoStall;
+  addRenameEnergy(rc);
+
+  return rc.n;
 }
 
 bool Processor::hasWork() const 
@@ -47,6 +47,7 @@ protected:
   // BEGIN VIRTUAL FUNCTIONS of GProcessor
   DInst **getRAT(const int contextId);
   FetchEngine *currentFlow();
+  CPICause frontEndStall();
 
 #if !(defined MIPS_EMUL)
   void saveThreadContext(Pid_t pid);
@@ -73,6 +74,7 @@ protected:
   void advanceClock();
 
   StallCause addInst(DInst *dinst);
+  int addBundle(IBucket *bucket, int n, StallCause &sc);
   
   // END VIRTUAL FUNCTIONS of GProcessor
 public:
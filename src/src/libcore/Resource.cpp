@@ -218,8 +218,9 @@ StallCause FULoad::canIssue(DInst *dinst)
 
   cluster->newEntry();
 
-  LDSTBuffer::getLoadEntry(dinst);
-  cluster->getGProcessor()->getLSQ()->insert(dinst);
+  LDSTQ *lsq = cluster->getGProcessor()->getLSQ();
+  LDSTBuffer::getLoadEntry(dinst, !lsq->hasStoreSets());
+  lsq->insert(dinst);
 
   if (dinst->isFake())
     misLoads++;
@@ -24,10 +24,13 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "SMTProcessor.h"
 
+#include <strings.h>
+
 #include "SescConf.h"
 
 #include "FetchEngine.h"
 #include "ExecutionFlow.h"
+#include "HostProf.h"
 
 SMTProcessor::Fetch::Fetch(GMemorySystem *gm, CPU_t cpuID, int cid, GProcessor *gproc, FetchEngine *fe)
   : IFID(cpuID, cid, gm, gproc, fe)
@@ -46,6 +49,7 @@ SMTProcessor::SMTProcessor(GMemorySystem *gm, CPU_t i)
   ,smtDecodes4Clk(SescConf->getInt("cpucore", "smtDecodes4Clk",i))
   ,smtIssues4Clk(SescConf->getInt("cpucore", "smtIssues4Clk",i))
   ,firstContext(i*smtContexts)
+  ,use(smtContexts)
   ,fetchDist("Processor(%d)_fetchDist", i) // noFetch is on GProcessor
 #ifdef TASKSCALAR
   ,fetchFromSafe("Processor(%d)_fetchFromSafe", i)
@@ -84,10 +88,72 @@ SMTProcessor::SMTProcessor(GMemorySystem *gm, CPU_t i)
   cIssueId =0;
 
   spaceInInstQueue = InstQueueSize;
+
+  fetchPolicy = RRFetch;
+  if (SescConf->checkCharPtr("cpucore", "smtFetchPolicy", Id)) {
+    const char *pol = SescConf->getCharPtr("cpucore", "smtFetchPolicy", Id);
+    if (strcasecmp(pol, "RR") == 0) {
+      fetchPolicy = RRFetch;
+    }else if (strcasecmp(pol, "ICOUNT") == 0) {
+      fetchPolicy = ICountFetch;
+    }else if (strcasecmp(pol, "BRCOUNT") == 0) {
+      fetchPolicy = BRCountFetch;
+    }else if (strcasecmp(pol, "MISSCOUNT") == 0) {
+      fetchPolicy = MissCountFetch;
+    }else{
+      MSG("SMTProcessor: invalid smtFetchPolicy [%s] (RR, ICOUNT, BRCOUNT, MISSCOUNT)", pol);
+      SescConf->notCorrect();
+    }
+  }
+
+  partPolicy = NoPartition;
+  if (SescConf->checkCharPtr("cpucore", "smtPartition", Id)) {
+    const char *part = SescConf->getCharPtr("cpucore", "smtPartition", Id);
+    if (strcasecmp(part, "none") == 0) {
+      partPolicy = NoPartition;
+    }else if (strcasecmp(part, "static") == 0) {
+      partPolicy = StaticPartition;
+    }else if (strcasecmp(part, "dynamic") == 0) {
+      partPolicy = DynamicPartition;
+    }else{
+      MSG("SMTProcessor: invalid smtPartition [%s] (none, static, dynamic)", part);
+      SescConf->notCorrect();
+    }
+  }
+
+  lsqSize = SescConf->getInt("cpucore", "maxLoads", Id)
+    + SescConf->getInt("cpucore", "maxStores", Id);
+
+  winSize = 0;
+  const char *coreSection = SescConf->getCharPtr("", "cpucore", Id);
+  int nClusters = SescConf->getRecordSize(coreSection, "cluster");
+  for(int c = 0; c < nClusters; c++)
+    winSize += SescConf->getInt(SescConf->getCharPtr(coreSection, "cluster", c), "winSize");
+
+  nActive = 1;
+
+  threadUse     = &use[0];
+  threadUseBase = firstContext;
+
+  // Same names as the ExeEngine stall counters
+  static const char *stallName[MaxStall] = {
+    0, "nSmallWin", "nSmallROB", "nSmallREG", "nOutsLoads", "nOutsStores"
+    ,"nOutsBranches", "nReplays", "PortConflict", "switch" };
+
+  threadStall = new GStatsCntr *[smtContexts*MaxStall];
+  partStall   = new GStatsCntr *[smtContexts];
+  for(int t = 0; t < smtContexts; t++) {
+    threadStall[t*MaxStall] = 0;
+    for(int c = 1; c < MaxStall; c++)
+      threadStall[t*MaxStall + c] = new GStatsCntr("ExeEngine(%d)_T%d:%s", Id, t, stallName[c]);
+    partStall[t] = new GStatsCntr("ExeEngine(%d)_T%d:nPartition", Id, t);
+  }
 }
 
 SMTProcessor::~SMTProcessor()
 {
+  threadUse = 0;
+
   for(FetchContainer::iterator it = flow.begin();
       it != flow.end();
       it++) {
@@ -120,6 +186,17 @@ FetchEngine *SMTProcessor::currentFlow()
   return &flow[cFetchId]->IFID;
 }
 
+CPICause SMTProcessor::frontEndStall()
+{
+  // Charged to the flow that had the fetch slot this cycle. No flow
+  // has it once every context is gone and the pipeline drains
+  if (cFetchId < 0)
+    return CPIFrontEnd;
+
+  Fetch *f = flow[cFetchId];
+  return f->IFID.getStallCause(f->pipeQ.pipeLine);
+}
+
 #if !(defined MIPS_EMUL)
 void SMTProcessor::saveThreadContext(Pid_t pid)
 {
@@ -230,6 +307,94 @@ void SMTProcessor::goRabbitMode(long long n2Skip)
   selectFetchFlow();
 }
 
+int SMTProcessor::fetchKey(int t) const
+{
+  switch(fetchPolicy) {
+  case BRCountFetch:
+    return use[t].branches;
+  case MissCountFetch:
+    return use[t].memLoads;
+  default:
+    return use[t].frontEnd + use[t].window;
+  }
+}
+
+void SMTProcessor::sortFetchFlows()
+{
+  // Running threads by key, the ties in round-robin order
+  fetchOrder.clear();
+  int start = clockTicks % smtContexts;
+  for(int i = 0; i < smtContexts; i++) {
+    int t = (start + i) % smtContexts;
+    if (flow[t]->IFID.getPid() < 0)
+      continue;
+
+    int key = fetchKey(t);
+    fetchOrder.push_back(t);
+    int pos = fetchOrder.size() - 1;
+    while(pos > 0 && fetchKey(fetchOrder[pos-1]) > key) {
+      fetchOrder[pos] = fetchOrder[pos-1];
+      pos--;
+    }
+    fetchOrder[pos] = t;
+  }
+
+  if (fetchOrder.size() > static_cast<size_t>(smtFetchs4Clk))
+    fetchOrder.resize(smtFetchs4Clk);
+
+  if (fetchOrder.empty()) {
+    cFetchId = -1;
+    I(hasWork());
+  }
+}
+
+int SMTProcessor::nRunning() const
+{
+  int n = 0;
+  for(int t = 0; t < smtContexts; t++) {
+    if (flow[t]->IFID.getPid() >= 0)
+      n++;
+  }
+
+  return n ? n : 1;
+}
+
+bool SMTProcessor::overLimit(int t, int used, int total) const
+{
+  int share;
+  if (partPolicy == StaticPartition) {
+    share = total / smtContexts;
+  }else if (partPolicy == DynamicPartition) {
+    if (use[t].memLoads == 0)
+      return false;
+    share = total / nActive;
+  }else{
+    return false;
+  }
+
+  return used >= (share > 0 ? share : 1);
+}
+
+StallCause SMTProcessor::checkPartition(DInst *dinst)
+{
+  int t = dinst->getContextId() - firstContext;
+  const ThreadUse &u = use[t];
+  const Instruction *inst = dinst->getInst();
+
+  if (overLimit(t, u.rob, MaxROBSize))
+    return SmallROBStall;
+
+  if (inst->isLoad() && overLimit(t, u.lsq, lsqSize))
+    return OutsLoadsStall;
+  if (inst->isStore() && overLimit(t, u.lsq, lsqSize))
+    return OutsStoresStall;
+
+  if (overLimit(t, u.window, winSize))
+    return SmallWinStall;
+
+  return NoStall;
+}
+
 void SMTProcessor::selectFetchFlow()
 {
   // ROUND-ROBIN POLICY
@@ -257,6 +422,8 @@ void SMTProcessor::selectIssueFlow()
 
 void SMTProcessor::advanceClock()
 {
+  HOSTPROF_SCOPE(HP_AdvanceClock);
+
   clockTicks++;
   
   // Fetch Stage
@@ -269,11 +436,28 @@ void SMTProcessor::advanceClock()
   int tries = 0;
 #endif
 
-  for(int i = 0; i < smtContexts && nFetched < FetchWidth; i++) {
-    selectFetchFlow();
+  nActive = nRunning();
+
+  int nFlows = smtContexts;
+  if (fetchPolicy != RRFetch) {
+    sortFetchFlows();
+    nFlows = fetchOrder.size();
+  }
+
+  for(int i = 0; i < nFlows && nFetched < FetchWidth; i++) {
+    if (fetchPolicy == RRFetch)
+      selectFetchFlow();
+    else
+      cFetchId = fetchOrder[i];
+
     if (cFetchId >=0) {
       I(flow[cFetchId]->IFID.hasWork());
 
+      if (overLimit(cFetchId, use[cFetchId].frontEnd, InstQueueSize)) {
+        partStall[cFetchId]->inc();
+        continue;
+      }
+
 #ifdef TASKSCALAR
       // WARNING: this is temporary ugly code
       TaskContext *tc = TaskContext::getTaskContext(flow[cFetchId]->IFID.getPid());
@@ -309,6 +493,7 @@ void SMTProcessor::advanceClock()
 	flow[cFetchId]->IFID.fetch(bucket, fetchMax);
 	// readyItem will be called once the bucket is fetched
 	nFetched += bucket->size();
+	use[cFetchId].frontEnd += bucket->size();
 	fetchDist.sample(cFetchId, bucket->size()); 
 #ifdef TASKSCALAR
 	if(tc->getVersionRef()->isSafe())
@@ -352,6 +537,7 @@ void SMTProcessor::advanceClock()
       continue;
     
     int issuedInsts = issue(flow[cIssueId]->pipeQ);
+    use[cIssueId].frontEnd -= issuedInsts;
     
     totalIssuedInsts += issuedInsts;
   }
@@ -364,41 +550,80 @@ StallCause SMTProcessor::addInst(DInst *dinst)
 {
   const Instruction *inst = dinst->getInst();
 
-  DInst **RAT = gRAT[dinst->getContextId()-firstContext];
+  int t = dinst->getContextId()-firstContext;
+  DInst **RAT = gRAT[t];
 
   if( InOrderCore ) {
     if(RAT[inst->getSrc1()] != 0 || RAT[inst->getSrc2()] != 0) {
+      threadStall[t*MaxStall + SmallWinStall]->inc();
       return SmallWinStall;
     }
   }
 
-  StallCause sc = sharedAddInst(dinst);
-  if (sc != NoStall)
+  StallCause sc = checkPartition(dinst);
+  if (sc != NoStall) {
+    partStall[t]->inc();
+  }else{
+    sc = sharedAddInst(dinst);
+  }
+  if (sc != NoStall) {
+    threadStall[t*MaxStall + sc]->inc();
     return sc;
+  }
 
-  I(dinst->getResource() != 0); // Resource::schedule must set the resource field
+  use[t].renamed(inst);
 
-  if(!dinst->isSrc2Ready()) {
-    // It already has a src2 dep. It means that it is solved at
-    // retirement (Memory consistency. coherence issues)
-    if( RAT[inst->getSrc1()] )
-      RAT[inst->getSrc1()]->addSrc1(dinst);
-  }else{
-    if( RAT[inst->getSrc1()] )
-      RAT[inst->getSrc1()]->addSrc1(dinst);
+  renameRegs(RAT, dinst);
 
-    if( RAT[inst->getSrc2()] )
-      RAT[inst->getSrc2()]->addSrc2(dinst);
-  }
+  return NoStall;
+}
+
+int SMTProcessor::addBundle(IBucket *bucket, int n, StallCause &sc)
+{
+  // A bucket comes from one flow, all its instructions share the RAT
+  int t = bucket->top()->getContextId()-firstContext;
+  DInst **RAT = gRAT[t];
+
+  int room = renameRoom(bucket, n, sc);
+
+  RenameCount rc;
+  while(rc.n < room) {
+    DInst *dinst = bucket->top();
+    const Instruction *inst = dinst->getInst();
+    I(dinst->getContextId()-firstContext == t);
+
+    if( InOrderCore ) {
+      if(RAT[inst->getSrc1()] != 0 || RAT[inst->getSrc2()] != 0) {
+        sc = SmallWinStall;
+        break;
+      }
+    }
+
+    StallCause c = checkPartition(dinst);
+    if (c != NoStall) {
+      partStall[t]->inc();
+    }else{
+      c = scheduleInst(dinst);
+    }
+    if (c != NoStall) {
+      sc = c;
+      break;
+    }
 
-  dinst->setRATEntry(&RAT[inst->getDest()]);
+    use[t].renamed(inst);
 
-  RAT[inst->getDest()] = dinst;
+    renameRegs(RAT, dinst);
+    rc.add(inst);
 
-  I(dinst->getResource());
-  dinst->getResource()->getCluster()->addInst(dinst);
+    bucket->pop();
+  }
 
-  return NoStall;
+  if (rc.n < n)
+    threadStall[t*MaxStall + sc]->inc();
+
+  addRenameEnergy(rc);
+
+  return rc.n;
 }
 
 bool SMTProcessor::hasWork() const 
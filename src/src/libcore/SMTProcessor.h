@@ -45,7 +45,33 @@ private:
   const int smtIssues4Clk;
   const int firstContext;
 
+  // Fetch policy (smtFetchPolicy): RR rotates the threads every cycle,
+  // the others fetch first from the threads with fewer instructions in
+  // the front end and window (ICOUNT), unresolved branches (BRCOUNT) or
+  // loads in the memory hierarchy (MISSCOUNT). Up to smtFetchs4Clk
+  // threads fetch each cycle.
+  //
+  // Resource partitioning (smtPartition) of the ROB, LDSTQ, windows and
+  // instruction queue: static gives each context 1/smtContexts of
+  // them. dynamic splits them among the running threads, and only
+  // limits the threads that have loads in the memory hierarchy, so that
+  // a thread stalled on memory (misses, NACKs) can not take them all.
+  enum FetchPolicy { RRFetch = 0, ICountFetch, BRCountFetch, MissCountFetch };
+  enum PartPolicy  { NoPartition = 0, StaticPartition, DynamicPartition };
+
+  FetchPolicy fetchPolicy;
+  PartPolicy  partPolicy;
+
+  int lsqSize;
+  int winSize;
+  int nActive; // running threads this cycle
+
+  std::vector<ThreadUse> use;
+  std::vector<int> fetchOrder;
+
   GStatsHist fetchDist;
+  GStatsCntr **threadStall; // [context*MaxStall + cause]
+  GStatsCntr **partStall;   // stalls because of the partition
 #ifdef TASKSCALAR
   GStatsAvg fetchFromSafe;
   GStatsAvg fetchFromSpec;
@@ -69,6 +95,12 @@ private:
 
   Fetch *findFetch(Pid_t pid) const;
 
+  int fetchKey(int t) const;
+  void sortFetchFlows();
+  int nRunning() const;
+  bool overLimit(int t, int used, int total) const;
+  StallCause checkPartition(DInst *dinst);
+
   void selectFetchFlow();
   void selectDecodeFlow();
   void selectIssueFlow();
@@ -77,6 +109,7 @@ protected:
   // BEGIN VIRTUAL FUNCTIONS of GProcessor
   DInst **getRAT(const int contextId);
   FetchEngine *currentFlow();
+  CPICause frontEndStall();
 
   void saveThreadContext(Pid_t pid);
   void loadThreadContext(Pid_t pid);
@@ -104,6 +137,7 @@ protected:
   void advanceClock();
 
   StallCause addInst(DInst *dinst);
+  int addBundle(IBucket *bucket, int n, StallCause &sc);
 
   // END VIRTUAL FUNCTIONS of GProcessor
 
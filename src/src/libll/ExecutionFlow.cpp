@@ -24,12 +24,15 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "OSSim.h"
 #include "ExecutionFlow.h"
+#include "StackDist.h"
 #include "DInst.h"
 #include "Events.h"
 #include "GMemoryOS.h"
 #include "TraceGen.h"
+#include "HostProf.h"
 #include "GMemorySystem.h"
 #include "MemRequest.h"
+#include "MemSampler.h"
 
 #if (defined TM)
 #include "transReport.h"
@@ -72,11 +75,17 @@ ExecutionFlow::ExecutionFlow(int cId, int i, GMemorySystem *gmem)
 #endif // else of (defined MIPS_EMUL)
 
   pendingDInst = 0;
+
+  memSampler      = gmem->getMemSampler();
+  samplerWindow   = 0;
+  samplerSkipping = false;
 }
 
 #if !(defined MIPS_EMUL)
 int ExecutionFlow::exeInst(void)
 {
+  HOSTPROF_SCOPE(HP_ExeInst);
+
   // Instruction address
   int iAddr = picodePC->addr;
   // Instruction flags
@@ -158,6 +167,9 @@ int ExecutionFlow::exeInst(void)
     
     // Put the Real data address in the thread structure
     thread.setRAddr(dAddrR);
+
+    if (stackDist)
+      stackDist->access(dAddrV);
   }
 
   do{
@@ -199,6 +211,8 @@ int ExecutionFlow::exeInst(void)
 
 void ExecutionFlow::exeInstFast()
 {
+  HOSTPROF_SCOPE(HP_ExeInstFast);
+
   I(goingRabbit);
 #if (defined MIPS_EMUL)
   I(!trainCache); // Not supported yet
@@ -235,6 +249,11 @@ void ExecutionFlow::exeInstFast()
     thread.setRAddr(thread.virt2real(vaddr, iFlags));
     if (trainCache)
       CBMemRequest::create(0, trainCache, MemRead, vaddr, 0);
+    else if (samplerSkipping) {
+      int paddr = gms->getMemoryOS()->TLBTranslate(vaddr);
+      if (paddr != -1)
+        memSampler->doFunctional(gms->getDataSource(), paddr, iFlags & E_WRITE, 0);
+    }
 
 #ifdef TS_PROFILING
     if (osSim->enoughMarks1()) {
@@ -377,7 +396,10 @@ DInst *ExecutionFlow::executePC()
   ThreadContext *thread=context;
   InstDesc *iDesc=thread->getIDesc();
   //    printf("S @0x%lx\n",iDesc->addr);
-  iDesc=(*iDesc)(thread);
+  {
+    HOSTPROF_SCOPE(HP_ExeInst);
+    iDesc=(*iDesc)(thread);
+  }
   if(!iDesc)
     return 0;
   VAddr vaddr=thread->getDAddr();
@@ -415,6 +437,14 @@ DInst *ExecutionFlow::executePC()
     return dinst;
   }
 
+#if !(defined TLS) && !(defined TASKSCALAR)
+  if (memSampler && memSampler->newInst(samplerWindow)) {
+    goFunctional(memSampler->getSkip());
+    if (thread.getPid() == -1)
+      return 0;
+  }
+#endif
+
 #if (defined TLS)
   tls::Epoch *epoch=thread.getEpoch();
   I(epoch);
@@ -528,33 +558,7 @@ DInst *ExecutionFlow::executePC()
     {
       if(dinst->getTmcode() == transNT)
       {
-        int dinstInstType = (int)dinst->getOpcode();
-        switch(dinstInstType){
-          case iALU:
-          case iMult:
-          case iDiv:
-            dinst->transType = transInt;
-            break;
-          case iBJ:
-            dinst->transType = transBJ;
-            break;
-          case iLoad:
-            dinst->transType = transLoad;
-            break;
-          case iStore:
-            dinst->transType = transStore;
-            break;
-          case fpALU:
-          case fpMult:
-          case fpDiv:
-            dinst->transType = transFp;
-            break;
-          case iFence:
-            dinst->transType = transFence;
-            break;
-          default:
-            dinst->transType = transOther;
-        }
+        dinst->transType = dinst->getInst()->getTransType();
       }
       else  // if it has already been assigned (e.g. Begin/Abort/Commit)
       {
@@ -1078,6 +1082,50 @@ void ExecutionFlow::goRabbitMode(long long n2skip)
   goingRabbit = false;
 }
 
+#if !(defined MIPS_EMUL) && !(defined TLS) && !(defined TASKSCALAR)
+void ExecutionFlow::goFunctional(long long n)
+{
+  // Same as rabbit mode, but for n instructions and the data references
+  // keep the caches warm (MemSampler skip mode)
+  I(!goingRabbit);
+  I(memSampler);
+
+  trainCache = 0; // the clock can not advance now
+  memSampler->beginSkip();
+  goingRabbit     = true;
+  samplerSkipping = true;
+
+  long long i;
+  for(i = 0; i < n; i++) {
+    ev = NoEvent;
+    exeInstFast();
+
+    if(thread.getPid() == -1)
+      break;
+
+    if (ev == FastSimBeginEvent || ev == FastSimEndEvent)
+      continue;
+
+    if (ev) {
+      if (evCB)
+        evCB->call();
+      else{
+        // they go through the memory backend, atomic in fast mode
+        I(ev == ReleaseEvent ||
+          ev == AcquireEvent ||
+          ev == MemFenceEvent||
+          ev == FetchOpEvent );
+      }
+    }
+  }
+
+  ev = NoEvent;
+  goingRabbit     = false;
+  samplerSkipping = false;
+  memSampler->endSkip(i);
+}
+#endif
+
 #if !(defined MIPS_EMUL)
 icode_ptr ExecutionFlow::getInstructionPointer(void)
 {
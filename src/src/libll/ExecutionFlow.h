@@ -45,6 +45,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 class GMemoryOS;
 class GMemorySystem;
 class MemObj;
+class MemSampler;
 
 class ExecutionFlow : public GFlow {
 private:
@@ -72,6 +73,13 @@ private:
 
   DInst *pendingDInst;
 
+  // Sampled memory hierarchy of the core (0 if not used). In skip mode
+  // the flow fast forwards after each detailed window (goFunctional). TM
+  // builds reject skip (MemSampler), goFunctional ignores transactions
+  MemSampler *memSampler;
+  Time_t samplerWindow;
+  bool   samplerSkipping;
+
 #ifdef TASKSCALAR
   const HVersion *restartVer;
   void propagateDepsIfNeeded() {
@@ -97,6 +105,10 @@ private:
 
   void exeInstFast();
 
+#if !(defined MIPS_EMUL) && !(defined TLS) && !(defined TASKSCALAR)
+  void goFunctional(long long n);
+#endif
+
 #if !(defined MIPS_EMUL)
   // Executes a single instruction. Return value:
   //   If no instruction could be executed, returns 0 (zero)
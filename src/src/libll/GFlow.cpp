@@ -24,10 +24,12 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "MemObj.h"
 #include "GMemoryOS.h"
 #include "GMemorySystem.h"
+#include "StackDist.h"
 
 long long GFlow::nExec  = 0;
 bool GFlow::goingRabbit = true; // Until everything boots, it is in running mode
 MemObj *GFlow::trainCache = 0;
+std::map<int, StackDist *> GFlow::stackDists;
 
 GFlow::GFlow(int i, int cId, GMemorySystem *gmem) 
   : fid(i), 
@@ -38,6 +40,17 @@ GFlow::GFlow(int i, int cId, GMemorySystem *gmem)
 
   //gproc = osSim->id2GProcessor(cpuId);
 
+  stackDist = 0;
+  if (SescConf->checkCharPtr("cpucore","stackDist", cId)) {
+    if (stackDists.find(cId) == stackDists.end()) {
+      const char *cpuSection = SescConf->getCharPtr("", "cpucore", cId);
+      const char *sdSection  = SescConf->getCharPtr(cpuSection, "stackDist");
+
+      stackDists[cId] = new StackDist(sdSection, "P(%d)_%s", cId, sdSection);
+    }
+    stackDist = stackDists[cId];
+  }
+
   if (trainCache == 0) {
     if (SescConf->checkCharPtr("cpucore","trainCache", cId)) {
       const char *cpuSection = SescConf->getCharPtr("", "cpucore", cId);
@@ -23,6 +23,8 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #ifndef GFLOW_H
 #define GFLOW_H
 
+#include <map>
+
 #include "nanassert.h"
 #include "Events.h"
 #include "callback.h"
@@ -33,6 +35,7 @@ class GProcessor;
 class GMemorySystem;
 class GMemoryOS;
 class MemObj;
+class StackDist;
 
 class GFlow {
  private:
@@ -42,6 +45,11 @@ class GFlow {
 
   static MemObj *trainCache;
 
+  // stack distance profiler of the core (stackDist in the cpucore
+  // section), shared by all its flows
+  static std::map<int, StackDist *> stackDists;
+  StackDist *stackDist;
+
   const int fid;
   const int cpuId;
 
@@ -238,6 +238,9 @@ public:
   static const Instruction *getRSTInstByPC(unsigned int addr, uint rawInst);
 #endif
 
+  // Static descriptor read from a SESC trace (SescTrace.cpp)
+  static const Instruction *getSescInstByPC(unsigned int addr, const unsigned char *def);
+
 #ifdef SESC_SIMICS
   // this is what should be called by TraceFlow in simics mode
   static const Instruction *getSimicsInst(TraceSimicsOpc_t op) {
@@ -367,6 +370,35 @@ public:
   InstType getOpcode() const { return opcode;  }
   InstSubType getSubCode() const { return subCode;  }
 
+#if (defined TM)
+  // Type of the instruction inside a transaction
+  transInstType getTransType() const {
+    if (tmcode != transNT)
+      return tmcode; // Begin/Commit/Abort
+
+    switch(opcode) {
+    case iALU:
+    case iMult:
+    case iDiv:
+      return transInt;
+    case iBJ:
+      return transBJ;
+    case iLoad:
+      return transLoad;
+    case iStore:
+      return transStore;
+    case fpALU:
+    case fpMult:
+    case fpDiv:
+      return transFp;
+    case iFence:
+      return transFence;
+    default:
+      return transOther;
+    }
+  }
+#endif
+
   bool isNOP() const { return subCode == iNop;  }
 
   // Get the name of a given opcode
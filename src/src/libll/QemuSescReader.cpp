@@ -38,9 +38,9 @@ QemuSescReader::QemuSescReader() {
 
 void QemuSescReader::openTrace(const char *filename) {
 
-  trace = fopen(filename, "rb");
+  trace = TraceInput::openFile(filename);
 
-  if (trace == NULL){
+  if (trace == 0){
     MSG("QemuSescReader::Can't open the trace file [%s].", filename); 
     exit(-1);
   }
@@ -56,7 +56,8 @@ void QemuSescReader::openTrace(const char *filename) {
 }
 
 void QemuSescReader::closeTrace() {
-  fclose(trace);
+  delete trace;
+  trace = 0;
 }
 
 void QemuSescReader::advancePC() {
@@ -71,25 +72,13 @@ void QemuSescReader::advancePC() {
 
 void QemuSescReader::readInst() { 
 
-  if (fread(qst, sizeof(QemuSescTrace), 1, trace) !=1){
-    MSG("Size of each structure is %lu", sizeof(qst));
-    if (feof(trace))
-      tracEof = true;
-    else {
-      MSG("QemuSescReader: Error while reading TraceFile");
-      exit(1);
-    }
-  } 
+  if (trace->read(qst, sizeof(QemuSescTrace)) != sizeof(QemuSescTrace)) {
+    tracEof = true;
+    PC = 0xffffffff;
+    return;
+  }
 
   PC = qst->pc;
-
-  MSG("PC 0x%x r%d <- r%d %u r%d",PC, qst->dest, qst->src1, qst->opc, qst->src2);
-
-  if (feof(trace)) {
-    tracEof = true; 
-    closeTrace();
-  }
-      
 }
 
 void QemuSescReader::fillTraceEntry(TraceEntry *te, int id) {
@@ -30,10 +30,11 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "TraceEntry.h"
 #include "TraceReader.h"
 #include "QemuSescTrace.h"
+#include "TraceInput.h"
 
 class QemuSescReader : public TraceReader {
  private:
-  FILE* trace;
+  TraceInput *trace;
   unsigned int  PC;
   
   bool tracEof;
@@ -31,6 +31,30 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "rstf.h"
 #include "Rstzip.h"
 
+// rstzip3 decompression, runs in the TraceInput reader thread
+class RstzipSource : public TraceSource {
+ private:
+  Rstzip *rz;
+ public:
+  RstzipSource(Rstzip *r) : rz(r) {}
+
+  size_t fill(void *buf, size_t size) {
+    int n = size / sizeof(rstf_unionT);
+    if (n == 0)
+      return 0;
+    return rz->decompress(static_cast<rstf_unionT *>(buf), n) * sizeof(rstf_unionT);
+  }
+};
+
+void RSTReader::fillBuffer() {
+  I(buf_pos == buf_end);
+
+  buf_end = in->read(buf, sizeof(rstf_unionT)*Max_Num_Recs) / sizeof(rstf_unionT);
+  buf_pos = 0;
+  if (buf_end == 0)
+    end_of_trace = true;
+}
+
 void RSTReader::addInstruction(const rstf_unionT *rp) {
 
   int fid       = rstf_instrT_get_cpuid(&(rp->instr));
@@ -100,14 +124,7 @@ void RSTReader::advancePC(int fid) {
       return;
     }
 
-    // Fill Buffer
-    I(buf_pos == buf_end);
-
-    buf_end = rz->decompress(buf, Max_Num_Recs);
-    buf_pos = 0;
-    if (buf_end == 0) {
-      end_of_trace = true;
-    }
+    fillBuffer();
   }
 }
 
@@ -118,6 +135,7 @@ RSTReader::RSTReader()
   buf = (rstf_unionT *)malloc(sizeof(rstf_unionT)*Max_Num_Recs);
   buf_pos = 0;
   buf_end = 0;
+  in      = 0;
 
   int nProcs = SescConf->getRecordSize("","cpucore");
   nFlows = 0;
@@ -136,13 +154,33 @@ RSTReader::RSTReader()
 
 void RSTReader::openTrace(const char *filename) {
 
+  // Indexed rz3 traces (rstzip3 "indexed=1") can be decompressed by
+  // several threads, and started at any record (sampling)
+  int nThreads = 1;
+  if (SescConf->checkInt("", "rstThreads")) {
+    SescConf->isBetween("", "rstThreads", 1, 64);
+    nThreads = SescConf->getInt("", "rstThreads");
+  }
+  char opts[64];
+  sprintf(opts, "verbose=0 threads=%d", nThreads);
+
   rz = new Rstzip;
-  int rv=rz->open(filename, "r", "verbose=0");
+  int rv=rz->open(filename, "r", opts);
   if (rv != RSTZIP_OK) {
     MSG("ERROR: RSTReader::openTrace(%s) error opening input trace", filename);
     exit(1);
   }
 
+  if (SescConf->checkDouble("", "rstStart")) {
+    double start = SescConf->getDouble("", "rstStart");
+    if (start > 0 && rz->seek((uint64_t)start) != RSTZIP_OK) {
+      MSG("ERROR: RSTReader::openTrace(%s) can not start at record %.0f", filename, start);
+      exit(1);
+    }
+  }
+
+  in = TraceInput::create(new RstzipSource(rz));
+
   end_of_trace = false;
 
   while(!end_of_trace) {
@@ -180,17 +218,14 @@ void RSTReader::openTrace(const char *filename) {
       return; // one instruction added :)
     }
 
-    // Fill Buffer
-    I(buf_pos == buf_end);
-
-    buf_end = rz->decompress(buf, Max_Num_Recs);
-    buf_pos = 0;
-    if (buf_end == 0)
-      end_of_trace = true;
+    fillBuffer();
   }
 }
 
 void RSTReader::closeTrace() {
+  delete in; // stops the reader thread before rz goes away
+  in = 0;
+
   rz->close();
   delete rz;
 }
@@ -28,6 +28,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "DInst.h"
 #include "rstf.h"
 #include "Rstzip.h"
+#include "TraceInput.h"
 
 class RSTReader {
  private:
@@ -35,6 +36,7 @@ class RSTReader {
   const int Max_Head_Size;
 
   Rstzip *rz;
+  TraceInput *in; // decompresses rz ahead of the simulation
   
   int nFlows;
   DInst *head;
@@ -49,6 +51,7 @@ class RSTReader {
   void addInstruction(const rstf_unionT *rp);
 
   void advancePC(int fid);
+  void fillBuffer();
 
  public:
   RSTReader();
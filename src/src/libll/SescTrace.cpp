@@ -0,0 +1,496 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2004 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "SescConf.h"
+#include "SescTrace.h"
+
+static const char  STMagic[4] = { 'S', 'S', 'T', 'R' };
+static const uchar STVersion  = 1;
+
+static void put32(unsigned char *p, uint v)
+{
+  p[0] = (unsigned char)v;
+  p[1] = (unsigned char)(v >> 8);
+  p[2] = (unsigned char)(v >> 16);
+  p[3] = (unsigned char)(v >> 24);
+}
+
+static uint get32(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint)p[3] << 24);
+}
+
+/*****************************************
+ * SescTraceWriter
+ */
+
+std::vector<SescTraceWriter *> SescTraceWriter::writers;
+
+SescTraceWriter::SescTraceWriter(const char *fname)
+{
+  fd = fopen(fname, "w");
+  if (fd == 0) {
+    MSG("SescTraceWriter: could not create [%s]", fname);
+    exit(-3);
+  }
+
+  fwrite(STMagic, 1, sizeof(STMagic), fd);
+  fwrite(&STVersion, 1, 1, fd);
+
+  int kb = 256;
+  if (SescConf->checkInt("", "sescTraceBlock")) {
+    SescConf->isBetween("", "sescTraceBlock", 1, 64*1024);
+    kb = SescConf->getInt("", "sescTraceBlock");
+  }
+
+  rawSize = kb*1024;
+  zSize   = compressBound(rawSize);
+  raw     = (unsigned char *)malloc(rawSize);
+  zbuf    = (unsigned char *)malloc(zSize);
+  rawPos  = 0;
+
+  lastPC    = 0;
+  lastDAddr = 0;
+
+  tmPid    = 0;
+  tmTid    = 0;
+  tmBCFlag = -1;
+
+  nInsts = 0;
+  nBytes = sizeof(STMagic) + 1;
+
+  writers.push_back(this);
+}
+
+SescTraceWriter::~SescTraceWriter()
+{
+  close();
+
+  free(raw);
+  free(zbuf);
+}
+
+void SescTraceWriter::close()
+{
+  if (fd == 0)
+    return;
+
+  flush();
+  fclose(fd);
+  fd = 0;
+
+  MSG("SescTraceWriter: %lld instructions, %lld bytes (%.2f bytes/inst)"
+      ,nInsts, nBytes, nInsts ? (double)nBytes/nInsts : 0);
+
+  for(size_t i = 0; i < writers.size(); i++) {
+    if (writers[i] == this) {
+      writers.erase(writers.begin() + i);
+      break;
+    }
+  }
+}
+
+void SescTraceWriter::closeAll()
+{
+  while(!writers.empty())
+    writers.back()->close();
+}
+
+void SescTraceWriter::flush()
+{
+  if (rawPos == 0)
+    return;
+
+  uLongf zLen = zSize;
+  if (compress2(zbuf, &zLen, raw, rawPos, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    MSG("SescTraceWriter: compression failed");
+    exit(-3);
+  }
+
+  unsigned char hdr[8];
+  put32(hdr, rawPos);
+  put32(hdr + 4, zLen);
+  fwrite(hdr, 1, sizeof(hdr), fd);
+  fwrite(zbuf, 1, zLen, fd);
+
+  nBytes += sizeof(hdr) + zLen;
+  rawPos  = 0;
+}
+
+VAddr SescTraceWriter::getPC(InstID id)
+{
+#if ((defined TRACE_DRIVEN)||(defined MIPS_EMUL)||(defined QEMU_DRIVEN))
+  return id;
+#else
+  InstID evBase = Instruction::getEventID(NoEvent);
+  if (id >= evBase)
+    return EventPC + 4*(id - evBase);
+
+  return Instruction::getInst(id)->getAddr();
+#endif
+}
+
+void SescTraceWriter::define(VAddr pc, const Instruction *inst)
+{
+  defined.insert(pc);
+
+  int skip = inst->calcNextInstID() - inst->currentID();
+#if ((defined TRACE_DRIVEN)||(defined MIPS_EMUL)||(defined QEMU_DRIVEN))
+  skip /= 4; // InstIDs are addresses
+#endif
+
+  uchar flags  = 0;
+  uchar tmcode = 0;
+  if (inst->guessAsTaken())
+    flags |= DefGuessTaken;
+  if (inst->isBJLikely())
+    flags |= DefCondLikely;
+  if (inst->doesJump2Label())
+    flags |= DefJumpLabel;
+#if (defined TM)
+  if (inst->tmcode != transNT) {
+    flags |= DefTmcode;
+    tmcode = inst->tmcode;
+  }
+#endif
+
+  raw[rawPos++] = KindDef;
+  put(pc);
+  raw[rawPos++] = inst->getOpcode();
+  raw[rawPos++] = inst->getSubCode();
+  raw[rawPos++] = inst->getDataSize();
+  raw[rawPos++] = inst->getSrc1();
+  raw[rawPos++] = inst->getSrc2();
+  raw[rawPos++] = inst->getDest();
+  raw[rawPos++] = skip;
+  raw[rawPos++] = flags;
+  raw[rawPos++] = tmcode;
+}
+
+void SescTraceWriter::record(const Instruction *inst, VAddr dAddr, InstID nextID
+                             ,bool inTrans, int tPid, int tTid, int tBCFlag)
+{
+  // PreEvent/PostEvent call back into MINT, they can not be replayed
+  if (inst->getOpcode() == iEvent)
+    return;
+
+  if (rawPos + 3*MaxRecord > rawSize)
+    flush();
+
+  VAddr pc = getPC(inst->currentID());
+  if (defined.find(pc) == defined.end())
+    define(pc, inst);
+
+#if (defined TM)
+  if (inTrans) {
+    if (inst->tmcode == transNT)
+      tBCFlag = tmBCFlag; // Only Begin/Commit/Abort carry the flag
+
+    if (tPid != tmPid || tTid != tmTid || tBCFlag != tmBCFlag) {
+      raw[rawPos++] = KindMark | (MarkTrans << 2);
+      put(tPid);
+      put(tTid);
+      put(zigzag(tBCFlag));
+      tmPid    = tPid;
+      tmTid    = tTid;
+      tmBCFlag = tBCFlag;
+    }
+  }
+#endif
+
+  unsigned char *h = &raw[rawPos++];
+  *h = KindInst;
+
+  if (pc != lastPC + 4) {
+    *h |= InstJumpPC;
+    put(zigzag(pc - (lastPC + 4)));
+  }
+
+  VAddr next = getPC(nextID);
+  if (next != pc + 4) {
+    *h |= InstJumpNext;
+    put(zigzag(next - (pc + 4)));
+  }
+
+  if (dAddr) {
+    *h |= InstMem;
+    put(zigzag(dAddr - lastDAddr));
+    lastDAddr = dAddr;
+  }
+
+  if (inTrans)
+    *h |= InstTrans;
+
+  lastPC = pc;
+  nInsts++;
+}
+
+/*****************************************
+ * SescTraceReader
+ */
+
+SescTraceReader::Stream::Stream(TraceInput *i)
+  : in(i)
+{
+  raw      = 0;
+  zbuf     = 0;
+  rawAlloc = 0;
+  zAlloc   = 0;
+  pos      = 0;
+  end      = 0;
+
+  lastPC    = 0;
+  lastDAddr = 0;
+
+  tmPid    = 0;
+  tmTid    = 0;
+  tmBCFlag = -1;
+}
+
+SescTraceReader::Stream::~Stream()
+{
+  delete in;
+  free(raw);
+  free(zbuf);
+}
+
+bool SescTraceReader::Stream::nextBlock()
+{
+  unsigned char hdr[8];
+  if (in == 0 || in->read(hdr, sizeof(hdr)) != sizeof(hdr))
+    return false;
+
+  uLongf rawLen = get32(hdr);
+  size_t zLen   = get32(hdr + 4);
+
+  if (rawLen > rawAlloc) {
+    rawAlloc = rawLen;
+    raw = (unsigned char *)realloc(raw, rawAlloc);
+  }
+  if (zLen > zAlloc) {
+    zAlloc = zLen;
+    zbuf = (unsigned char *)realloc(zbuf, zAlloc);
+  }
+
+  if (in->read(zbuf, zLen) != zLen
+      || uncompress(raw, &rawLen, zbuf, zLen) != Z_OK) {
+    MSG("SescTraceReader: corrupted trace block");
+    exit(-3);
+  }
+
+  pos = raw;
+  end = raw + rawLen;
+
+  return true;
+}
+
+SescTraceReader::SescTraceReader()
+{
+  basename = 0;
+}
+
+SescTraceReader::~SescTraceReader()
+{
+  closeTrace();
+}
+
+void SescTraceReader::openTrace(const char *bname)
+{
+  basename = strdup(bname);
+
+  // Flow 0 must exist, the others are opened when they start
+  getStream(0);
+}
+
+void SescTraceReader::closeTrace()
+{
+  for(size_t i = 0; i < streams.size(); i++)
+    delete streams[i];
+  streams.clear();
+
+  free(basename);
+  basename = 0;
+}
+
+SescTraceReader::Stream *SescTraceReader::getStream(int id)
+{
+  if (id < (int)streams.size() && streams[id])
+    return streams[id];
+
+  if (id >= (int)streams.size())
+    streams.resize(id+1, 0);
+
+  char *fname = (char *)malloc(strlen(basename) + 16);
+  sprintf(fname, "%s.%d", basename, id);
+
+  TraceInput *in = TraceInput::openFile(fname);
+  if (in) {
+    char  magic[4];
+    uchar version = 0;
+    if (in->read(magic, sizeof(magic)) != sizeof(magic)
+        || memcmp(magic, STMagic, sizeof(magic)) != 0
+        || in->read(&version, 1) != 1
+        || version != STVersion) {
+      MSG("SescTraceReader: [%s] is not a SESC trace", fname);
+      exit(-3);
+    }
+  }else if (id == 0) {
+    MSG("SescTraceReader: could not open [%s]", fname);
+    exit(-3);
+  }else{
+    MSG("SescTraceReader: no trace for flow %d [%s]", id, fname);
+  }
+  free(fname);
+
+  streams[id] = new Stream(in);
+  return streams[id];
+}
+
+int SescTraceReader::fillTraceEntries(TraceEntry *te, int n, int id)
+{
+  Stream *s = getStream(id);
+
+  const unsigned char *p = s->pos;
+  int i = 0;
+  while(i < n) {
+    if (p == s->end) {
+      if (!s->nextBlock()) {
+        te[i].eot = true;
+        s->pos = p;
+        return i+1;
+      }
+      p = s->pos;
+    }
+
+    uchar h = *p++;
+    switch(h & KindMask) {
+    case KindInst:
+      {
+        TraceEntry &e = te[i++];
+
+        VAddr pc = s->lastPC + 4;
+        if (h & InstJumpPC)
+          pc += unzigzag(get(p, s->end, id));
+
+        e.iAddr     = pc;
+        e.nextIAddr = pc + 4;
+        if (h & InstJumpNext)
+          e.nextIAddr += unzigzag(get(p, s->end, id));
+
+        e.dAddr = 0;
+        if (h & InstMem) {
+          s->lastDAddr += unzigzag(get(p, s->end, id));
+          e.dAddr = s->lastDAddr;
+        }
+
+        e.inTrans     = (h & InstTrans) != 0;
+        e.transPid    = s->tmPid;
+        e.transTid    = s->tmTid;
+        e.transBCFlag = s->tmBCFlag;
+        e.eot         = false;
+
+        s->lastPC = pc;
+      }
+      break;
+
+    case KindDef:
+      {
+        VAddr pc = get(p, s->end, id);
+        if (p + DefSize > s->end)
+          corrupted(id);
+        Instruction::getSescInstByPC(pc, p);
+        p += DefSize;
+      }
+      break;
+
+    case KindMark:
+      if ((h >> 2) == MarkTrans) {
+        s->tmPid    = get(p, s->end, id);
+        s->tmTid    = get(p, s->end, id);
+        s->tmBCFlag = unzigzag(get(p, s->end, id));
+        break;
+      }
+      // fall through
+
+    default:
+      MSG("SescTraceReader: corrupted trace record 0x%x (flow %d)", h, id);
+      exit(-3);
+    }
+  }
+
+  s->pos = p;
+  return n;
+}
+
+void SescTraceReader::corrupted(int id)
+{
+  MSG("SescTraceReader: truncated trace record (flow %d)", id);
+  exit(-3);
+}
+
+/*****************************************
+ * Instruction
+ */
+
+const Instruction *Instruction::getSescInstByPC(unsigned int addr, const unsigned char *def)
+{
+  // Each flow defines the instructions it uses
+  InstHash::iterator it = instHash.find(addr);
+  if (it != instHash.end())
+    return it->second;
+
+  Instruction *inst = new Instruction();
+
+  inst->opcode   = static_cast<InstType>(def[0]);
+  inst->subCode  = static_cast<InstSubType>(def[1]);
+  inst->dataSize = def[2];
+
+  inst->src1 = static_cast<RegType>(def[3]);
+  inst->src2 = static_cast<RegType>(def[4]);
+  inst->dest = static_cast<RegType>(def[5]);
+  inst->src1Pool = whichPool(inst->src1);
+  inst->src2Pool = whichPool(inst->src2);
+  inst->dstPool  = whichPool(inst->dest);
+
+#if ((defined TRACE_DRIVEN)||(defined MIPS_EMUL)||(defined QEMU_DRIVEN))
+  inst->skipDelay = 4*def[6];
+#else
+  inst->skipDelay = def[6];
+#endif
+
+  uchar flags = def[7];
+  inst->guessTaken = (flags & SescTraceFormat::DefGuessTaken) != 0;
+  inst->condLikely = (flags & SescTraceFormat::DefCondLikely) != 0;
+  inst->jumpLabel  = (flags & SescTraceFormat::DefJumpLabel)  != 0;
+#if (defined TM)
+  inst->tmcode = (flags & SescTraceFormat::DefTmcode) ? static_cast<transInstType>(def[8]) : transNT;
+#endif
+
+  // Events are not replayed, fences are plain iFence
+  inst->uEvent = NoEvent;
+
+  inst->addr     = addr;
+  instHash[addr] = inst;
+
+  return inst;
+}
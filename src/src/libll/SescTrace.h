@@ -0,0 +1,216 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2004 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+/* Native SESC instruction trace
+ *
+ * Recording: sescTraceFile = "name" in the root section. Each
+ * FetchEngine writes the correct path instructions it fetches to
+ * name.<fetch id> (any build, MINT included).
+ *
+ * Replay: a TRACE_DRIVEN build with traceMode = "sesc" and the trace
+ * base name as the second argument. The trace describes its own static
+ * instructions, no binary or decoder is needed, and TraceFlow batches
+ * the entries (canBatch).
+ *
+ * File format: "SSTR" and a version byte, then blocks of
+ *   raw length, compressed length (4 bytes each, little endian)
+ *   zlib data
+ * A block holds whole records. Root sescTraceBlock (KB, default 256)
+ * sets the raw block size.
+ *
+ * Each record starts with a byte, low 2 bits are the kind:
+ *   Inst: bit 2 PC is not the previous PC+4, zigzag delta follows
+ *         bit 3 next PC is not PC+4, zigzag delta from PC+4 follows
+ *         bit 4 data address, zigzag delta from the previous one follows
+ *         bit 5 inside a transaction
+ *   Def:  first time a PC appears. PC, then opcode, subCode, dataSize,
+ *         src1, src2, dest, instructions to skip (delay slot), flags
+ *         (guessTaken, condLikely, jumpLabel, has tmcode) and tmcode
+ *   Mark: bits 2-7 subtype. MarkTrans changes the transaction state
+ *         (pid, tid, zigzag begin/commit flag)
+ * Integers are 7 bits per byte, low bits first. The deltas are 32 bit.
+ */
+
+#ifndef SESCTRACE_H
+#define SESCTRACE_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "estl.h"
+#include "nanassert.h"
+#include "Instruction.h"
+#include "TraceReader.h"
+#include "TraceInput.h"
+
+class SescTraceFormat {
+ public:
+  enum {
+    KindInst  = 0,
+    KindDef   = 1,
+    KindMark  = 2,
+    KindMask  = 3,
+
+    InstJumpPC   = 0x04,
+    InstJumpNext = 0x08,
+    InstMem      = 0x10,
+    InstTrans    = 0x20,
+
+    MarkTrans = 1,
+
+    DefGuessTaken = 0x01,
+    DefCondLikely = 0x02,
+    DefJumpLabel  = 0x04,
+    DefTmcode     = 0x08,
+
+    DefSize   = 9,  // bytes after the PC
+    MaxRecord = 16, // Inst, Def or Mark (a recorded instruction may need all three)
+
+    // Events (fences, fetch&op) have no PC, they use EventPC+4*ev
+    EventPC   = 0xfffff000
+  };
+
+  static uint zigzag(int v) {
+    return (uint)(v << 1) ^ (uint)(v >> 31);
+  }
+  static int unzigzag(uint v) {
+    return (int)(v >> 1) ^ -(int)(v & 1);
+  }
+};
+
+class SescTraceWriter : public SescTraceFormat {
+private:
+  typedef HASH_SET<VAddr> PCSet;
+
+  // Open writers, closed by closeAll at the end of the simulation
+  static std::vector<SescTraceWriter *> writers;
+
+  FILE *fd;
+
+  unsigned char *raw;
+  unsigned char *zbuf;
+  size_t rawSize;
+  size_t zSize;
+  size_t rawPos;
+
+  PCSet defined;
+
+  VAddr lastPC;
+  VAddr lastDAddr;
+
+  int tmPid;
+  int tmTid;
+  int tmBCFlag;
+
+  long long nInsts;
+  long long nBytes;
+
+  void flush();
+
+  void put(uint v) {
+    while(v >= 0x80) {
+      raw[rawPos++] = (unsigned char)(v | 0x80);
+      v >>= 7;
+    }
+    raw[rawPos++] = (unsigned char)v;
+  }
+
+  static VAddr getPC(InstID id);
+  void define(VAddr pc, const Instruction *inst);
+
+public:
+  SescTraceWriter(const char *fname);
+  ~SescTraceWriter();
+
+  void close();
+
+  // The simulation ends with exit(), FetchEngines are not destroyed
+  static void closeAll();
+
+  // Correct path instruction. inTrans and the transaction fields are
+  // only meaningful in TM builds
+  void record(const Instruction *inst, VAddr dAddr, InstID nextID
+              ,bool inTrans=false, int tPid=0, int tTid=0, int tBCFlag=-1);
+};
+
+class SescTraceReader : public TraceReader, public SescTraceFormat {
+private:
+  class Stream {
+  public:
+    TraceInput *in;
+
+    unsigned char *raw;
+    unsigned char *zbuf;
+    size_t rawAlloc;
+    size_t zAlloc;
+    const unsigned char *pos;
+    const unsigned char *end;
+
+    VAddr lastPC;
+    VAddr lastDAddr;
+
+    int  tmPid;
+    int  tmTid;
+    int  tmBCFlag;
+
+    Stream(TraceInput *i);
+    ~Stream();
+
+    bool nextBlock();
+  };
+
+  char *basename;
+  std::vector<Stream *> streams;
+
+  Stream *getStream(int id);
+
+  static void corrupted(int id);
+
+  // Records never span blocks, running into end means a corrupted block
+  static uint get(const unsigned char *&p, const unsigned char *end, int id) {
+    uint v = 0;
+    int shift = 0;
+    while(p < end && (*p & 0x80)) {
+      v |= ((uint)(*p & 0x7f)) << shift;
+      shift += 7;
+      p++;
+    }
+    if (p >= end || shift > 28)
+      corrupted(id);
+    v |= ((uint)*p) << shift;
+    p++;
+    return v;
+  }
+
+public:
+  SescTraceReader();
+  ~SescTraceReader();
+
+  void openTrace(const char *basename);
+  void closeTrace();
+
+  void fillTraceEntry(TraceEntry *te, int id) {
+    fillTraceEntries(te, 1, id);
+  }
+  int fillTraceEntries(TraceEntry *te, int n, int id);
+
+  bool canBatch() const { return true; }
+};
+
+#endif // SESCTRACE_H
@@ -43,9 +43,9 @@ void TT6Reader::openTrace(const char* basename) {
 
   strcpy(filename, basename);
   strcat(filename, "/thread_001.tt6");
-  trace = fopen(filename, "r");
+  trace = TraceInput::openFile(filename);
 
-  if (trace == NULL){
+  if (trace == 0){
     MSG("TT6Reader::Can't open the trace file."); 
     exit(-1);
   }
@@ -61,7 +61,8 @@ void TT6Reader::openTrace(const char* basename) {
 }
 
 void TT6Reader::closeTrace(){
-  fclose(trace);
+  delete trace;
+  trace = 0;
 }
 
 void TT6Reader::advancePC() {
@@ -95,47 +96,23 @@ void TT6Reader::advancePC() {
 }
 
 void TT6Reader::readPC() { 
-  if (fread(&PC, sizeof(PC), 1, trace) != 1)
-    if (feof(trace))
-      tracEof=true;
-    else{
-      MSG("Error while reading the trace file.");
-      exit(1);
-    }
-  //MSG("TT6Reader: readPC() currentPC = %08x", (unsigned int) PC);
+  if (trace->read(&PC, sizeof(PC)) != sizeof(PC))
+    tracEof = true;
 }
 
 void TT6Reader::readInst() { 
-        
-  if (fread(&inst, sizeof(inst), 1,trace)!=1)
-    if (feof(trace))
-      tracEof=true;             
-    else{
-      MSG("Error while reading the trace file.");
-      exit(1);
-    }
-        
+  if (trace->read(&inst, sizeof(inst)) != sizeof(inst))
+    tracEof = true;
 }
 
 void TT6Reader::readAddress() { 
-        
-  if (fread(&address, sizeof(address), 1,trace)!=1)             
-    if (feof(trace))
-      tracEof=true;             
-    else{
-      MSG("Error while reading the trace file.");
-      exit(1);
-    }
+  if (trace->read(&address, sizeof(address)) != sizeof(address))
+    tracEof = true;
 }
 
 void TT6Reader::readCount() { 
-  if (fread(&count, sizeof(count), 1,trace)!=1) 
-    if (feof(trace))
-      tracEof=true;             
-    else{
-      MSG("Error while reading the trace file.");
-      exit(1);
-    }
+  if (trace->read(&count, sizeof(count)) != sizeof(count))
+    tracEof = true;
 }
 
 void TT6Reader::fillTraceEntry(TraceEntry *te, int id) {
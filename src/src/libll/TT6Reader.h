@@ -30,10 +30,11 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "minidecoder.h"
 #include "TraceEntry.h"
 #include "TraceReader.h"
+#include "TraceInput.h"
 
 class TT6Reader : public TraceReader {
  private:
-  FILE* trace;
+  TraceInput *trace;
   VAddr PC;
   uint inst;
   VAddr address;
@@ -67,6 +68,8 @@ class TT6Reader : public TraceReader {
   void closeTrace();
 
   void fillTraceEntry(TraceEntry *te, int id);
+
+  bool canBatch() const { return true; }
 };
 
 #endif
@@ -27,6 +27,7 @@
 #if (defined TM)
 #include "transReport.h"
 #include "transCoherence.h"
+#include "transConfig.h"
 #endif
 
 #if defined(STAT_COMMON)
@@ -155,11 +156,11 @@ ThreadContext *ThreadContext::newActual(void)
   context->abortCount=0;
   context->tmTid = 0;
   ID(
-      context->tmDebug = SescConf->getInt("TransactionalMemory","tmDebugMode");
-      context->tmDebugTrace = SescConf->getInt("TransactionalMemory","memDebugTrace");    
+      context->tmDebug = tmConfig->tmDebugMode;
+      context->tmDebugTrace = tmConfig->memDebugTrace;    
     )
-  if(SescConf->getInt("TransactionalMemory","limitAborts")){
-    context->tmAbortMax = SescConf->getInt("TransactionalMemory","maxAborts");
+  if(tmConfig->limitAborts){
+    context->tmAbortMax = tmConfig->maxAborts;
   }
   else{
     context->tmAbortMax = -1;
@@ -191,11 +192,11 @@ ThreadContext *ThreadContext::newActual(Pid_t pid)
   context->abortCount=0;
   context->tmTid = 0;
   ID(
-     context->tmDebug = SescConf->getInt("TransactionalMemory","tmDebugMode");
-     context->tmDebugTrace = SescConf->getInt("TransactionalMemory","memDebugTrace");
+     context->tmDebug = tmConfig->tmDebugMode;
+     context->tmDebugTrace = tmConfig->memDebugTrace;
     )
-  if(SescConf->getInt("TransactionalMemory","limitAborts")){
-    context->tmAbortMax = SescConf->getInt("TransactionalMemory","maxAborts");
+  if(tmConfig->limitAborts){
+    context->tmAbortMax = tmConfig->maxAborts;
   }
   else{
     context->tmAbortMax = -1;
@@ -226,11 +227,11 @@ ThreadContext *ThreadContext::newCloned(void)
   context->abortCount=0;
   context->tmTid = 0;
   ID(
-      context->tmDebug = SescConf->getInt("TransactionalMemory","tmDebugMode");
-      context->tmDebugTrace = SescConf->getInt("TransactionalMemory","memDebugTrace");    
+      context->tmDebug = tmConfig->tmDebugMode;
+      context->tmDebugTrace = tmConfig->memDebugTrace;    
     )
-  if(SescConf->getInt("TransactionalMemory","limitAborts")){
-    context->tmAbortMax = SescConf->getInt("TransactionalMemory","maxAborts");
+  if(tmConfig->limitAborts){
+    context->tmAbortMax = tmConfig->maxAborts;
   }
   else{
     context->tmAbortMax = -1;
@@ -521,7 +522,7 @@ void ThreadContext::init()
 #endif
 
 #if defined(PROFILE)
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    if(statConf->return_enableProfiling() == 1)
    {
       if(threadID >= Profiling::globalStatistics.threadCharacteristics.size())
@@ -532,7 +533,6 @@ void ThreadContext::init()
             Profiling::globalStatistics.threadCharacteristics.resize(threadID + 1);
       }
    }
-   delete statConf;
 #endif
 
   /* map in the global errno */
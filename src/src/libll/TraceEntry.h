@@ -46,6 +46,12 @@ class TraceEntry {
   bool eot;
   
   bool contextSwitch;
+
+  // Transaction state (SESC traces)
+  bool inTrans;
+  int  transPid;
+  int  transTid;
+  int  transBCFlag;
   
   TraceEntry() {
     rawInst   = 0;
@@ -59,6 +65,11 @@ class TraceEntry {
 
     eot           = false;
     contextSwitch = false;
+
+    inTrans     = false;
+    transPid    = 0;
+    transTid    = 0;
+    transBCFlag = -1;
   }
 };
 
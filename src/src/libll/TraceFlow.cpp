@@ -25,6 +25,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "SescConf.h"
 #include "TT6Reader.h"
 #include "QemuSescReader.h"
+#include "SescTrace.h"
 #ifdef SESC_SIMICS
 #include "SimicsReader.h"
 #endif
@@ -54,6 +55,10 @@ TraceFlow::TraceFlow(int cId, int i, GMemorySystem *gms)
       trace = new QemuSescReader(); 
     }
     mode = QemuSpTrace;
+  } else if(strcmp(traceMode, "sesc") == 0) {
+    if (createReader)
+      trace = new SescTraceReader();
+    mode = SescTrace;
   } else if(strcmp(traceMode, "simics") == 0) {
 
 #ifdef SESC_SIMICS
@@ -78,6 +83,10 @@ TraceFlow::TraceFlow(int cId, int i, GMemorySystem *gms)
   nextPC     = 0;
   hasTrace   = true;
 
+  batch    = trace->canBatch() ? new TraceEntry[BatchSize] : 0;
+  batchPos = 0;
+  batchLen = 0;
+
   delayDInst        = 0;
   swappingDelaySlot = false;
 }
@@ -85,9 +94,19 @@ TraceFlow::TraceFlow(int cId, int i, GMemorySystem *gms)
 DInst *TraceFlow::executePC() 
 { 
   I(hasTrace);
-  static TraceEntry te; // static for speed, otherwise constructor is called every time
+  static TraceEntry ste; // static for speed, otherwise constructor is called every time
 
-  trace->fillTraceEntry(&te, fid);
+  TraceEntry *tep = &ste;
+  if (batch) {
+    if (batchPos == batchLen) {
+      batchLen = trace->fillTraceEntries(batch, BatchSize, fid);
+      batchPos = 0;
+    }
+    tep = &batch[batchPos++];
+  }else{
+    trace->fillTraceEntry(&ste, fid);
+  }
+  const TraceEntry &te = *tep;
         
   if(te.eot) { // end of trace
     hasTrace = false; // FIXME: remove 
@@ -115,6 +134,12 @@ DInst *TraceFlow::executePC()
 #endif
       break;
 
+    case SescTrace:
+      // The reader registers the instructions before their first use
+      MSG("TraceFlow: instruction 0x%x not defined in the trace", te.iAddr);
+      exit(-5);
+      break;
+
     default:
       I(0);
     }
@@ -131,6 +156,19 @@ DInst *TraceFlow::executePC()
 #endif
                             );
 
+#if (defined TM)
+  if (mode == SescTrace) {
+    dinst->transBCFlag = -1;
+    if (te.inTrans || inst->tmcode != transNT) {
+      dinst->transType = inst->getTransType();
+      if (inst->tmcode != transNT)
+        dinst->transBCFlag = te.transBCFlag;
+      dinst->transPid = te.transPid;
+      dinst->transTid = te.transTid;
+    }
+  }
+#endif
+
   return dinst;
 }
 
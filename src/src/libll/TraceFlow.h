@@ -34,7 +34,8 @@ class MemObj;
 enum TraceMode {
   PPCTT6Trace = 0,
   SimicsTrace,
-  QemuSpTrace
+  QemuSpTrace,
+  SescTrace
 };
 
 class TraceFlow : public GFlow {
@@ -50,6 +51,12 @@ class TraceFlow : public GFlow {
   static char *traceFile;
 
   TraceMode mode;
+
+  // Entries decoded ahead (readers with canBatch)
+  enum { BatchSize = 64 };
+  TraceEntry *batch;
+  int batchPos;
+  int batchLen;
   
  protected:
  public:
@@ -0,0 +1,236 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2004 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SescConf.h"
+#include "TraceInput.h"
+
+size_t FileTraceSource::fill(void *buf, size_t size)
+{
+  return fread(buf, 1, size, fd);
+}
+
+TraceInput::TraceInput(TraceSource *s, size_t bsize, bool useAsync)
+  : src(s)
+  ,map(0)
+  ,mapSize(0)
+  ,mapPos(0)
+{
+  init(bsize, useAsync);
+}
+
+TraceInput::TraceInput(const unsigned char *m, size_t size)
+  : src(0)
+  ,map(m)
+  ,mapSize(size)
+  ,mapPos(0)
+{
+  init(0, false);
+}
+
+void TraceInput::init(size_t bsize, bool useAsync)
+{
+  blockSize = bsize;
+  async     = useAsync;
+  stop      = false;
+  eot       = false;
+
+  for(int i = 0; i < 2; i++) {
+    block[i]     = bsize ? (unsigned char *)malloc(bsize) : 0;
+    blockLen[i]  = 0;
+    blockFull[i] = false;
+  }
+
+  // The reader fills block 0 first. Block 1 looks full and empty, the
+  // first read releases it and waits for block 0
+  cur          = 1;
+  pos          = 0;
+  blockFull[1] = true;
+
+  if (!async)
+    return;
+
+  pthread_mutex_init(&mutex, 0);
+  pthread_cond_init(&cond, 0);
+  if (pthread_create(&reader, 0, readerThread, this) != 0) {
+    MSG("TraceInput: could not create the reader thread, reading synchronously");
+    async = false;
+  }
+}
+
+TraceInput::~TraceInput()
+{
+  if (async) {
+    pthread_mutex_lock(&mutex);
+    stop = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(reader, 0);
+    pthread_mutex_destroy(&mutex);
+    pthread_cond_destroy(&cond);
+  }
+
+  if (map)
+    munmap((void *)map, mapSize);
+
+  delete src;
+  free(block[0]);
+  free(block[1]);
+}
+
+void *TraceInput::readerThread(void *arg)
+{
+  static_cast<TraceInput *>(arg)->fillBlocks();
+  return 0;
+}
+
+void TraceInput::fillBlocks()
+{
+  int b = 0;
+  while(1) {
+    pthread_mutex_lock(&mutex);
+    while(blockFull[b] && !stop)
+      pthread_cond_wait(&cond, &mutex);
+    bool done = stop;
+    pthread_mutex_unlock(&mutex);
+    if (done)
+      return;
+
+    size_t n = 0;
+    while(n < blockSize) {
+      size_t r = src->fill(block[b] + n, blockSize - n);
+      if (r == 0)
+        break;
+      n += r;
+    }
+
+    pthread_mutex_lock(&mutex);
+    blockLen[b]  = n;
+    blockFull[b] = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+
+    if (n == 0)
+      return; // end of trace
+    b ^= 1;
+  }
+}
+
+bool TraceInput::nextBlock()
+{
+  if (async) {
+    pthread_mutex_lock(&mutex);
+    blockFull[cur] = false;
+    pthread_cond_broadcast(&cond);
+    cur ^= 1;
+    while(!blockFull[cur])
+      pthread_cond_wait(&cond, &mutex);
+    pthread_mutex_unlock(&mutex);
+  }else{
+    cur ^= 1;
+    size_t n = 0;
+    while(n < blockSize) {
+      size_t r = src->fill(block[cur] + n, blockSize - n);
+      if (r == 0)
+        break;
+      n += r;
+    }
+    blockLen[cur] = n;
+  }
+
+  pos = 0;
+  if (blockLen[cur] == 0)
+    eot = true;
+
+  return !eot;
+}
+
+size_t TraceInput::readSlow(void *dst, size_t n)
+{
+  unsigned char *d = static_cast<unsigned char *>(dst);
+  size_t done = 0;
+
+  while(done < n) {
+    size_t left = blockLen[cur] - pos;
+    if (left == 0) {
+      if (eot || !nextBlock())
+        break;
+      continue;
+    }
+
+    size_t c = n - done < left ? n - done : left;
+    memcpy(d + done, block[cur] + pos, c);
+    pos  += c;
+    done += c;
+  }
+
+  return done;
+}
+
+TraceInput *TraceInput::create(TraceSource *s)
+{
+  bool useAsync = true;
+  if (SescConf->checkBool("", "traceAsync"))
+    useAsync = SescConf->getBool("", "traceAsync");
+
+  int kb = 1024;
+  if (SescConf->checkInt("", "traceBlockSize")) {
+    SescConf->isGT("", "traceBlockSize", 0);
+    kb = SescConf->getInt("", "traceBlockSize");
+  }
+
+  return new TraceInput(s, kb*1024, useAsync);
+}
+
+TraceInput *TraceInput::openFile(const char *fname)
+{
+  bool useMmap = false;
+  if (SescConf->checkBool("", "traceMmap"))
+    useMmap = SescConf->getBool("", "traceMmap");
+
+  if (useMmap) {
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0)
+      return 0;
+
+    struct stat st;
+    void *m = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+      m = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (m != MAP_FAILED) {
+      madvise(m, st.st_size, MADV_SEQUENTIAL);
+      return new TraceInput(static_cast<const unsigned char *>(m), st.st_size);
+    }
+    MSG("TraceInput: could not map [%s], reading it", fname);
+  }
+
+  FILE *f = fopen(fname, "rb");
+  if (f == 0)
+    return 0;
+
+  return create(new FileTraceSource(f));
+}
@@ -0,0 +1,129 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2004 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+/* Common input layer of the trace readers
+ *
+ * The readers used to fread each field of each trace entry (TT6, QEMU),
+ * or to decompress small rstzip3 chunks (RST) on the simulation
+ * thread. TraceInput reads large blocks from a TraceSource into two
+ * buffers. With traceAsync (default true) a reader thread fills one
+ * buffer while the simulation consumes the other. With traceMmap the
+ * uncompressed traces are mapped instead, and there is no copy or
+ * thread at all.
+ *
+ * Root section options:
+ *  traceAsync     = true   background reader thread
+ *  traceMmap      = false  map uncompressed trace files
+ *  traceBlockSize = 1024   KB per buffer
+ */
+
+#ifndef TRACEINPUT_H
+#define TRACEINPUT_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nanassert.h"
+
+class TraceSource {
+ public:
+  virtual ~TraceSource() {}
+
+  // Called from the reader thread. Up to size bytes, 0 at the end
+  virtual size_t fill(void *buf, size_t size) = 0;
+};
+
+class FileTraceSource : public TraceSource {
+ private:
+  FILE *fd;
+ public:
+  FileTraceSource(FILE *f) : fd(f) {}
+  ~FileTraceSource() { fclose(fd); }
+
+  size_t fill(void *buf, size_t size);
+};
+
+class TraceInput {
+ private:
+  TraceSource *src;
+
+  // mmap mode
+  const unsigned char *map;
+  size_t mapSize;
+  size_t mapPos;
+
+  // buffered mode
+  size_t blockSize;
+  unsigned char *block[2];
+  size_t blockLen[2];
+  bool   blockFull[2];  // filled, not consumed yet
+  int    cur;           // block being consumed
+  size_t pos;
+  bool   eot;
+
+  bool async;
+  bool stop;
+  pthread_t       reader;
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+
+  static void *readerThread(void *arg);
+  void fillBlocks();
+
+  bool nextBlock();
+  size_t readSlow(void *dst, size_t n);
+
+  void init(size_t bsize, bool useAsync);
+
+ public:
+  // Takes ownership of the source
+  TraceInput(TraceSource *s, size_t bsize, bool useAsync);
+  TraceInput(const unsigned char *m, size_t size);
+  ~TraceInput();
+
+  // Open a file with the traceAsync, traceMmap and traceBlockSize
+  // options. 0 if the file can not be opened
+  static TraceInput *openFile(const char *fname);
+
+  // Same for any other source (compressed traces)
+  static TraceInput *create(TraceSource *s);
+
+  // Like fread: the bytes copied, less than n only at the end of trace
+  size_t read(void *dst, size_t n) {
+    if (map) {
+      size_t left = mapSize - mapPos;
+      if (n > left)
+        n = left;
+      memcpy(dst, map + mapPos, n);
+      mapPos += n;
+      return n;
+    }
+
+    if (blockLen[cur] - pos >= n) {
+      memcpy(dst, block[cur] + pos, n);
+      pos += n;
+      return n;
+    }
+
+    return readSlow(dst, n);
+  }
+};
+
+#endif // TRACEINPUT_H
@@ -40,6 +40,23 @@ class TraceReader {
 
   virtual void fillTraceEntry(TraceEntry *te, int id) = 0;
 
+  // Readers whose entries depend only on the trace file can fill
+  // several entries ahead of the simulation (TraceFlow batches)
+  virtual bool canBatch() const { return false; }
+
+  // Up to n entries, stops after the end of trace entry (eot). Returns
+  // the number of entries filled
+  virtual int fillTraceEntries(TraceEntry *te, int n, int id) {
+    for(int i = 0; i < n; i++) {
+      te[i].eot   = false;
+      te[i].dAddr = 0;
+      fillTraceEntry(&te[i], id);
+      if (te[i].eot)
+        return i+1;
+    }
+    return n;
+  }
+
   virtual bool hasBufferedEntries(int id=-1) { return false; }
 };
 
@@ -509,6 +509,7 @@ Cache::Line *Cache::allocateLine(PAddr addr, CallbackBase *cb)
   lineFill.inc();
 
   if(l == 0) {
+    pendAlloc.insert(getCacheBank(addr)->calcTag(addr));
     doAllocateLineRetryCB::scheduleAbs(globalClock + 100, this, addr, cb);
     return 0;
   }
@@ -572,6 +573,8 @@ void Cache::doAllocateLine(PAddr addr, PAddr rpl_addr, CallbackBase *cb)
 
 void Cache::doAllocateLineRetry(PAddr addr, CallbackBase *cb)
 {
+  pendAlloc.erase(getCacheBank(addr)->calcTag(addr));
+
   Line *l = allocateLine(addr, cb);
   if(l) 
     cb->call();
@@ -602,6 +605,92 @@ bool Cache::canAcceptLoad(PAddr addr)
   return canAcceptReq;
 }
 
+int Cache::ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst)
+{
+  // a hit must refresh the LRU order, like a detailed access
+  Line *l = getCacheBank(addr)->readLine(addr);
+  if (l && l->isValid()) {
+    if (write && !l->isLocked())
+      ffWrite(l, addr);
+    return 0;
+  }
+
+  if (l == 0 && !pendAlloc.empty()
+      && pendAlloc.find(getCacheBank(addr)->calcTag(addr)) != pendAlloc.end())
+    return 0; // a detailed miss is allocating it
+
+  int lev = 1;
+  if (!lowerLevel.empty())
+    lev += lowerLevel[0]->ffAccess(addr, write, this, dinst);
+
+  if (l == 0) {
+    PAddr rpl_addr = 0;
+    l = getCacheBank(addr)->fillLine(addr, rpl_addr);
+    if (l == 0)
+      return lev; // all locked, do not keep it
+
+    if (l->isValid()) {
+      // same as allocateLine
+      bool dirty = l->isDirty();
+      if (!isHighestLevel() && inclusiveCache && ffInvUpperLevel(rpl_addr))
+        dirty = true;
+      if (dirty && !lowerLevel.empty())
+        lowerLevel[0]->ffWriteBack(rpl_addr);
+    }
+    l->makeClean();
+  }
+
+  if (!l->isLocked()) {
+    l->validate();
+    if (write)
+      ffWrite(l, addr);
+  }
+
+  return lev;
+}
+
+void Cache::ffWriteBack(PAddr addr)
+{
+  Line *l = getCacheBank(addr)->findLineNoEffect(addr);
+  if (l && l->isValid() && !l->isLocked()) {
+    ffWrite(l, addr);
+    return;
+  }
+
+  MemObj::ffWriteBack(addr);
+}
+
+bool Cache::ffInvalidate(PAddr addr)
+{
+  bool dirty = false;
+  if (inclusiveCache)
+    dirty = ffInvUpperLevel(addr);
+
+  Line *l = getCacheBank(addr)->findLineNoEffect(addr);
+  if (l == 0 || !l->isValid() || l->isLocked())
+    return dirty;
+
+  if (l->isDirty()) {
+    dirty = true;
+    l->makeClean();
+  }
+  l->invalidate();
+
+  return dirty;
+}
+
+int Cache::ffLevel(PAddr addr)
+{
+  Line *l = getCacheBank(addr)->findLineNoEffect(addr);
+  if (l && l->isValid())
+    return 0;
+
+  if (lowerLevel.empty())
+    return 1;
+
+  return 1 + lowerLevel[0]->ffLevel(addr);
+}
+
 bool Cache::isInCache(PAddr addr) const
 {
   unsigned int index = getCacheBank(addr)->calcIndex4Addr(addr);
@@ -901,6 +990,12 @@ void WTCache::doWriteBack(PAddr addr)
   // nothing to do
 }
 
+void WTCache::ffWrite(Line *l, PAddr addr)
+{
+  // writes always go down
+  MemObj::ffWriteBack(addr);
+}
+
 void WTCache::pushLine(MemRequest *mreq)
 {
   I(0); // should never be called
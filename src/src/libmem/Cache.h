@@ -159,6 +159,9 @@ protected:
 
   PendInvTable pendInvTable; // pending invalidate table
 
+  // lines that wait for a free way (doAllocateLineRetry)
+  HASH_SET<PAddr> pendAlloc;
+
   PortGeneric *cachePort;
   PortGeneric **bankPorts;
   PortGeneric **mshrPorts;
@@ -252,6 +255,9 @@ protected:
   virtual void doWriteBack(PAddr addr) = 0;
   virtual void inclusionCheck(PAddr addr) { }
 
+  // functional write to a line of the cache
+  virtual void ffWrite(Line *l, PAddr addr) { l->makeDirty(); }
+
   typedef CallbackMember1<Cache, MemRequest *, &Cache::doReadBank> 
     doReadBankCB;
 
@@ -302,6 +308,15 @@ public:
   
   bool isInCache(PAddr addr) const;
 
+  // Functional access (MemObj::ffAccess). Replaced dirty lines are
+  // written back functionally, inclusive caches invalidate the upper
+  // levels. Locked lines and lines waiting to be allocated are left
+  // to the detailed requests
+  int  ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst);
+  int  ffLevel(PAddr addr);
+  void ffWriteBack(PAddr addr);
+  bool ffInvalidate(PAddr addr);
+
   // same as above plus schedule callback to doInvalidate
   void invalidate(PAddr addr, ushort size, MemObj *oc);
   void doInvalidate(PAddr addr, ushort size);
@@ -342,6 +357,7 @@ protected:
   void doWrite(MemRequest *mreq);
   void sendMiss(MemRequest *mreq);
   void doWriteBack(PAddr addr);
+  void ffWrite(Line *l, PAddr addr);
   void writePropagateHandler(MemRequest *mreq);
   void propagateDown(MemRequest *mreq);
   void reexecuteDoWrite(MemRequest *mreq);
@@ -400,6 +416,10 @@ public:
   void pushLine(MemRequest *mreq);
   void returnAccess(MemRequest *mreq);
   void specialOp(MemRequest *mreq);
+
+  int ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst) { return 0; }
+  void ffWriteBack(PAddr addr) { }
+  int ffLevel(PAddr addr) { return 0; }
 };
 
 
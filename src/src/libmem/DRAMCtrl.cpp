@@ -0,0 +1,358 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "SescConf.h"
+#include "Snippets.h"
+#include "DInst.h"
+#include "DRAMCtrl.h"
+
+DRAMCtrl::DRAMCtrl(MemorySystem* current, const char *section,
+                   const char *name)
+  : MemObj(section, name)
+  ,readReqs("%s:readReqs", name)
+  ,writeReqs("%s:writeReqs", name)
+  ,rowHit("%s:rowHit", name)
+  ,rowMiss("%s:rowMiss", name)
+  ,rowConflict("%s:rowConflict", name)
+  ,turnaround("%s:turnaround", name)
+  ,nRefresh("%s:nRefresh", name)
+  ,nBatches("%s:nBatches", name)
+  ,rowHitRate("%s:rowHitRate", name)
+  ,queueDelay("%s:queueDelay", name)
+  ,readLatency("%s:readLatency", name)
+  ,queueDelayHist("%s:queueDelayHist", name)
+  ,maxQueue("%s:maxQueue", name)
+{
+  SescConf->isPower2(section, "numBanks");
+  SescConf->isPower2(section, "rowSize");
+  SescConf->isInt(section, "delay");
+  SescConf->isInt(section, "tRCD");
+  SescConf->isInt(section, "tCAS");
+  SescConf->isInt(section, "tRP");
+  SescConf->isGT(section, "tBurst", 0);
+
+  numBanks     = SescConf->getInt(section, "numBanks");
+  log2RowSize  = log2i(SescConf->getInt(section, "rowSize"));
+
+  delay  = SescConf->getInt(section, "delay");
+  tRCD   = SescConf->getInt(section, "tRCD");
+  tCAS   = SescConf->getInt(section, "tCAS");
+  tRP    = SescConf->getInt(section, "tRP");
+  tBurst = SescConf->getInt(section, "tBurst");
+
+  tWTR = SescConf->checkInt(section, "tWTR") ? SescConf->getInt(section, "tWTR") : 0;
+  tRTW = SescConf->checkInt(section, "tRTW") ? SescConf->getInt(section, "tRTW") : 0;
+
+  tREFI = 0;
+  tRFC  = 0;
+  if (SescConf->checkInt(section, "tREFI")) {
+    tREFI = SescConf->getInt(section, "tREFI");
+    tRFC  = SescConf->getInt(section, "tRFC");
+    SescConf->isBetween(section, "tRFC", 0, tREFI);
+  }
+
+  writeHigh = 32;
+  if (SescConf->checkInt(section, "writeHigh")) {
+    SescConf->isGT(section, "writeHigh", 1);
+    writeHigh = SescConf->getInt(section, "writeHigh");
+  }
+  batchCap = 5;
+  if (SescConf->checkInt(section, "batchCap")) {
+    SescConf->isGT(section, "batchCap", 0);
+    batchCap = SescConf->getInt(section, "batchCap");
+  }
+  histBucket = 50;
+  if (SescConf->checkInt(section, "histBucket")) {
+    SescConf->isGT(section, "histBucket", 0);
+    histBucket = SescConf->getInt(section, "histBucket");
+  }
+  maxSources = SescConf->getRecordSize("", "cpucore");
+
+  policy = FRFCFS;
+  if (SescConf->checkCharPtr(section, "scheduler")) {
+    const char *sched = SescConf->getCharPtr(section, "scheduler");
+    if (strcasecmp(sched, "FCFS") == 0) {
+      policy = FCFS;
+    } else if (strcasecmp(sched, "FRFCFS") == 0) {
+      policy = FRFCFS;
+    } else if (strcasecmp(sched, "PARBS") == 0) {
+      policy = PARBS;
+    } else {
+      MSG("DRAMCtrl:unknown scheduler [%s] (FCFS, FRFCFS or PARBS)", sched);
+      SescConf->notCorrect();
+    }
+  }
+
+  banks.resize(numBanks);
+  for(int i = 0; i < numBanks; i++) {
+    banks[i].openRow       = -1;
+    banks[i].refreshEpoch  = 0;
+    banks[i].freeAt        = 0;
+    banks[i].wakeupPending = false;
+  }
+
+  busFreeAt    = 0;
+  busWrite     = false;
+  nextRefresh  = tREFI;
+  refreshEnd   = 0;
+  refreshEpoch = 0;
+  nWrites      = 0;
+  drainWrites  = false;
+  nMarked      = 0;
+  srcMarked.resize(maxSources);
+  for(int i = 0; i < maxSources; i++)
+    srcMarked[i] = 0;
+}
+
+void DRAMCtrl::access(MemRequest *mreq)
+{
+  MemOperation memOp = mreq->getMemOperation();
+
+  if (memOp == MemPush) {
+    // posted write, the data stays in the controller queue
+    writeReqs.inc();
+    enqueue(mreq, true);
+    mreq->goUp(0);
+    return;
+  }
+
+  if (memOp != MemRead && memOp != MemReadW && memOp != MemWrite) {
+    mreq->goUp(1);
+    return;
+  }
+
+  readReqs.inc();
+  enqueue(mreq, false);
+}
+
+void DRAMCtrl::enqueue(MemRequest *mreq, bool isWrite)
+{
+  PAddr addr = mreq->getPAddr();
+
+  DRAMReq r;
+  r.mreq    = isWrite ? 0 : mreq;
+  r.row     = calcRow(addr);
+  r.arrival = globalClock;
+  r.isWrite = isWrite;
+  r.marked  = false;
+  r.source  = 0;
+  if (mreq->getDInst())
+    r.source = mreq->getDInst()->getContextId() % maxSources;
+
+  if (isWrite) {
+    nWrites++;
+    if (nWrites >= writeHigh)
+      drainWrites = true;
+  }
+
+  int b = calcBank(addr);
+  DRAMBank &bank = banks[b];
+  bank.queue.push_back(r);
+  maxQueue.sample(bank.queue.size());
+
+  // let the requests of this cycle arrive before scheduling
+  wakeup(b, bank.freeAt > globalClock ? bank.freeAt : globalClock + 1);
+}
+
+void DRAMCtrl::wakeup(int b, Time_t when)
+{
+  if (banks[b].wakeupPending)
+    return;
+
+  banks[b].wakeupPending = true;
+  issueCB::scheduleAbs(when, this, b);
+}
+
+void DRAMCtrl::markBatch()
+{
+  I(nMarked == 0);
+
+  std::vector<int> cnt(maxSources);
+
+  for(int b = 0; b < numBanks; b++) {
+    for(int i = 0; i < maxSources; i++)
+      cnt[i] = 0;
+
+    ReqQueue &q = banks[b].queue;
+    for(ReqQueue::iterator it = q.begin(); it != q.end(); it++) {
+      if (cnt[it->source] >= batchCap)
+        continue;
+      cnt[it->source]++;
+      it->marked = true;
+      srcMarked[it->source]++;
+      nMarked++;
+    }
+  }
+
+  if (nMarked)
+    nBatches.inc();
+}
+
+bool DRAMCtrl::better(const DRAMBank &bank, const DRAMReq &a, const DRAMReq &b) const
+{
+  // true if a should be issued before b. The queue is in arrival
+  // order, so ties keep the oldest
+  if (policy == FCFS)
+    return false;
+
+  if (policy == PARBS && a.marked != b.marked)
+    return a.marked;
+
+  // reads first unless the write queue is being drained
+  if (a.isWrite != b.isWrite)
+    return a.isWrite == drainWrites;
+
+  bool open = bank.openRow >= 0 && bank.refreshEpoch == refreshEpoch;
+  bool aHit = open && a.row == bank.openRow;
+  bool bHit = open && b.row == bank.openRow;
+  if (aHit != bHit)
+    return aHit;
+
+  // PAR-BS ranking: shortest job (fewer marked requests) first
+  if (policy == PARBS && srcMarked[a.source] != srcMarked[b.source])
+    return srcMarked[a.source] < srcMarked[b.source];
+
+  return false;
+}
+
+int DRAMCtrl::pickRequest(const DRAMBank &bank) const
+{
+  const ReqQueue &q = bank.queue;
+
+  int best = 0;
+  for(size_t i = 1; i < q.size(); i++) {
+    if (better(bank, q[i], q[best]))
+      best = i;
+  }
+
+  return best;
+}
+
+void DRAMCtrl::issue(int b)
+{
+  DRAMBank &bank = banks[b];
+  bank.wakeupPending = false;
+
+  if (bank.queue.empty())
+    return;
+
+  if (bank.freeAt > globalClock) {
+    wakeup(b, bank.freeAt);
+    return;
+  }
+
+  // all bank refresh, done lazily
+  if (tREFI) {
+    while (globalClock >= nextRefresh) {
+      refreshEnd   = nextRefresh + tRFC;
+      nextRefresh += tREFI;
+      refreshEpoch++;
+      nRefresh.inc();
+    }
+    if (globalClock < refreshEnd) {
+      wakeup(b, refreshEnd);
+      return;
+    }
+  }
+
+  if (policy == PARBS && nMarked == 0)
+    markBatch();
+
+  int pos = pickRequest(bank);
+  DRAMReq r = bank.queue[pos];
+  bank.queue.erase(bank.queue.begin() + pos);
+
+  if (r.marked) {
+    srcMarked[r.source]--;
+    nMarked--;
+  }
+
+  if (r.isWrite) {
+    nWrites--;
+    if (drainWrites && nWrites <= writeHigh/2)
+      drainWrites = false;
+  }
+
+  // row buffer
+  Time_t colAt = globalClock;
+  bool open = bank.openRow >= 0 && bank.refreshEpoch == refreshEpoch;
+  if (open && bank.openRow == r.row) {
+    rowHit.inc();
+    rowHitRate.sample(100);
+  } else if (open) {
+    rowConflict.inc();
+    rowHitRate.sample(0);
+    colAt += tRP + tRCD;
+  } else {
+    rowMiss.inc();
+    rowHitRate.sample(0);
+    colAt += tRCD;
+  }
+  bank.openRow      = r.row;
+  bank.refreshEpoch = refreshEpoch;
+
+  // data bus, shared by all the banks
+  Time_t dataAt = colAt + tCAS;
+  Time_t busAt  = busFreeAt;
+  if (r.isWrite != busWrite) {
+    turnaround.inc();
+    busAt += r.isWrite ? tRTW : tWTR;
+  }
+  if (dataAt < busAt)
+    dataAt = busAt;
+
+  busFreeAt = dataAt + tBurst;
+  busWrite  = r.isWrite;
+
+  // next column command once this burst is out
+  bank.freeAt = dataAt + tBurst - tCAS;
+
+  int qDelay = static_cast<int>(globalClock - r.arrival);
+  queueDelay.sample(qDelay);
+  queueDelayHist.sample(qDelay / histBucket);
+
+  if (r.mreq) {
+    Time_t when = busFreeAt + delay;
+    readLatency.sample(when - r.arrival);
+    r.mreq->goUpAbs(when);
+  }
+
+  if (!bank.queue.empty())
+    wakeup(b, bank.freeAt > globalClock ? bank.freeAt : globalClock + 1);
+}
+
+void DRAMCtrl::returnAccess(MemRequest *mreq)
+{
+  I(0); // last level
+}
+
+Time_t DRAMCtrl::getNextFreeCycle() const
+{
+  return globalClock;
+}
+
+void DRAMCtrl::invalidate(PAddr addr, ushort size, MemObj *oc)
+{
+  invUpperLevel(addr, size, oc);
+}
+
+bool DRAMCtrl::canAcceptStore(PAddr addr)
+{
+  return true;
+}
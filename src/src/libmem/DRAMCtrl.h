@@ -0,0 +1,159 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef DRAMCTRL_H
+#define DRAMCTRL_H
+
+#include <deque>
+#include <vector>
+
+#include "nanassert.h"
+#include "callback.h"
+#include "GStats.h"
+#include "MemRequest.h"
+#include "MemObj.h"
+#include "MemorySystem.h"
+
+// DRAM controller (deviceType = 'dramctrl'). Last level of the memory
+// hierarchy, it replaces the niceCache/memctrl at the bottom.
+//
+// Each bank has its own request queue and keeps its row open after an
+// access (open-row policy). When a bank is free, the scheduler picks the
+// next request of its queue:
+//
+//  FCFS   : oldest request
+//  FRFCFS : oldest row hit, otherwise oldest request
+//  PARBS  : requests are grouped in batches (up to batchCap per source
+//           and bank). Marked requests go first, then row hits, then
+//           the sources with fewer marked requests, then the oldest
+//
+// Reads have priority over writes until the number of queued writes
+// reaches writeHigh; then writes are drained down to writeHigh/2.
+// Writes (MemPush) are posted: they are acknowledged on arrival. The
+// data bus is shared by all the banks, and a change of direction costs
+// tWTR (write to read) or tRTW (read to write) cycles. Every tREFI
+// cycles all the banks are refreshed during tRFC and the rows closed.
+//
+// All the timing parameters are in processor cycles.
+class DRAMCtrl : public MemObj {
+private:
+  enum SchedPolicy { FCFS, FRFCFS, PARBS };
+
+  class DRAMReq {
+  public:
+    MemRequest *mreq; // 0 for writes (already acknowledged)
+    long   row;
+    Time_t arrival;
+    bool   isWrite;
+    bool   marked;
+    int    source;
+  };
+
+  typedef std::deque<DRAMReq> ReqQueue;
+
+  class DRAMBank {
+  public:
+    ReqQueue queue;
+    long     openRow;      // -1 closed
+    int      refreshEpoch; // openRow only valid if equal to DRAMCtrl's
+    Time_t   freeAt;
+    bool     wakeupPending;
+  };
+
+  // Begin Configuration parameters
+  SchedPolicy policy;
+
+  int numBanks;
+  int log2RowSize;
+
+  TimeDelta_t delay;  // controller and channel fix delay
+  TimeDelta_t tRCD;
+  TimeDelta_t tCAS;
+  TimeDelta_t tRP;
+  TimeDelta_t tBurst;
+  TimeDelta_t tWTR;
+  TimeDelta_t tRTW;
+  int tREFI;          // 0 disables refresh
+  int tRFC;
+
+  int writeHigh;
+  int batchCap;
+  int maxSources;
+  int histBucket;
+  // End Configuration parameters
+
+  std::vector<DRAMBank> banks;
+
+  Time_t busFreeAt;
+  bool   busWrite;     // direction of the last data transfer
+
+  Time_t nextRefresh;
+  Time_t refreshEnd;
+  int    refreshEpoch;
+
+  int  nWrites;        // queued writes
+  bool drainWrites;
+
+  int  nMarked;        // PAR-BS requests in the current batch
+  std::vector<int> srcMarked;
+
+  GStatsCntr readReqs;
+  GStatsCntr writeReqs;
+  GStatsCntr rowHit;
+  GStatsCntr rowMiss;     // row closed
+  GStatsCntr rowConflict; // other row open
+  GStatsCntr turnaround;
+  GStatsCntr nRefresh;
+  GStatsCntr nBatches;
+  GStatsAvg  rowHitRate;
+  GStatsAvg  queueDelay;
+  GStatsAvg  readLatency;
+  GStatsHist queueDelayHist;
+  GStatsMax  maxQueue;
+
+  // rows are interleaved across the banks
+  int calcBank(PAddr addr) const {
+    return (addr >> log2RowSize) % numBanks;
+  }
+  long calcRow(PAddr addr) const {
+    return (addr >> log2RowSize) / numBanks;
+  }
+
+  void enqueue(MemRequest *mreq, bool isWrite);
+  void markBatch();
+  int  pickRequest(const DRAMBank &bank) const;
+  bool better(const DRAMBank &bank, const DRAMReq &a, const DRAMReq &b) const;
+  void wakeup(int b, Time_t when);
+
+  void issue(int b);
+  typedef CallbackMember1<DRAMCtrl, int, &DRAMCtrl::issue> issueCB;
+
+public:
+  DRAMCtrl(MemorySystem* current, const char *device_descr_section,
+           const char *device_name=NULL);
+  ~DRAMCtrl() {}
+
+  Time_t getNextFreeCycle() const;
+  void access(MemRequest *mreq);
+  void returnAccess(MemRequest *mreq);
+  void invalidate(PAddr addr, ushort size, MemObj *oc);
+  bool canAcceptStore(PAddr addr);
+};
+
+#endif
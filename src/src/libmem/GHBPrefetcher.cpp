@@ -0,0 +1,118 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "nanassert.h"
+#include "SescConf.h"
+
+#include "MemorySystem.h"
+#include "GHBPrefetcher.h"
+
+GHBPrefetcher::GHBPrefetcher(MemorySystem* current
+                             ,const char *section
+                             ,const char *name)
+  : Prefetcher(current, section, name)
+  ,correlated("%s:correlated", name)
+  ,uncorrelated("%s:uncorrelated", name)
+{
+  ghbSize = 256;
+  if (SescConf->checkInt(section, "ghbSize")) {
+    SescConf->isGT(section, "ghbSize", 2);
+    ghbSize = SescConf->getInt(section, "ghbSize");
+  }
+  int itSize = 256;
+  if (SescConf->checkInt(section, "itSize")) {
+    SescConf->isPower2(section, "itSize");
+    itSize = SescConf->getInt(section, "itSize");
+  }
+  maxHistory = 16;
+  if (SescConf->checkInt(section, "maxHistory")) {
+    SescConf->isGT(section, "maxHistory", 3);
+    maxHistory = SescConf->getInt(section, "maxHistory");
+  }
+
+  itMask       = itSize - 1;
+  log2LineSize = log2i(getLineSize());
+  ghbPos       = 0;
+
+  ghb.resize(ghbSize);
+  itable.resize(itSize);
+  for(int i = 0; i < itSize; i++) {
+    itable[i].key  = 0;
+    itable[i].head = -1;
+  }
+  deltas.reserve(maxHistory);
+}
+
+void GHBPrefetcher::learn(PAddr addr, MemRequest *mreq, bool miss)
+{
+  long long line = addr >> log2LineSize;
+
+  int key = getPC(mreq);
+  if (key == 0)
+    key = (addr >> 12) | 1; // zone
+
+  ITEntry &ite = itable[(key ^ (key >> 10)) & itMask];
+  if (ite.key != key) {
+    ite.key  = key;
+    ite.head = -1;
+  }
+
+  GHBEntry &e = ghb[ghbPos % ghbSize];
+  e.line = line;
+  e.link = inGHB(ite.head) ? ite.head : -1;
+  ite.head = ghbPos;
+  ghbPos++;
+
+  // Deltas of the chain, newest first
+  deltas.clear();
+  long long prev = line;
+  long long pos  = e.link;
+  while(inGHB(pos) && static_cast<int>(deltas.size()) < maxHistory) {
+    const GHBEntry &p = ghb[pos % ghbSize];
+    deltas.push_back(prev - p.line);
+    prev = p.line;
+    pos  = p.link;
+  }
+
+  if (deltas.size() < 3)
+    return;
+
+  // deltas[j],deltas[j+1] matches the last pair, what came after it
+  // (deltas[j-1] .. deltas[0]) is the prediction
+  size_t j;
+  for(j = 1; j + 1 < deltas.size(); j++) {
+    if (deltas[j] == deltas[0] && deltas[j+1] == deltas[1])
+      break;
+  }
+  if (j + 1 >= deltas.size()) {
+    uncorrelated.inc();
+    return;
+  }
+  correlated.inc();
+
+  int n = getDegree();
+  long long pf = line;
+  for(int k = 0; k < n; k++) {
+    long long d = deltas[(j - 1) - (k % j)];
+    pf += d;
+    if (d == 0 || pf <= 0)
+      continue;
+    issuePrefetch(static_cast<PAddr>(pf << log2LineSize));
+  }
+}
@@ -0,0 +1,77 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef GHBPREFETCHER_H
+#define GHBPREFETCHER_H
+
+#include <vector>
+
+#include "Prefetcher.h"
+
+// Global History Buffer prefetcher with PC delta correlation (PC/DC,
+// deviceType = 'ghbpref'). Every access that reaches the prefetcher is
+// pushed in a circular buffer of ghbSize lines, linked with the previous
+// entry of the same instruction through an index table of itSize
+// entries. Requests without instruction are keyed by their 4KB zone.
+//
+// The last two deltas of the chain are searched in its older history
+// (up to maxHistory entries). On a match, the deltas that followed are
+// replayed from the current line, up to degree prefetches.
+class GHBPrefetcher : public Prefetcher {
+private:
+  class GHBEntry {
+  public:
+    long long line;
+    long long link; // absolute position of the previous entry, -1 none
+  };
+
+  class ITEntry {
+  public:
+    int       key;
+    long long head; // absolute position, -1 none
+  };
+
+  std::vector<GHBEntry> ghb;
+  std::vector<ITEntry>  itable;
+  long long ghbPos;   // absolute position of the next entry
+
+  int  ghbSize;
+  int  maxHistory;
+  uint itMask;
+  uint log2LineSize;
+
+  std::vector<long long> deltas;
+
+  GStatsCntr correlated;
+  GStatsCntr uncorrelated;
+
+  bool inGHB(long long pos) const {
+    return pos >= 0 && pos >= ghbPos - ghbSize;
+  }
+
+protected:
+  void learn(PAddr addr, MemRequest *mreq, bool miss);
+
+public:
+  GHBPrefetcher(MemorySystem* current, const char *device_descr_section,
+                const char *device_name = NULL);
+  ~GHBPrefetcher() {}
+};
+
+#endif // GHBPREFETCHER_H
@@ -7,9 +7,12 @@
 #include "Bus.h"
 #include "PriorityBus.h"
 #include "MemCtrl.h"
+#include "DRAMCtrl.h"
 #include "Bank.h"
 #include "StridePrefetcher.h"
 #include "AddressPrefetcher.h"
+#include "StreamPrefetcher.h"
+#include "GHBPrefetcher.h"
 #include "MemoryOS.h"
 #include "MemorySystem.h"
 
@@ -23,9 +26,12 @@
 #define k_memvpred     "memvpred"
 #define k_prefbuff     "prefbuff"
 #define k_addrpref     "addrpref"
+#define k_streampref   "streampref"
+#define k_ghbpref      "ghbpref"
 #define k_bus          "bus"
 #define k_priobus      "prioritybus"
 #define k_memctrl      "memctrl"
+#define k_dramctrl     "dramctrl"
 #define k_bank         "bank"
 #define k_niceCache    "niceCache"
 #define k_WB           "WB"
@@ -103,6 +109,18 @@ MemObj *MemorySystem::buildMemoryObj(const char *device_type,
 					     device_descr_section, 
 					     device_name);
 
+  } else if (!strcasecmp(device_type, k_streampref)) {
+
+    new_memory_device = new StreamPrefetcher(this, 
+					     device_descr_section, 
+					     device_name);
+
+  } else if (!strcasecmp(device_type, k_ghbpref)) {
+
+    new_memory_device = new GHBPrefetcher(this, 
+					  device_descr_section, 
+					  device_name);
+
   } else if (!strcasecmp(device_type, k_addrpref)) {
 
     new_memory_device = new AddressPrefetcher(this, 
@@ -125,6 +143,10 @@ MemObj *MemorySystem::buildMemoryObj(const char *device_type,
 
     new_memory_device = new MemCtrl(this, device_descr_section, device_name);
 
+  } else if (!strcasecmp(device_type, k_dramctrl)) {
+
+    new_memory_device = new DRAMCtrl(this, device_descr_section, device_name);
+
   } else if (!strcasecmp(device_type, k_void)) {      // For testing purposes
 
     return NULL; 
@@ -0,0 +1,312 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "nanassert.h"
+#include "SescConf.h"
+
+#include "DInst.h"
+#include "MemorySystem.h"
+#include "Prefetcher.h"
+
+Prefetcher::Prefetcher(MemorySystem* current
+                       ,const char *section
+                       ,const char *name)
+  : MemObj(section, name)
+  ,accesses("%s:accesses", name)
+  ,hit("%s:hits", name)
+  ,halfMiss("%s:halfMiss", name)
+  ,miss("%s:miss", name)
+  ,predictions("%s:predictions", name)
+  ,filtered("%s:filtered", name)
+  ,useful("%s:useful", name)
+  ,late("%s:late", name)
+  ,useless("%s:useless", name)
+  ,pollution("%s:pollution", name)
+  ,levelUp("%s:levelUp", name)
+  ,levelDown("%s:levelDown", name)
+  ,accuracy("%s:accuracy", name)
+  ,lateness("%s:lateness", name)
+  ,pollutionRate("%s:pollutionRate", name)
+  ,avgLevel("%s:avgLevel", name)
+{
+  MemObj *lower_level = NULL;
+
+  SescConf->isInt(section, "hitDelay");
+  hitDelay = SescConf->getInt(section, "hitDelay");
+
+  SescConf->isInt(section, "missDelay");
+  missDelay = SescConf->getInt(section, "missDelay");
+
+  const char *buffSection = SescConf->getCharPtr(section, "buffCache");
+  buff = BuffType::create(buffSection, "", name);
+
+  SescConf->isInt(buffSection, "numPorts");
+  SescConf->isInt(buffSection, "portOccp");
+
+  char portName[128];
+  sprintf(portName, "%s_buff", name);
+  buffPort = PortGeneric::create(portName
+                                 ,SescConf->getInt(buffSection, "numPorts")
+                                 ,SescConf->getInt(buffSection, "portOccp"));
+
+  defaultMask = ~(buff->getLineSize()-1);
+
+  degree = 1;
+  if (SescConf->checkInt(section, "degree")) {
+    SescConf->isGT(section, "degree", 0);
+    degree = SescConf->getInt(section, "degree");
+  }
+  distance = 16;
+  if (SescConf->checkInt(section, "distance")) {
+    SescConf->isGT(section, "distance", 0);
+    distance = SescConf->getInt(section, "distance");
+  }
+
+  throttle = false;
+  if (SescConf->checkBool(section, "throttle"))
+    throttle = SescConf->getBool(section, "throttle");
+
+  throttleInterval = 1024;
+  accHigh = 75;
+  accLow  = 40;
+  lateThr = 1;
+  pollThr = 5;
+  if (SescConf->checkInt(section, "throttleInterval")) {
+    SescConf->isGT(section, "throttleInterval", 0);
+    throttleInterval = SescConf->getInt(section, "throttleInterval");
+  }
+  if (SescConf->checkInt(section, "accHigh"))
+    accHigh = SescConf->getInt(section, "accHigh");
+  if (SescConf->checkInt(section, "accLow"))
+    accLow  = SescConf->getInt(section, "accLow");
+  if (SescConf->checkInt(section, "lateThr"))
+    lateThr = SescConf->getInt(section, "lateThr");
+  if (SescConf->checkInt(section, "pollThr"))
+    pollThr = SescConf->getInt(section, "pollThr");
+
+  level         = 3;
+  nIssued       = 0;
+  nUseful       = 0;
+  nLate         = 0;
+  nPolluted     = 0;
+  nDemandMisses = 0;
+  pollFilter.resize(PollFilterSize);
+
+  I(current);
+  lower_level = current->declareMemoryObj(section, k_lowerLevel);
+  if (lower_level != NULL)
+    addLowerLevel(lower_level);
+}
+
+int Prefetcher::getPC(MemRequest *mreq)
+{
+  DInst *dinst = mreq->getDInst();
+  if (dinst == 0)
+    return 0;
+
+  return dinst->getInst()->getAddr();
+}
+
+void Prefetcher::access(MemRequest *mreq)
+{
+  PAddr paddr = mreq->getPAddr() & defaultMask;
+
+  accesses.inc();
+
+  if (mreq->getMemOperation() == MemRead
+      || mreq->getMemOperation() == MemReadW) {
+    read(mreq);
+    return;
+  }
+
+  nextBuffSlot();
+
+  bLine *l = buff->readLine(paddr);
+  if(l)
+    l->invalidate();
+
+  mreq->goDown(0, lowerLevel[0]);
+}
+
+void Prefetcher::read(MemRequest *mreq)
+{
+  PAddr paddr = mreq->getPAddr() & defaultMask;
+  bLine *l = buff->readLine(paddr);
+
+  if(l) {
+    hit.inc();
+    if (!l->used) {
+      l->used = true;
+      useful.inc();
+      nUseful++;
+    }
+    mreq->goUpAbs(nextBuffSlot() + hitDelay);
+    learn(paddr, mreq, false);
+    return;
+  }
+
+  PendTable::iterator it = pending.find(paddr);
+  if(it != pending.end()) {
+    // the prefetch was useful, but not early enough
+    halfMiss.inc();
+    if (it->second.waiting.empty()) {
+      useful.inc();
+      late.inc();
+      nUseful++;
+      nLate++;
+    }
+    it->second.waiting.push_back(mreq);
+    learn(paddr, mreq, false);
+    return;
+  }
+
+  miss.inc();
+  nDemandMisses++;
+
+  uint h = pollHash(paddr);
+  if (pollFilter[h]) {
+    pollFilter[h] = false;
+    pollution.inc();
+    nPolluted++;
+  }
+
+  learn(paddr, mreq, true);
+  mreq->goDownAbs(nextBuffSlot() + missDelay, lowerLevel[0]);
+}
+
+bool Prefetcher::issuePrefetch(PAddr addr, TimeDelta_t lat)
+{
+  addr &= defaultMask;
+
+  if (isBuffered(addr)) {
+    filtered.inc();
+    return false;
+  }
+
+  PendEntry &e = pending[addr];
+  e.issued = globalClock;
+  I(e.waiting.empty());
+
+  CBMemRequest *r = CBMemRequest::create(lat, lowerLevel[0], MemRead, addr,
+                                         processAckCB::create(this, addr));
+  if(lat != 0) { // if lat=0, the req might not exist anymore at this point
+    r->markPrefetch();
+  }
+
+  predictions.inc();
+
+  nIssued++;
+  if (throttle && nIssued >= throttleInterval)
+    endInterval();
+
+  return true;
+}
+
+void Prefetcher::endInterval()
+{
+  int acc  = (100*nUseful)/nIssued;
+  int lat  = nUseful ? (100*nLate)/nUseful : 0;
+  int poll = nDemandMisses ? (100*nPolluted)/nDemandMisses : 0;
+
+  accuracy.sample(acc);
+  lateness.sample(lat);
+  pollutionRate.sample(poll);
+
+  bool isLate     = lat  > lateThr;
+  bool isPolluting = poll > pollThr;
+
+  int delta = 0;
+  if (acc >= accHigh) {
+    if (isLate)
+      delta = 1;
+    else if (isPolluting)
+      delta = -1;
+  }else if (acc >= accLow) {
+    if (isPolluting)
+      delta = -1;
+    else if (isLate)
+      delta = 1;
+  }else{
+    delta = -1;
+  }
+
+  if (delta > 0 && level < MaxLevel) {
+    level++;
+    levelUp.inc();
+  }else if (delta < 0 && level > 1) {
+    level--;
+    levelDown.inc();
+  }
+  avgLevel.sample(level);
+
+  nIssued       = 0;
+  nUseful       = 0;
+  nLate         = 0;
+  nPolluted     = 0;
+  nDemandMisses = 0;
+}
+
+void Prefetcher::processAck(PAddr addr)
+{
+  PendTable::iterator it = pending.find(addr);
+  if(it == pending.end())
+    return;
+
+  bLine *l = buff->findLine2Replace(addr, true);
+  I(l);
+  if (l->isValid() && l->getTag() != buff->calcTag(addr) && !l->used) {
+    // pushed out before any use
+    useless.inc();
+    pollFilter[pollHash(buff->calcAddr4Tag(l->getTag()))] = true;
+  }
+  l->setTag(buff->calcTag(addr));
+  l->used = !it->second.waiting.empty();
+
+  while (!it->second.waiting.empty()) {
+    it->second.waiting.front()->goUpAbs(nextBuffSlot());
+    it->second.waiting.pop_front();
+  }
+
+  pending.erase(it);
+}
+
+void Prefetcher::returnAccess(MemRequest *mreq)
+{
+  mreq->goUp(0);
+}
+
+bool Prefetcher::canAcceptStore(PAddr addr)
+{
+  return true;
+}
+
+void Prefetcher::invalidate(PAddr addr, ushort size, MemObj *oc)
+{
+  PAddr paddr = addr & defaultMask;
+  nextBuffSlot();
+
+  bLine *l = buff->readLine(paddr);
+  if(l)
+    l->invalidate();
+}
+
+Time_t Prefetcher::getNextFreeCycle() const
+{
+  return buffPort->calcNextSlot();
+}
@@ -0,0 +1,172 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <deque>
+#include <vector>
+
+#include "CacheCore.h"
+#include "callback.h"
+#include "estl.h"
+#include "GStats.h"
+#include "MemObj.h"
+#include "MemRequest.h"
+#include "Port.h"
+
+class PfBuffState : public StateGeneric<> {
+ public:
+  bool used; // a demand access hit the line since it was prefetched
+
+  void initialize(void *c) {
+    StateGeneric<>::initialize(c);
+    used = false;
+  }
+};
+
+// Common part of the prefetchers that sit between a cache and its lower
+// level. Prefetched lines go to a small buffer (buffCache section), and
+// the prefetches in flight are kept in a single pending table so that a
+// demand read that finds its line on the way just waits for it.
+//
+// Derived classes see every demand read (learn) and call issuePrefetch.
+//
+// Feedback directed throttling (throttle = true): every
+// throttleInterval prefetches the accuracy (useful/issued), lateness
+// (late/useful) and pollution (demand misses on lines that a prefetch
+// pushed out of the buffer before they were used) of the interval are
+// computed, and the aggressiveness level (1..5, starts at 3) goes up or
+// down. The degree and distance of the derived prefetcher are scaled by
+// the level: 1/4, 1/2, 1, 2, 4 times the configured values.
+class Prefetcher : public MemObj {
+protected:
+  typedef CacheGeneric<PfBuffState,PAddr> BuffType;
+  typedef CacheGeneric<PfBuffState,PAddr>::CacheLine bLine;
+
+  class PendEntry {
+  public:
+    Time_t issued;
+    std::deque<MemRequest *> waiting;
+  };
+
+  typedef HASH_MAP<PAddr, PendEntry> PendTable;
+
+  enum { MaxLevel = 5, PollFilterSize = 4096 };
+
+  PendTable pending;
+
+  BuffType    *buff;
+  PortGeneric *buffPort;
+
+  int hitDelay;
+  int missDelay;
+
+  PAddr defaultMask;
+
+  // Configured aggressiveness, scaled by the throttling level
+  int degree;
+  int distance;
+
+  bool throttle;
+  int  level;
+  int  throttleInterval;
+  int  accHigh;    // %
+  int  accLow;     // %
+  int  lateThr;    // %
+  int  pollThr;    // %
+
+  // current interval
+  int nIssued;
+  int nUseful;
+  int nLate;
+  int nPolluted;
+  int nDemandMisses;
+
+  std::vector<bool> pollFilter;
+
+  GStatsCntr accesses;
+  GStatsCntr hit;
+  GStatsCntr halfMiss;
+  GStatsCntr miss;
+  GStatsCntr predictions;
+  GStatsCntr filtered;
+  GStatsCntr useful;
+  GStatsCntr late;
+  GStatsCntr useless;
+  GStatsCntr pollution;
+  GStatsCntr levelUp;
+  GStatsCntr levelDown;
+  GStatsAvg  accuracy;
+  GStatsAvg  lateness;
+  GStatsAvg  pollutionRate;
+  GStatsAvg  avgLevel;
+
+  uint pollHash(PAddr addr) const {
+    PAddr l = addr >> buff->getLog2AddrLs();
+    return (l ^ (l >> 12)) & (PollFilterSize - 1);
+  }
+
+  int scale(int v) const {
+    int s = (level >= 3) ? (v << (level - 3)) : (v >> (3 - level));
+    return s > 0 ? s : 1;
+  }
+
+  void endInterval();
+  void read(MemRequest *mreq);
+
+  // Program counter of the instruction behind the request, 0 if unknown
+  static int getPC(MemRequest *mreq);
+
+  // Demand read of line addr. miss is true when the line was neither in
+  // the buffer nor in flight
+  virtual void learn(PAddr addr, MemRequest *mreq, bool miss) = 0;
+
+  // false if the line is already in the buffer or on the way
+  bool issuePrefetch(PAddr addr, TimeDelta_t lat = 0);
+
+  bool isBuffered(PAddr addr) {
+    addr &= defaultMask;
+    return buff->findLineNoEffect(addr) || pending.find(addr) != pending.end();
+  }
+
+  int getDegree() const   { return scale(degree);   }
+  int getDistance() const { return scale(distance); }
+  PAddr getLineSize() const { return buff->getLineSize(); }
+
+  Time_t nextBuffSlot() {
+    return buffPort->nextSlot();
+  }
+
+public:
+  Prefetcher(MemorySystem* current, const char *device_descr_section,
+             const char *device_name = NULL);
+  virtual ~Prefetcher() {}
+
+  void access(MemRequest *mreq);
+  void returnAccess(MemRequest *mreq);
+  bool canAcceptStore(PAddr addr);
+  void invalidate(PAddr addr, ushort size, MemObj *oc);
+  Time_t getNextFreeCycle() const;
+
+  void processAck(PAddr addr);
+  typedef CallbackMember1<Prefetcher, PAddr, &Prefetcher::processAck> processAckCB;
+};
+
+#endif // PREFETCHER_H
@@ -0,0 +1,118 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "nanassert.h"
+#include "SescConf.h"
+
+#include "MemorySystem.h"
+#include "StreamPrefetcher.h"
+
+StreamPrefetcher::StreamPrefetcher(MemorySystem* current
+                                   ,const char *section
+                                   ,const char *name)
+  : Prefetcher(current, section, name)
+  ,allocated("%s:allocated", name)
+  ,trained("%s:trained", name)
+  ,advanced("%s:advanced", name)
+{
+  int numStreams = 16;
+  if (SescConf->checkInt(section, "numStreams")) {
+    SescConf->isGT(section, "numStreams", 0);
+    numStreams = SescConf->getInt(section, "numStreams");
+  }
+  trainWindow = 16;
+  if (SescConf->checkInt(section, "trainWindow")) {
+    SescConf->isGT(section, "trainWindow", 0);
+    trainWindow = SescConf->getInt(section, "trainWindow");
+  }
+
+  log2LineSize = log2i(getLineSize());
+
+  streams.resize(numStreams);
+  for(int i = 0; i < numStreams; i++) {
+    streams[i].valid = false;
+    streams[i].dir   = 0;
+    streams[i].lru   = 0;
+  }
+}
+
+void StreamPrefetcher::advance(Stream &s, long long line)
+{
+  s.last = line;
+  s.lru  = globalClock;
+
+  // never prefetch behind the demand stream
+  if ((s.next - line)*s.dir <= 0)
+    s.next = line + s.dir;
+
+  int n    = getDegree();
+  int dist = getDistance();
+  for(int i = 0; i < n && (s.next - line)*s.dir <= dist; i++) {
+    issuePrefetch(static_cast<PAddr>(s.next << log2LineSize));
+    s.next += s.dir;
+  }
+}
+
+void StreamPrefetcher::learn(PAddr addr, MemRequest *mreq, bool miss)
+{
+  long long line = addr >> log2LineSize;
+  int dist = getDistance();
+
+  for(size_t i = 0; i < streams.size(); i++) {
+    Stream &s = streams[i];
+    if (!s.valid || s.dir == 0)
+      continue;
+
+    long long ahead = (line - s.last)*s.dir;
+    if (ahead >= 0 && ahead <= dist) {
+      advanced.inc();
+      advance(s, line);
+      return;
+    }
+  }
+
+  if (!miss)
+    return;
+
+  Stream *victim = &streams[0];
+  for(size_t i = 0; i < streams.size(); i++) {
+    Stream &s = streams[i];
+    if (s.valid && s.dir == 0) {
+      long long delta = line - s.start;
+      if (delta != 0 && delta <= trainWindow && delta >= -trainWindow) {
+        trained.inc();
+        s.dir  = delta > 0 ? 1 : -1;
+        s.next = line + s.dir;
+        advance(s, line);
+        return;
+      }
+    }
+
+    if (!s.valid || (victim->valid && s.lru < victim->lru))
+      victim = &s;
+  }
+
+  allocated.inc();
+  victim->valid = true;
+  victim->start = line;
+  victim->last  = line;
+  victim->next  = line;
+  victim->dir   = 0;
+  victim->lru   = globalClock;
+}
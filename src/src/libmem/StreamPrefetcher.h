@@ -0,0 +1,65 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef STREAMPREFETCHER_H
+#define STREAMPREFETCHER_H
+
+#include <vector>
+
+#include "Prefetcher.h"
+
+// Stream prefetcher (deviceType = 'streampref'). A miss allocates a
+// stream in training state (LRU replacement among numStreams). A second
+// miss less than trainWindow lines away sets the direction. From then on
+// every access that falls between the last access of the stream and
+// distance lines ahead of it issues up to degree prefetches, staying at
+// most distance lines ahead.
+class StreamPrefetcher : public Prefetcher {
+private:
+  class Stream {
+  public:
+    long long start;  // line of the training miss
+    long long last;   // last line accessed
+    long long next;   // next line to prefetch
+    int       dir;    // +1 or -1, 0 while training
+    Time_t    lru;
+    bool      valid;
+  };
+
+  std::vector<Stream> streams;
+
+  int  trainWindow;
+  uint log2LineSize;
+
+  GStatsCntr allocated;
+  GStatsCntr trained;
+  GStatsCntr advanced;
+
+  void advance(Stream &s, long long line);
+
+protected:
+  void learn(PAddr addr, MemRequest *mreq, bool miss);
+
+public:
+  StreamPrefetcher(MemorySystem* current, const char *device_descr_section,
+                   const char *device_name = NULL);
+  ~StreamPrefetcher() {}
+};
+
+#endif // STREAMPREFETCHER_H
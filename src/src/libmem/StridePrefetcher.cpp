@@ -30,26 +30,16 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "MemorySystem.h"
 #include "StridePrefetcher.h"
 
-static pool < std::queue<MemRequest *> > activeMemReqPool(32, 
-							  "StridePrefetcher");
-
 StridePrefetcher::StridePrefetcher(MemorySystem* current
 	 ,const char *section
 	 ,const char *name)
-  : MemObj(section, name)
-  ,halfMiss("%s:halfMiss", name)
-  ,miss("%s:miss", name)
-  ,hit("%s:hits", name)
-  ,predictions("%s:predictions", name)
-  ,accesses("%s:accesses", name)
+  : Prefetcher(current, section, name)
   ,unitStrideStreams("%s:unitStrideStreams", name)
   ,nonUnitStrideStreams("%s:nonUnitStrideStreams", name)
   ,ignoredStreams("%s:ignoredStreams", name)
 {
-  MemObj *lower_level = NULL;
-
   SescConf->isInt(section, "depth");
-  depth = SescConf->getInt(section, "depth");
+  degree = SescConf->getInt(section, "depth");
 
   SescConf->isInt(section, "missWindow");
   missWindow = SescConf->getInt(section, "missWindow");
@@ -57,30 +47,13 @@ StridePrefetcher::StridePrefetcher(MemorySystem* current
   SescConf->isInt(section, "maxStride");
   maxStride = SescConf->getInt(section, "maxStride");
 
-  SescConf->isInt(section, "hitDelay");
-  hitDelay = SescConf->getInt(section, "hitDelay");
-
-  SescConf->isInt(section, "missDelay");
-  missDelay = SescConf->getInt(section, "missDelay");
-
   SescConf->isInt(section, "learnHitDelay");
   learnHitDelay = SescConf->getInt(section, "learnHitDelay");
 
   SescConf->isInt(section, "learnMissDelay");
   learnMissDelay = SescConf->getInt(section, "learnMissDelay");
 
-  I(depth > 0);
-
-  const char *buffSection = SescConf->getCharPtr(section, "buffCache");
-  if (buffSection) {
-    buff = BuffType::create(buffSection, "", name);
-    
-    SescConf->isInt(buffSection, "numPorts");
-    numBuffPorts = SescConf->getInt(buffSection, "numPorts");
-    
-    SescConf->isInt(buffSection, "portOccp");
-    buffPortOccp = SescConf->getInt(buffSection, "portOccp");
-  }
+  I(degree > 0);
 
   const char *streamSection = SescConf->getCharPtr(section, "streamCache");
   if (streamSection) {
@@ -99,54 +72,19 @@ StridePrefetcher::StridePrefetcher(MemorySystem* current
   }
 
   char portName[128];
-  sprintf(portName, "%s_buff", name);
-  buffPort  = PortGeneric::create(portName, numBuffPorts, buffPortOccp);
   sprintf(portName, "%s_table", name);
   tablePort = PortGeneric::create(portName, numTablePorts, tablePortOccp);
-
-  defaultMask  = ~(buff->getLineSize()-1);
-
-  I(current);
-  lower_level = current->declareMemoryObj(section, k_lowerLevel);   
-  if (lower_level != NULL)
-    addLowerLevel(lower_level);
 }
 
-void StridePrefetcher::read(MemRequest *mreq)
+void StridePrefetcher::learn(PAddr addr, MemRequest *mreq, bool miss)
 {
-  uint paddr = mreq->getPAddr() & defaultMask;
-  bLine *l = buff->readLine(paddr);
-
-  if(l) { //hit
-    LOG("SP: hit on %08lx", paddr);
-    hit.inc();
-    mreq->goUpAbs(nextBuffSlot() + hitDelay); 
-    learnHit(paddr);
-    return;
-  }
-
-  penFetchSet::iterator it = pendingFetches.find(paddr);
-  if(it != pendingFetches.end()) { // half-miss
-    LOG("SP: half-miss on %08lx", paddr);
-    halfMiss.inc();
-    penReqMapper::iterator itR = pendingRequests.find(paddr);
-
-    if (itR == pendingRequests.end()) {
-      pendingRequests[paddr] = activeMemReqPool.out();
-      itR = pendingRequests.find(paddr);
-    }
-
-    I(itR != pendingRequests.end());
-    
-    (*itR).second->push(mreq);
-    learnHit(paddr); // half-miss is a hit from the learning point of view
-    return;
+  // a half-miss is a hit from the learning point of view
+  if (miss) {
+    LOG("SP:miss on %08lx", addr);
+    learnMiss(addr);
+  }else{
+    learnHit(addr);
   }
-
-  LOG("SP:miss on %08lx", paddr);
-  miss.inc();
-  learnMiss(paddr);
-  mreq->goDownAbs(nextBuffSlot() + missDelay, lowerLevel[0]); 
 }
 
 void StridePrefetcher::learnHit(PAddr addr)
@@ -191,7 +129,7 @@ void StridePrefetcher::learnMiss(PAddr addr)
     }
     minDelta = (delta < minDelta ? delta : minDelta);
 
-    if((*it) == paddr - buff->getLineSize() || (*it) == paddr + buff->getLineSize()) {
+    if((*it) == paddr - getLineSize() || (*it) == paddr + getLineSize()) {
       foundUnitStride = true;
       break;
     }
@@ -206,7 +144,7 @@ void StridePrefetcher::learnMiss(PAddr addr)
   
   if(foundUnitStride) {
     unitStrideStreams.inc();
-    newStride = buff->getLineSize();
+    newStride = getLineSize();
   } else {
     nonUnitStrideStreams.inc();
     newStride = minDelta;
@@ -234,102 +172,11 @@ void StridePrefetcher::learnMiss(PAddr addr)
 
 void StridePrefetcher::prefetch(pEntry *pe, Time_t lat)
 {
-  uint bsize = buff->getLineSize();
   PAddr prefAddr = pe->nextAddr(table);
+  int   depth    = getDegree();
 
   for(int i = 0; i < depth; i++) {
-    if(!buff->readLine(prefAddr)) { // it is not in the buff
-      penFetchSet::iterator it = pendingFetches.find(prefAddr);
-      if(it == pendingFetches.end()) {
-	CBMemRequest *r;
-	r = CBMemRequest::create(lat, lowerLevel[0], MemRead, prefAddr, 
-				 processAckCB::create(this, prefAddr));
-	if(lat != 0) { // if lat=0, the req might not exist anymore at this point
-	  r->markPrefetch();
-	}
-	pendingFetches.insert(prefAddr);
-	predictions.inc();
-      }
-    }
+    issuePrefetch(prefAddr, lat);
     prefAddr += pe->stride;
   }
 }
-
-void StridePrefetcher::access(MemRequest *mreq)
-{
-  uint paddr = mreq->getPAddr() & defaultMask;
-  LOG("SP:access addr=%08lx", paddr);
-
-  // TODO: should i really consider all these read types? 
-  if (mreq->getMemOperation() == MemRead
-      || mreq->getMemOperation() == MemReadW) {
-    read(mreq);
-  } else {
-    LOG("SP:ignoring access addr=%08lx type=%d", paddr, mreq->getMemOperation());
-    nextBuffSlot();
-    
-    bLine *l = buff->readLine(paddr);
-    if(l)
-      l->invalidate();
-
-    mreq->goDown(0, lowerLevel[0]);
-  }
-  accesses.inc();
-}
-
-void StridePrefetcher::returnAccess(MemRequest *mreq)
-{
-  uint paddr = mreq->getPAddr() & defaultMask;
-  LOG("SP:returnAccess addr=%08lx", paddr);
-
-  mreq->goUp(0);
-}
-
-void StridePrefetcher::processAck(PAddr addr)
-{
-  uint paddr = addr & defaultMask;
-
-  penFetchSet::iterator itF = pendingFetches.find(paddr);
-  if(itF == pendingFetches.end()) 
-    return;
-
-  bLine *l = buff->fillLine(paddr);
-
-  penReqMapper::iterator it = pendingRequests.find(paddr);
-
-  if(it != pendingRequests.end()) {
-    LOG("SP:returnAccess addr=%08lx", paddr);
-    std::queue<MemRequest *> *tmpReqQueue;
-    tmpReqQueue = (*it).second;
-    while (tmpReqQueue->size()) {
-      tmpReqQueue->front()->goUpAbs(nextBuffSlot());
-      tmpReqQueue->pop();
-    }
-    pendingRequests.erase(paddr);
-    activeMemReqPool.in(tmpReqQueue);
-  }
-  pendingFetches.erase(paddr);
-}
-
-bool StridePrefetcher::canAcceptStore(PAddr addr)
-{
-  return true;
-}
-
-void StridePrefetcher::invalidate(PAddr addr,ushort size,MemObj *oc)
-{ 
-	uint paddr = addr & defaultMask;
-   nextBuffSlot();
-
-   bLine *l = buff->readLine(paddr);
-   if(l)
-     l->invalidate();
-
-   //invUpperLevel(addr,size,cb); 
-}
-
-Time_t StridePrefetcher::getNextFreeCycle() const
-{
-  return buffPort->calcNextSlot();
-}
-
@@ -23,20 +23,10 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #ifndef STRIDE_PREFETCHER_H
 #define STRIDE_PREFETCHER_H
 
-#include <queue>
 #include <deque>
-#include <stack>
 
 #include "CacheCore.h"
-#include "callback.h"
-#include "estl.h"
-#include "GStats.h"
-#include "MemObj.h"
-#include "MemRequest.h"
-#include "Port.h"
-
-class BState : public StateGeneric<> {
-};
+#include "Prefetcher.h"
 
 class PfState : public StateGeneric<> {
  public:
@@ -49,81 +39,44 @@ class PfState : public StateGeneric<> {
   }
 };
 
-class StridePrefetcher: public MemObj {
+class StridePrefetcher: public Prefetcher {
 private:
-  typedef CacheGeneric<BState,PAddr> BuffType;
-  typedef CacheGeneric<BState,PAddr>::CacheLine bLine;
-
   typedef CacheGeneric<PfState,PAddr> PfTable;
   typedef CacheGeneric<PfState,PAddr>::CacheLine pEntry;
 
-  typedef HASH_MAP<PAddr, std::queue<MemRequest *> *> penReqMapper;
-  typedef HASH_SET<PAddr> penFetchSet;
-
-  penReqMapper pendingRequests;
-
-  penFetchSet pendingFetches;
-
-  BuffType *buff;
   PfTable  *table;
 
   std::deque<PAddr> lastMissesQ;
 
-  PortGeneric *buffPort;
   PortGeneric *tablePort;
 
-  int numStreams;
-  int streamAssoc;
-  int depth;
-  int numBuffPorts;
-  int buffPortOccp;
   int numTablePorts;
   int tablePortOccp;
-  int hitDelay;
-  int missDelay;
   int learnHitDelay;
   int learnMissDelay;
   uint missWindow;
   uint maxStride;
   static const int pEntrySize = 8; // size of an entry in the prefetching table
   
-  int defaultMask;
-
-  GStatsCntr halfMiss;
-  GStatsCntr miss;
-  GStatsCntr hit;
-  GStatsCntr predictions;
-  GStatsCntr accesses;
   GStatsCntr unitStrideStreams;
   GStatsCntr nonUnitStrideStreams;
   GStatsCntr ignoredStreams;
 
+protected:
+  void learn(PAddr addr, MemRequest *mreq, bool miss);
+
 public:
   StridePrefetcher(MemorySystem* current, const char *device_descr_section,
   const char *device_name = NULL);
   ~StridePrefetcher() {}
-  void access(MemRequest *mreq);
-  void read(MemRequest *mreq);
-  void returnAccess(MemRequest *mreq);
-  bool canAcceptStore(PAddr addr);
-  void invalidate(PAddr addr,ushort size,MemObj *oc);
-  Time_t getNextFreeCycle() const;
   
   void learnHit(PAddr addr);
   void learnMiss(PAddr addr);
   void prefetch(pEntry *pe, Time_t lat);
 
-  Time_t nextBuffSlot() {
-    return buffPort->nextSlot();
-  }
-
   Time_t nextTableSlot() {
     return tablePort->nextSlot();
   }
-
-  void processAck(PAddr addr);
-  typedef CallbackMember1<StridePrefetcher, PAddr, &StridePrefetcher::processAck> processAckCB;
-
 };
 
 #endif
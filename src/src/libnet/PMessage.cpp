@@ -63,7 +63,27 @@ static SizeNameInfo MessageType2SizeName[] = {
     
     {7,  "TSRead"},
     {3,  "TSReadAck"},
-    {0,  "DSM"},
+    {0,  "DSMMemRead"},
+    {0,  "DSMMemWrite"},
+    {0,  "DSMMemReadAck"},
+    {0,  "DSMMemWriteAck"},
+    {0,  "DSMReadMiss"},
+    {0,  "DSMWriteMiss"},
+    {0,  "DSMInvalidate"},
+    {0,  "DSMReadMissAck"},
+    {0,  "DSMWriteMissAck"},
+    {0,  "DSMInvalidateAck"},
+    {0,  "DSMData"},
+    {8,  "DirReqRd"},
+    {8,  "DirReqWr"},
+    {8,  "DirReqMem"},
+    {36, "DirWrBack"},    // (4+linesize)
+    {8,  "DirFwdRd"},
+    {7,  "DirInv"},
+    {3,  "DirAck"},
+    {35, "DirDataAck"},   // (3+linesize)
+    {3,  "DirReply"},
+    {35, "DirDataReply"}, // (3+linesize)
     {0,  "MaxReadAck"}};
 
 PMessage::PMessage()
@@ -75,6 +75,17 @@ enum MessageType {
   ,DSMWriteMissAckMsg
   ,DSMInvalidateAckMsg
   ,DSMDataMsg
+  // libsmp mesh directory (SMPDirectory)
+  ,DirReqRdMsg
+  ,DirReqWrMsg
+  ,DirReqMemMsg
+  ,DirWrBackMsg
+  ,DirFwdRdMsg
+  ,DirInvMsg
+  ,DirAckMsg
+  ,DirDataAckMsg
+  ,DirReplyMsg
+  ,DirDataReplyMsg
 
   // upper limit
   ,MaxMessageType
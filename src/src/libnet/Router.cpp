@@ -31,6 +31,9 @@ Router::Router(const char *section, RouterID_t id,
 
   SescConf->isBool(section, "congestionFree");
 
+  nForward = new GStatsCntr("%s_router(%d):nForward", section, myID);
+  fwdWait  = new GStatsAvg("%s_router(%d):fwdWait", section, myID);
+
   maxLocalPort = PortID_t(static_cast<int>(LOCAL_PORT1)+localNum);
   
   I(maxLocalPort>LOCAL_PORT1);
@@ -170,6 +173,9 @@ void Router::forwardMsg(Message *msg)
 
   Time_t when = r2rPort[wire->port]->occupySlots(calcNumFlits(msg));
 
+  nForward->inc();
+  fwdWait->sample(when - globalClock);
+
   // MSG("%lld router::forwardMsg %d->%d",globalClock,myID, wire->rID);
 
   msg->forwardMsgAbs(when+crossLat+wire->dist, net->getRouter(wire->rID));
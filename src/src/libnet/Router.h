@@ -6,6 +6,7 @@
 
 #include "EnergyMgr.h"
 #include "estl.h"
+#include "GStats.h"
 #include "nanassert.h"
 #include "Port.h"
 #include "ProtocolCB.h"
@@ -58,6 +59,10 @@ private:
   std::vector<PortGeneric *> r2lPort; // ports from router to local device
   std::vector<PortGeneric *> r2rPort; // ports from router to router (output)
 
+  // Per link contention is in the r2rPort avgTime. These are per router
+  GStatsCntr *nForward; // messages that crossed the router
+  GStatsAvg  *fwdWait;  // cycles waiting for the output link
+
 protected:
 
   ushort calcNumFlits(Message *msg) const;
@@ -14,6 +14,7 @@
 //
 
 #include "stat_profile.h"
+#include "HostProf.h"
 
 //NOTE output directories
 string rootDirectory    = "/home/hughes/Benchies/MIPS/asmTesting/";
@@ -241,7 +242,8 @@ void dependencyCheck(DInst tempDinst)
  */
 void analysis(tuple<DInst, Time_t>  tempTuple)
 {
-   ConfObject *statConf = new ConfObject;
+   HOSTPROF_SCOPE(HP_Analysis);
+   ConfObject *statConf = ConfObject::getConf();
    BOOL threadProfiling = statConf->return_enablePerThreadProfiling();
    DInst tempDinst = tempTuple.get<0>();
    THREAD_ID threadID = tempDinst.get_threadID();
@@ -350,13 +352,11 @@ void analysis(tuple<DInst, Time_t>  tempTuple)
       Profiling::isTransaction[threadID] = 0;
       transactionDistance[threadID] = 0;
    }
-
-   delete statConf;
 }
 
 void finished(void)
 {
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    INT_32 printType = statConf->return_dumpType();
    BOOL threadProfiling = statConf->return_enablePerThreadProfiling();
 
@@ -389,7 +389,6 @@ void finished(void)
    aggregateCharacteristics(printType, threadProfiling);
 
    Profiling::cleanup();
-   delete statConf;
 }
 
 }  //NOTE end Profiling
@@ -57,6 +57,8 @@ struct Rstzip_impl {
     verbose = false;
     stats = false;
     done_logging = false;
+    indexed = false;
+    nthreads = 1;
     records_checked_for_traceid = 0;
     filename = NULL;
     rz3obj = NULL;
@@ -79,6 +81,13 @@ struct Rstzip_impl {
       if (strstr(opts, "stats=1") != NULL) {
         stats = true;
       }
+      if (strstr(opts, "indexed=1") != NULL) {
+        indexed = true;
+      }
+      const char * t = strstr(opts, "threads=");
+      if (t != NULL) {
+        nthreads = atoi(t+8);
+      }
 
       if (strstr(opts, "version=0") != NULL) {
         agent = rstzip0_agent;
@@ -104,6 +113,8 @@ struct Rstzip_impl {
   bool verbose;
   bool stats;
   bool done_logging;
+  bool indexed;
+  int nthreads;
   int records_checked_for_traceid;
 
   struct rstzip3 * rz3obj;
@@ -249,7 +260,7 @@ int Rstzip::open(const char * filename, const char * mode, const char *opts)
   if (impl->c_nd) {
 
     impl->agent = Rstzip_impl::rstzip3_agent; // default
-    impl->rz3obj = new rstzip3(filename, "w");
+    impl->rz3obj = new rstzip3(filename, "w", impl->indexed);
     if (impl->rz3obj->error()) {
       return RSTZIP_ERROR;
     }
@@ -340,6 +351,7 @@ int Rstzip::open(const char * filename, const char * mode, const char *opts)
       }
       if (impl->verbose) impl->rz3obj->setverbose();
       if (impl->stats) impl->rz3obj->setstats();
+      impl->rz3obj->setthreads(impl->nthreads);
 
       break;
 
@@ -438,6 +450,20 @@ int Rstzip::decompress(rstf_unionT * rstbuf, int nrecs)
 } // int Rstzip::decompress(rstf_unionT * rstbuf, int nrecs)
 
 
+int Rstzip::seek(uint64_t nrec)
+{
+  if (impl->c_nd || (impl->agent != Rstzip_impl::rstzip3_agent)) {
+    fprintf(stderr, "ERROR: Rstzip::seek() - only supported when decompressing rstzip3 traces\n");
+    return RSTZIP_ERROR;
+  }
+
+  // the trace id record is in the first records: do not look for it later
+  impl->done_logging = true;
+
+  return impl->rz3obj->seek(nrec) ? RSTZIP_OK : RSTZIP_ERROR;
+} // int Rstzip::seek(uint64_t nrec)
+
+
 void Rstzip::close()
 {
   if (impl->c_nd) {
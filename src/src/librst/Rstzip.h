@@ -124,6 +124,11 @@ public:
   //     this manner. If more than one version is specified, results are unpredictable
   //     Version 0 indicates a RAW RST trace file.
   //
+  // indexed=0|1        <= for compression only: write the indexed rz3 layout
+  //                       (independent sections and a section table at the end)
+  // threads=N          <= for decompression only: decompress N sections of an
+  //                       indexed rz3 trace in parallel
+  //
   // FIXME: ADD information about buffersize here
   //
   // Note: normally, a raw RST trace can be detected by the presence of a valid RST
@@ -169,6 +174,19 @@ public:
   // trace is reached. Subsequent calls to decompress() will return 0.
   virtual int decompress(rstf_unionT* rstbuf, int nrecs);
 
+  // SYNOPSIS
+  // virtual int seek(uint64_t nrec);
+  //
+  // DESCRIPTION
+  // Decompression only: the next decompress() returns record number 'nrec'
+  // (counted from the start of the trace). Indexed rz3 traces go directly
+  // to the section that holds it, in either direction. Other rz3 traces can
+  // only move forward, by decompressing the records in between.
+  //
+  // RETURN VALUES
+  // RSTZIP_OK, or RSTZIP_ERROR if the record can not be reached.
+  virtual int seek(uint64_t nrec);
+
   // SYNOPSIS
   // virtual void close();
   //
@@ -43,6 +43,10 @@ static const bool dbg_regid = false;
 // rstbufsize <= rz3_bufsize
 int rstzip3::compress_buffer(rstf_unionT * rstbuf, int rstbufsize)
 {
+  // indexed layout: independent sections, each in its own gzip member
+  if (indexed && !begin_indexed_section()) {
+    return 0;
+  }
 
   shdr->clear();
   sdata->clear();
@@ -192,6 +196,10 @@ int rstzip3::compress_buffer(rstf_unionT * rstbuf, int rstbufsize)
     return 0;
   }
 
+  if (indexed) {
+    end_indexed_section();
+  }
+
 
   if (verbose) {
     fprintf(stderr, "Section %d\n", nsections);
@@ -64,6 +64,15 @@ int rstzip3::decompress_buffer(rstf_unionT * rstbuf, int rstbufsize)
     return 0;
   }
 
+  decompress_records(rstbuf);
+
+  return shdr->nrecords;
+} // int rstzip3::decompress_buffer(rstf_unionT * rstbuf, int nrec)
+
+
+// decompress the section in shdr/sdata
+void rstzip3::decompress_records(rstf_unionT * rstbuf)
+{
   int i;
   uint64_t v;
   for (i=0; i<shdr->nrecords; i++) {
@@ -184,10 +193,7 @@ int rstzip3::decompress_buffer(rstf_unionT * rstbuf, int rstbufsize)
   } // for each record
 
   nsections++;
-
-
-  return shdr->nrecords;
-} // int rstzip3::decompress_buffer(rstf_unionT * rstbuf, int nrec)
+} // void rstzip3::decompress_records(rstf_unionT * rstbuf)
 
 
 
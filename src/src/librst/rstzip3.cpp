@@ -41,6 +41,9 @@
 #include <strings.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include <zlib.h>
 
@@ -159,10 +162,64 @@ struct rz3_perf_stats_descr rstzip3::perf_stats_descr[] = {
 }; // struct rz3_perf_stats_descr rstzip3::perf_stats_descr = {}
 
 
-rstzip3::rstzip3(const char * fname, const char * mode)
+/* rz3_section_pool: the sections after the one being consumed are
+ * decompressed by nthreads workers, each with its own rstzip3 (predictor
+ * state), into a window of 2*nthreads section buffers. Section k always
+ * goes to slot k%depth, and the consumer swaps the slot buffer with its
+ * interface buffer instead of copying it.
+ */
+struct rz3_section_pool {
+  struct slot_t {
+    rstf_unionT * buf;
+    int section; // -1 if free
+    int nrecords;
+    bool ready;
+  };
+
+  rstzip3 * owner;
+  int nthreads;
+  int depth;
+
+  slot_t * slots;
+  rstzip3 ** decoders;
+  pthread_t * threads;
+  int nstarted;
+  int nworkers;   // running, gives each one its decoder
+
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int next_job;   // next section to hand out
+  int next_out;   // next section the owner consumes
+  int generation; // bumped by restart(), older jobs are dropped
+  bool stop;
+
+  rz3_section_pool(rstzip3 * arg_owner, int arg_nthreads);
+  ~rz3_section_pool();
+
+  void restart(int section);
+  int get(int section, rstf_unionT * & buf);
+
+  static void * worker(void * arg);
+  void work();
+}; // struct rz3_section_pool
+
+
+rstzip3::rstzip3(const char * fname, const char * mode, bool arg_indexed)
 {
   rz3_error = false;
 
+  header = NULL;
+  indexed = false;
+  fd = -1;
+  index = NULL;
+  index_size = index_alloc = 0;
+  index_offset = 0;
+  cur_section = 0;
+  records_out = 0;
+  skip_records = 0;
+  nthreads = 1;
+  pool = NULL;
+
   verbose = false;
   stats = false;
   g0_nonzero_warn = true; // will be set to false after first instance unless verbose
@@ -186,7 +243,27 @@ rstzip3::rstzip3(const char * fname, const char * mode)
   shdr = new rz3_section_header;
 
   if (c_nd) {
-    if (fname != NULL) {
+    indexed = arg_indexed;
+    if (indexed && (fname == NULL)) {
+      fprintf(stderr, "Warning: rz3: the indexed layout needs an output file. Writing a sequential trace to STDOUT\n");
+      indexed = false;
+    }
+
+    if (indexed) {
+      fd = open(fname, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+      if (fd < 0) {
+        fprintf(stderr, "ERROR: rz3: failed open of output file "); perror(fname);
+        rz3_error = true;
+        return;
+      }
+      // the header is a gzip member of its own
+      gzf = gzdopen(dup(fd), "w");
+      if (gzf == NULL) {
+        perror("ERROR: rz3: failed gzdopen of output file");
+        rz3_error = true;
+        return;
+      }
+    } else if (fname != NULL) {
       gzf = gzopen(fname, "w");
       if (gzf == NULL) {
         fprintf(stderr, "ERROR: rz3: failed gzopen of output file "); perror(fname);
@@ -205,11 +282,16 @@ rstzip3::rstzip3(const char * fname, const char * mode)
     // write header
     strcpy(header->magic, rz3_hdr_magic);
     header->major_version = rstzip3_major_version;
-    header->minor_version = rstzip3_minor_version;
-    header->reserved16 = 0;
+    header->minor_version = indexed ? rstzip3_minor_version : rstzip3_seq_minor_version;
+    header->flags = indexed ? rz3_hdr_indexed : 0;
+    header->reserved8 = 0;
     header->reserved32 = 0;
     gzwrite(gzf, header, sizeof(rz3_header));
 
+    if (indexed) {
+      gzclose(gzf); gzf = NULL;
+    }
+
     strcpy(shdr->magic, rz3_shdr_magic);
 
     rstf_pre212 = false; // set to true if necessary upon reading rst header record
@@ -282,8 +364,70 @@ rstzip3::rstzip3(const char * fname, const char * mode)
       pre320 = false;
     }
     rstf_pre212 = false; // this variable is ignored during decompression
+
+    if (header->flags & rz3_hdr_indexed) {
+      // sections are read directly from the file, not through gzf
+      gzclose(gzf); gzf = NULL;
+      indexed = true;
+
+      if (fname == NULL) {
+        fprintf(stderr, "ERROR: rz3: indexed traces can not be read from STDIN\n");
+        rz3_error = true;
+        return;
+      }
+      fd = open(fname, O_RDONLY);
+      if ((fd < 0) || !read_index()) {
+        fprintf(stderr, "ERROR: rz3: could not read the section index of %s\n", fname);
+        rz3_error = true;
+        return;
+      }
+    }
   } // compress/decompress?
 
+  init_state();
+
+  if (!c_nd) {
+    // testfp = fopen("/tmp/rz3tmp.rst", "w");
+  } else {
+    testfp = NULL;
+  }
+} // rstzip3::rstzip3(const char * fname, const char * mode)
+
+
+rstzip3::rstzip3(const rz3_header * arg_header)
+{
+  rz3_error = false;
+
+  verbose = false;
+  stats = false;
+  g0_nonzero_warn = false;
+  c_nd = false;
+
+  indexed = true;
+  fd = -1;
+  index = NULL;
+  index_size = index_alloc = 0;
+  index_offset = 0;
+  cur_section = 0;
+  records_out = 0;
+  skip_records = 0;
+  nthreads = 1;
+  pool = NULL;
+
+  header = new rz3_header;
+  *header = *arg_header; // the decoders look at the version
+  gzf = NULL;
+  shdr = new rz3_section_header;
+  pre320 = false;
+  rstf_pre212 = false;
+
+  init_state();
+  testfp = NULL;
+} // rstzip3::rstzip3(const rz3_header * arg_header)
+
+
+void rstzip3::init_state()
+{
   sdata = new rz3_section_data(shdr, pre320);
 
   clear(); // clear prediction-related state variables
@@ -311,12 +455,7 @@ rstzip3::rstzip3(const char * fname, const char * mode)
     perf_stat_totals[i] = 0;
   }
   raw_v64_count=0;
-  if (!c_nd) {
-    // testfp = fopen("/tmp/rz3tmp.rst", "w");
-  } else {
-    testfp = NULL;
-  }
-} // rstzip3::rstzip3(const char * fname, const char * mode)
+} // void rstzip3::init_state()
 
 
 rstzip3::~rstzip3()
@@ -326,8 +465,12 @@ rstzip3::~rstzip3()
       compress_buffer(interface_buffer, interface_buffer_count);
       interface_buffer_count = 0;
     }
+    if (indexed && (fd >= 0)) {
+      write_index();
+    }
   } else {
     // caller did not wait to read all decompressed records. ignore
+    delete pool; pool = NULL;
   }
   if (sdata != NULL) {
     if (verbose) sdata->print_totals();
@@ -346,6 +489,12 @@ rstzip3::~rstzip3()
     gzclose(gzf); gzf = NULL;
   }
 
+  if (fd >= 0) {
+    close(fd); fd = -1;
+  }
+  delete [] index; index = NULL;
+
+  delete header; header = NULL;
   delete shdr; shdr = NULL;
   delete sdata; sdata = NULL;
 
@@ -401,6 +550,14 @@ int rstzip3::compress(rstf_unionT * buf, int nrec)
 
 
 int rstzip3::decompress(rstf_unionT * buf, int nrec)
+{
+  int n = indexed ? decompress_indexed(buf, nrec) : decompress_sequential(buf, nrec);
+  records_out += n;
+  return n;
+} // rstzip3::decompress(rstf_unionT * buf, int nrec)
+
+
+int rstzip3::decompress_sequential(rstf_unionT * buf, int nrec)
 {
   // if there are some records ready to be
   // copied out, copy out as many as possible
@@ -444,7 +601,63 @@ int rstzip3::decompress(rstf_unionT * buf, int nrec)
   // at this point done = nrec.
   return nrec;
 
-} // rstzip3::decompress(rstf_unionT * buf, int nrec)
+} // rstzip3::decompress_sequential(rstf_unionT * buf, int nrec)
+
+
+bool rstzip3::seek(uint64_t nrec)
+{
+  if (c_nd) {
+    return false;
+  }
+
+  if (!indexed) {
+    if (nrec < records_out) {
+      fprintf(stderr, "ERROR: rstzip3::seek(): can not go back to record %lld in a sequential trace\n", (long long) nrec);
+      return false;
+    }
+
+    rstf_unionT * tmp = new rstf_unionT[rz3_bufsize];
+    while (records_out < nrec) {
+      uint64_t left = nrec - records_out;
+      if (decompress(tmp, (left < (uint64_t) rz3_bufsize) ? (int) left : rz3_bufsize) == 0) {
+        break;
+      }
+    }
+    delete [] tmp;
+
+    return (records_out == nrec);
+  }
+
+  // last section starting at or before nrec
+  if (index_size == 0) {
+    return false;
+  }
+  int lo = 0;
+  int hi = index_size;
+  while (hi - lo > 1) {
+    int mid = (lo + hi) / 2;
+    if (index[mid].first_record <= nrec) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  if (nrec >= index[lo].first_record + index[lo].nrecords) {
+    fprintf(stderr, "ERROR: rstzip3::seek(): record %lld is past the end of the trace\n", (long long) nrec);
+    return false;
+  }
+
+  cur_section = lo;
+  skip_records = nrec - index[lo].first_record;
+  interface_buffer_count = 0;
+  records_out = nrec;
+
+  if (pool != NULL) {
+    pool->restart(lo);
+  }
+
+  return true;
+} // bool rstzip3::seek(uint64_t nrec)
 
 
 bool rstzip3::error() {
@@ -463,6 +676,444 @@ void rstzip3::setstats() {
 } // void rstzip3::setstats() {
 
 
+void rstzip3::setthreads(int n) {
+  nthreads = (n < 1) ? 1 : n;
+} // void rstzip3::setthreads(int n)
+
+
+void rstzip3::clear_predictors()
+{
+  clear();
+  rfs_phase = false;
+
+  // per-cpu state is created on first use, and whether it exists is part
+  // of the prediction (eg cpuid). drop it instead of clearing it
+  int i;
+  for (i=0; i<rz3_max_ncpus; i++) {
+    if (tdata[i] != NULL) {
+      delete tdata[i]; tdata[i] = NULL;
+    }
+  }
+} // void rstzip3::clear_predictors()
+
+
+
+/* indexed layout: writing
+ */
+
+bool rstzip3::begin_indexed_section()
+{
+  clear_predictors();
+
+  if (index_size == index_alloc) {
+    index_alloc = index_alloc ? 2*index_alloc : 1024;
+    rz3_index_entry * tmp = new rz3_index_entry[index_alloc];
+    if (index_size) {
+      memcpy(tmp, index, index_size*sizeof(rz3_index_entry));
+    }
+    delete [] index;
+    index = tmp;
+  }
+
+  rz3_index_entry * e = &index[index_size];
+  e->offset = lseek(fd, 0, SEEK_CUR);
+  e->first_record = index_size ? index[index_size-1].first_record + index[index_size-1].nrecords : 0;
+  e->nrecords = 0;
+  e->rawsize = 0;
+
+  // dup'ed descriptors share the file offset: each section ends up right
+  // after the previous member
+  gzf = gzdopen(dup(fd), "w");
+  if (gzf == NULL) {
+    perror("ERROR: rstzip3::begin_indexed_section(): failed gzdopen of output file");
+    rz3_error = true;
+    return false;
+  }
+
+  return true;
+} // bool rstzip3::begin_indexed_section()
+
+
+void rstzip3::end_indexed_section()
+{
+  rz3_index_entry * e = &index[index_size];
+  e->nrecords = shdr->nrecords;
+  e->rawsize = (uint32_t) gztell(gzf);
+
+  gzclose(gzf); gzf = NULL;
+  index_size++;
+} // void rstzip3::end_indexed_section()
+
+
+void rstzip3::write_index()
+{
+  index_offset = lseek(fd, 0, SEEK_CUR);
+
+  gzFile igzf = gzdopen(dup(fd), "w");
+  if (igzf == NULL) {
+    perror("ERROR: rstzip3::write_index(): failed gzdopen of output file");
+    rz3_error = true;
+    return;
+  }
+
+  rz3_index_header ih;
+  bzero(&ih, sizeof(ih));
+  strcpy(ih.magic, rz3_idx_magic);
+  ih.nsections = SWAP_WORD(index_size);
+  gzwrite(igzf, &ih, sizeof(ih));
+
+  int i;
+  for (i=0; i<index_size; i++) {
+    rz3_index_entry e;
+    e.offset = SWAP_LONG(index[i].offset);
+    e.first_record = SWAP_LONG(index[i].first_record);
+    e.nrecords = SWAP_WORD(index[i].nrecords);
+    e.rawsize = SWAP_WORD(index[i].rawsize);
+    gzwrite(igzf, &e, sizeof(e));
+  }
+  gzclose(igzf);
+
+  rz3_index_trailer t;
+  bzero(&t, sizeof(t));
+  strcpy(t.magic, rz3_trailer_magic);
+  t.index_offset = SWAP_LONG(index_offset);
+  if (write(fd, &t, sizeof(t)) != sizeof(t)) {
+    perror("ERROR: rstzip3::write_index(): could not write the index trailer");
+    rz3_error = true;
+  }
+} // void rstzip3::write_index()
+
+
+/* indexed layout: reading
+ */
+
+bool rstzip3::read_index()
+{
+  struct stat st;
+  if ((fstat(fd, &st) != 0) || (st.st_size < (off_t) sizeof(rz3_index_trailer))) {
+    return false;
+  }
+
+  rz3_index_trailer t;
+  if (pread(fd, &t, sizeof(t), st.st_size - sizeof(t)) != sizeof(t)) {
+    return false;
+  }
+  if (strncmp(t.magic, rz3_trailer_magic, sizeof(t.magic)) != 0) {
+    fprintf(stderr, "ERROR: rz3: index trailer not found (truncated trace?)\n");
+    return false;
+  }
+  index_offset = SWAP_LONG(t.index_offset);
+
+  if (lseek(fd, index_offset, SEEK_SET) != (off_t) index_offset) {
+    return false;
+  }
+  gzFile igzf = gzdopen(dup(fd), "r");
+  if (igzf == NULL) {
+    return false;
+  }
+
+  rz3_index_header ih;
+  if ((gzread(igzf, &ih, sizeof(ih)) != sizeof(ih)) || strcmp(ih.magic, rz3_idx_magic)) {
+    fprintf(stderr, "ERROR: rz3: index magic string mismatch\n");
+    gzclose(igzf);
+    return false;
+  }
+
+  index_size = index_alloc = SWAP_WORD(ih.nsections);
+  index = new rz3_index_entry[index_alloc ? index_alloc : 1];
+
+  int i;
+  for (i=0; i<index_size; i++) {
+    rz3_index_entry e;
+    if (gzread(igzf, &e, sizeof(e)) != sizeof(e)) {
+      gzclose(igzf);
+      return false;
+    }
+    index[i].offset = SWAP_LONG(e.offset);
+    index[i].first_record = SWAP_LONG(e.first_record);
+    index[i].nrecords = SWAP_WORD(e.nrecords);
+    index[i].rawsize = SWAP_WORD(e.rawsize);
+  }
+  gzclose(igzf);
+
+  if (verbose) {
+    fprintf(stderr, "rz3: %d indexed sections\n", index_size);
+  }
+
+  return true;
+} // bool rstzip3::read_index()
+
+
+uint64_t rstzip3::section_zsize(int k)
+{
+  uint64_t next = (k+1 < index_size) ? index[k+1].offset : index_offset;
+  return next - index[k].offset;
+} // uint64_t rstzip3::section_zsize(int k)
+
+
+// thread safe as long as each thread has its own rstzip3 (pread, no shared offset)
+int rstzip3::decompress_section(int arg_fd, const rz3_index_entry * e, uint64_t zsize, rstf_unionT * rstbuf)
+{
+  if (verbose) fprintf(stderr, "Section %d\n", nsections);
+
+  uint8_t * zbuf = new uint8_t [zsize];
+  uint8_t * raw = new uint8_t [e->rawsize];
+  int n = 0;
+
+  bool ok = ((uint64_t) pread(arg_fd, zbuf, zsize, e->offset) == zsize);
+  if (ok) {
+    z_stream zs;
+    bzero(&zs, sizeof(zs));
+    ok = (inflateInit2(&zs, 16+MAX_WBITS) == Z_OK); // gzip member
+    if (ok) {
+      zs.next_in = zbuf;
+      zs.avail_in = zsize;
+      zs.next_out = raw;
+      zs.avail_out = e->rawsize;
+      ok = (inflate(&zs, Z_FINISH) == Z_STREAM_END) && (zs.total_out == e->rawsize);
+      inflateEnd(&zs);
+    }
+  }
+
+  const uint8_t * p = raw;
+  const uint8_t * end = raw + e->rawsize;
+  if (ok && shdr->read(p, end) && ((uint32_t) shdr->nrecords == e->nrecords)) {
+    sdata->clear();
+    if (sdata->read(p, end)) {
+      clear_predictors();
+      bzero(rstbuf, shdr->nrecords*sizeof(rstf_unionT));
+      decompress_records(rstbuf);
+      n = shdr->nrecords;
+    }
+  }
+
+  delete [] zbuf;
+  delete [] raw;
+
+  if (n == 0) {
+    fprintf(stderr, "ERROR: rstzip3::decompress_section(): corrupted section at offset %lld\n", (long long) e->offset);
+    rz3_error = true;
+  }
+  return n;
+} // int rstzip3::decompress_section()
+
+
+rz3_section_pool::rz3_section_pool(rstzip3 * arg_owner, int arg_nthreads)
+{
+  owner = arg_owner;
+  nthreads = arg_nthreads;
+  depth = 2*nthreads;
+
+  slots = new slot_t[depth];
+  int i;
+  for (i=0; i<depth; i++) {
+    slots[i].buf = new rstf_unionT[rz3_bufsize];
+    slots[i].section = -1;
+    slots[i].nrecords = 0;
+    slots[i].ready = false;
+  }
+
+  next_job = next_out = owner->cur_section;
+  generation = 0;
+  stop = false;
+
+  pthread_mutex_init(&mutex, NULL);
+  pthread_cond_init(&cond, NULL);
+
+  decoders = new rstzip3 * [nthreads];
+  threads = new pthread_t[nthreads];
+  nstarted = 0;
+  nworkers = 0;
+  for (i=0; i<nthreads; i++) {
+    decoders[i] = new rstzip3(owner->header);
+  }
+  for (i=0; i<nthreads; i++) {
+    if (pthread_create(&threads[i], NULL, worker, this) != 0) {
+      break;
+    }
+    nstarted++;
+  }
+  if (nstarted == 0) {
+    fprintf(stderr, "Warning: rz3: could not create decompression threads\n");
+  }
+} // rz3_section_pool::rz3_section_pool()
+
+
+rz3_section_pool::~rz3_section_pool()
+{
+  pthread_mutex_lock(&mutex);
+  stop = true;
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+
+  int i;
+  for (i=0; i<nstarted; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  pthread_mutex_destroy(&mutex);
+  pthread_cond_destroy(&cond);
+
+  for (i=0; i<nthreads; i++) {
+    delete decoders[i];
+  }
+  for (i=0; i<depth; i++) {
+    delete [] slots[i].buf;
+  }
+  delete [] decoders;
+  delete [] threads;
+  delete [] slots;
+} // rz3_section_pool::~rz3_section_pool()
+
+
+void * rz3_section_pool::worker(void * arg)
+{
+  ((rz3_section_pool *) arg)->work();
+  return NULL;
+} // void * rz3_section_pool::worker(void * arg)
+
+
+void rz3_section_pool::work()
+{
+  pthread_mutex_lock(&mutex);
+  rstzip3 * dec = decoders[nworkers++];
+
+  while (true) {
+    while (!stop && ((next_job >= owner->index_size) || (next_job >= next_out + depth)
+                     || (slots[next_job % depth].section != -1))) {
+      pthread_cond_wait(&cond, &mutex);
+    }
+    if (stop) {
+      break;
+    }
+
+    int k = next_job++;
+    slot_t * s = &slots[k % depth];
+    s->section = k;
+    s->ready = false;
+    int gen = generation;
+    pthread_mutex_unlock(&mutex);
+
+    int n = dec->decompress_section(owner->fd, &owner->index[k], owner->section_zsize(k), s->buf);
+
+    pthread_mutex_lock(&mutex);
+    if (gen != generation) {
+      s->section = -1; // restarted meanwhile
+    } else {
+      s->nrecords = n;
+      s->ready = true;
+    }
+    pthread_cond_broadcast(&cond);
+  }
+
+  pthread_mutex_unlock(&mutex);
+} // void rz3_section_pool::work()
+
+
+void rz3_section_pool::restart(int section)
+{
+  pthread_mutex_lock(&mutex);
+
+  generation++;
+  int i;
+  for (i=0; i<depth; i++) {
+    if (slots[i].ready) {
+      slots[i].section = -1;
+      slots[i].ready = false;
+    } // else busy: freed by its worker
+  }
+  next_job = next_out = section;
+
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+} // void rz3_section_pool::restart(int section)
+
+
+// waits for the section, and swaps its buffer with buf
+int rz3_section_pool::get(int section, rstf_unionT * & buf)
+{
+  pthread_mutex_lock(&mutex);
+
+  slot_t * s = &slots[section % depth];
+  while (!(s->ready && (s->section == section))) {
+    pthread_cond_wait(&cond, &mutex);
+  }
+
+  int n = s->nrecords;
+  rstf_unionT * tmp = s->buf;
+  s->buf = buf;
+  buf = tmp;
+
+  s->section = -1;
+  s->ready = false;
+  next_out = section + 1;
+
+  pthread_cond_broadcast(&cond);
+  pthread_mutex_unlock(&mutex);
+
+  return n;
+} // int rz3_section_pool::get(int section, rstf_unionT * & buf)
+
+
+int rstzip3::next_indexed_section()
+{
+  if (cur_section >= index_size) {
+    return 0;
+  }
+
+  if ((nthreads > 1) && (pool == NULL)) {
+    pool = new rz3_section_pool(this, nthreads);
+    if (pool->nstarted == 0) {
+      delete pool; pool = NULL;
+      nthreads = 1;
+    }
+  }
+
+  int n;
+  if (pool != NULL) {
+    n = pool->get(cur_section, interface_buffer);
+  } else {
+    n = decompress_section(fd, &index[cur_section], section_zsize(cur_section), interface_buffer);
+  }
+  if (n == 0) {
+    rz3_error = true;
+    return 0;
+  }
+  cur_section++;
+
+  interface_buffer_size = n;
+  interface_buffer_count = n;
+
+  // seek() into the middle of this section
+  if (skip_records) {
+    int skip = (skip_records < (uint64_t) n) ? (int) skip_records : n;
+    interface_buffer_count -= skip;
+    skip_records -= skip;
+  }
+
+  return n;
+} // int rstzip3::next_indexed_section()
+
+
+int rstzip3::decompress_indexed(rstf_unionT * buf, int nrec)
+{
+  int done = 0;
+  while (done < nrec) {
+    if ((interface_buffer_count == 0) && (next_indexed_section() == 0)) {
+      break;
+    }
+
+    int n = interface_buffer_count;
+    if (n > (nrec-done)) n = (nrec-done);
+
+    memcpy(buf+done, interface_buffer+(interface_buffer_size-interface_buffer_count), n*sizeof(rstf_unionT));
+    interface_buffer_count -= n;
+    done += n;
+  }
+
+  return done;
+} // int rstzip3::decompress_indexed(rstf_unionT * buf, int nrec)
+
 
 void rstzip3::clear()
 {
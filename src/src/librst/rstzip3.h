@@ -43,8 +43,12 @@
 
 
 static const int rstzip3_major_version = 3;
-static const int rstzip3_minor_version = 20;
-static const char rstzip3_version_str[] = "rstzip v3.20";
+static const int rstzip3_minor_version = 21;
+static const char rstzip3_version_str[] = "rstzip v3.21";
+
+// v3.21 only adds the indexed layout (below). Sequential traces are still
+// tagged v3.20, so older builds keep reading them
+static const int rstzip3_seq_minor_version = 20;
 
 // try to fit an RST buffer in less than half of the external cache (8MB)
 // 2400KB => 100K rst records. We use 128K records as the buffer size
@@ -63,18 +67,60 @@ struct rz3_header {
   uint8_t major_version;
   uint8_t minor_version;
 
-  uint16_t reserved16;
+  uint8_t flags; // rz3_hdr_* bits. was reserved16 in v3.20 and older
+  uint8_t reserved8;
   uint32_t reserved32;
 }; // struct rz3_header
 
+static const uint8_t rz3_hdr_indexed = 0x1;
+
+
+/* indexed layout (v3.21, written with the "indexed=1" option)
+ *
+ * The predictors are cleared at the start of every section, and every
+ * section is a gzip member of its own. Any section can be decompressed
+ * without the ones before it: by several threads at once, or starting in
+ * the middle of the trace. The rz3 header is the first member, and the
+ * section table is the last one, followed by an uncompressed trailer:
+ *
+ *   header | section 0 | ... | section n-1 | index | rz3_index_trailer
+ *
+ * gzread() sees the header as usual, so version detection does not change.
+ * Multi-byte fields of the index are big endian, like the section headers.
+ */
+#define rz3_idx_magic "RZ3 INDEX 0001$"
+#define rz3_trailer_magic "RZ3IDX$"
+
+struct rz3_index_header {
+  char magic[16];
+  uint32_t nsections;
+  uint32_t reserved32;
+}; // struct rz3_index_header
+
+struct rz3_index_entry {
+  uint64_t offset;       // of the gzip member in the file
+  uint64_t first_record;
+  uint32_t nrecords;
+  uint32_t rawsize;      // uncompressed size of the member
+}; // struct rz3_index_entry
+
+struct rz3_index_trailer {
+  char magic[8];
+  uint64_t index_offset;
+}; // struct rz3_index_trailer
+
 
 static const int rz3_max_ncpus = 1<<10;
 
 static const uint64_t rz3_amask_mask = ((1ull<<32)-1);
 
+struct rz3_section_pool;
+
 class rstzip3 {
  public:
-  rstzip3(const char * fname, const char * mode);
+  // indexed only applies to compression, the decompressor reads the
+  // layout from the header
+  rstzip3(const char * fname, const char * mode, bool indexed = false);
 
   ~rstzip3();
 
@@ -94,12 +140,39 @@ class rstzip3 {
 
   int decompress(rstf_unionT * buf, int nrec);
 
+  // position the trace so that the next decompress() returns record
+  // number nrec. Indexed traces go to any record; sequential ones can only
+  // move forward, by decompressing and dropping the records in between
+  bool seek(uint64_t nrec);
+
   bool error();
 
   void setverbose();
   void setstats();
 
+  // sections decompressed in parallel (indexed traces only). Call before
+  // the first decompress()
+  void setthreads(int n);
+
 private:
+  friend struct rz3_section_pool;
+
+  rstzip3(const rz3_header * arg_header); // section decoder of the thread pool
+
+  void init_state();
+  void clear_predictors(); // clear() and drop all per-cpu state
+
+  bool begin_indexed_section();
+  void end_indexed_section();
+  void write_index();
+  bool read_index();
+
+  uint64_t section_zsize(int k);
+  int next_indexed_section();
+  int decompress_sequential(rstf_unionT * buf, int nrec);
+  int decompress_indexed(rstf_unionT * buf, int nrec);
+  int decompress_section(int fd, const rz3_index_entry * e, uint64_t zsize, rstf_unionT * rstbuf);
+
   int compress_buffer(rstf_unionT * rstbuf, int rstbufsize);
   void compress_inst(rstf_unionT * rstbuf, int idx);
   void compress_dcti(rstf_unionT * rstbuf, int idx, struct rz3iu_icache_data * icdata);
@@ -119,6 +192,7 @@ private:
   bool regen_value(rstf_regvalT *vr, int idx);
 
   int decompress_buffer(rstf_unionT * rstbuf, int rstbufsize);
+  void decompress_records(rstf_unionT * rstbuf);
   void decompress_inst(rstf_unionT * rstbuf, int idx);
   void decompress_dcti(rstf_unionT * rstbuf, int idx, struct rz3iu_icache_data * icdata);
   void decompress_pavadiff(rstf_unionT * rstbuf, int idx);
@@ -161,6 +235,19 @@ private:
 
   bool rz3_error;
 
+  // indexed layout. gzf is only open while a section is written
+  bool indexed;
+  int fd;
+  rz3_index_entry * index;
+  int index_size;
+  int index_alloc;
+  uint64_t index_offset;
+  int cur_section;              // next one to decompress
+  uint64_t records_out;         // returned by decompress() so far
+  uint64_t skip_records;        // to drop from the next section (seek)
+  int nthreads;
+  rz3_section_pool * pool;
+
   int nsections; // incremented every time a section is completed and written out, or read in and decompressed
 
   // int n_cpuids;
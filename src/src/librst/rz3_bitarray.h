@@ -171,7 +171,12 @@ class rz3_bitarray {
   {
     int n_u64 = (nbits+63)/64;
     uint64_t sz = n_u64*sizeof(uint64_t);
-    memcpy(membuf, u64, sz);
+
+    // same byte order as CopyFrom()
+    for (int j=0; j<n_u64; j++) {
+      uint64_t v = SWAP_LONG(u64[j]);
+      memcpy(membuf + j*sizeof(uint64_t), &v, sizeof(uint64_t));
+    }
     return sz;
   }
 
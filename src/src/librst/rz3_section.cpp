@@ -37,9 +37,20 @@ void rz3_section_header::clear() {
 } // rz3_section_header::clear()
 
 bool rz3_section_header::write(gzFile gzf) {
-  return (gzwrite(gzf, this, sizeof(rz3_section_header)) == sizeof(rz3_section_header));
+  // same byte order as read()
+  rz3_section_header h = *this;
+  h.byteswap();
+  return (gzwrite(gzf, &h, sizeof(rz3_section_header)) == sizeof(rz3_section_header));
 } // bool rz3_section_header::write(gzFile gzf)
 
+void rz3_section_header::byteswap() {
+  nrecords = SWAP_WORD(nrecords);
+  CompressedBufferSize = SWAP_LONG(CompressedBufferSize);
+  for (int j=0; j<rstzip3::bitarray_count; j++) {
+    rz3_bitarray_counts[j] = SWAP_WORD(rz3_bitarray_counts[j]);
+  }
+} // void rz3_section_header::byteswap()
+
 
 bool rz3_section_header::read(gzFile gzf) {
   int bytes_read = gzread(gzf, this, sizeof(rz3_section_header));
@@ -58,14 +69,7 @@ bool rz3_section_header::read(gzFile gzf) {
 
   //jan {
   //Need to swap multi-byte values on little endian machines
-  nrecords = SWAP_WORD(nrecords);
-  CompressedBufferSize = SWAP_LONG(CompressedBufferSize);
-  //fprintf(stderr, "NRECORDS: %x;\nCOMPRESSEDBUFFERSIZE: %llx;\n", nrecords, CompressedBufferSize);
-
-  for (int j=0; j<rstzip3::bitarray_count; j++) {
-    rz3_bitarray_counts[j] = SWAP_WORD(rz3_bitarray_counts[j]);
-    //fprintf(stderr, "J: %d; BITARRAYCOUNTS: %x;\n", j, rz3_bitarray_counts[j]);
-  }
+  byteswap();
   //jan }
 
   // sanity checks
@@ -74,6 +78,19 @@ bool rz3_section_header::read(gzFile gzf) {
 
 } // bool rz3_section_header::read(gzFile gzf)
 
+bool rz3_section_header::read(const uint8_t * & p, const uint8_t * end) {
+  if ((uint64_t)(end - p) < sizeof(rz3_section_header)) {
+    fprintf(stderr, "rz3_section_header::read() - truncated section (%d bytes left)\n", (int)(end - p));
+    return false;
+  }
+
+  memcpy(this, p, sizeof(rz3_section_header));
+  p += sizeof(rz3_section_header);
+  byteswap();
+
+  return sanity_check();
+} // bool rz3_section_header::read(const uint8_t * & p, const uint8_t * end)
+
 bool rz3_section_header::sanity_check() {
   // check magic number
   if ((magic[0] == 0) || strcmp(magic, rz3_shdr_magic)) {
@@ -327,6 +344,26 @@ bool rz3_section_data::read(FILE * fp)
   return true;
 }
 
+bool rz3_section_data::read(const uint8_t * & p, const uint8_t * end)
+{
+  int i;
+  for (i=0; i<rstzip3::bitarray_count; i++) {
+    uint64_t sz = bitarrays[i]->ComputeMemBufSize(shdr->rz3_bitarray_counts[i]);
+    if ((uint64_t)(end - p) < sz) {
+      fprintf(stderr, "rz3_section_data: truncated section reading %s\n", rstzip3::bitarray_descr[i].name);
+      return false;
+    }
+    uint64_t bytes_copied = bitarrays[i]->CopyFrom((unsigned char *) p, shdr->rz3_bitarray_counts[i]);
+    if (bytes_copied != sz) {
+      fprintf(stderr, "rz3_section_data: error reading %lld bytes into %s", sz, rstzip3::bitarray_descr[i].name);
+      return false;
+    }
+    p += sz;
+  } // for each array
+
+  return true;
+}
+
 rz3_percpu_data::rz3_percpu_data(int arg_cpuid) {
 
   cpuid = arg_cpuid;
@@ -57,7 +57,12 @@ struct rz3_section_header {
 
   bool read(FILE * fp);
 
+  // from memory (indexed layout). advances p
+  bool read(const uint8_t * & p, const uint8_t * end);
+
   bool sanity_check();
+
+  void byteswap(); // the file is big endian
 }; // struct rz3_section_header
 
 
@@ -95,6 +100,8 @@ struct rz3_section_data {
 
   bool read(FILE * fp);
 
+  bool read(const uint8_t * & p, const uint8_t * end);
+
   rz3_section_header * shdr;
 
   uint64_t total_nrecords;
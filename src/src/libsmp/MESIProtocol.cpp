@@ -272,9 +272,12 @@ void MESIProtocol::readMissAckHandler(SMPMemRequest *sreq)
   if(sreq->getState() == MESI_INVALID && l->getState() == MESI_TRANS_RD) {
     I(!sreq->isFound());
     changeState(l, MESI_TRANS_RD_MEM);
-    sreq->noSnoop();
-    pCache->sendBelow(sreq); // miss delay may be counted twice
-    return;
+    // a directory may have gone to memory already (noSnoop)
+    if(sreq->needsSnoop()) {
+      sreq->noSnoop();
+      pCache->sendBelow(sreq); // miss delay may be counted twice
+      return;
+    }
   }
   
   if(sreq->getState() == MESI_INVALID) {
@@ -301,9 +304,11 @@ void MESIProtocol::writeMissAckHandler(SMPMemRequest *sreq)
   if(sreq->getState() == MESI_INVALID && l->getState() == MESI_TRANS_WR) {
     I(!sreq->isFound());
     changeState(l, MESI_TRANS_WR_MEM);
-    sreq->noSnoop();
-    pCache->sendBelow(sreq);
-    return;
+    if(sreq->needsSnoop()) {
+      sreq->noSnoop();
+      pCache->sendBelow(sreq);
+      return;
+    }
   }
 
   I(l->getState() == MESI_TRANS_WR || l->getState() == MESI_TRANS_WR_MEM);
@@ -59,6 +59,11 @@ public:
   void makeDirty(Line *l);
   void preInvalidate(Line *l);
 
+  // no sharers information: reads get a shared copy
+  unsigned getFFState(bool write) const {
+    return write ? MESI_MODIFIED : MESI_SHARED;
+  }
+
   void read(MemRequest *mreq);
   void doRead(MemRequest *mreq);
   typedef CallbackMember1<MESIProtocol, MemRequest *, 
@@ -25,6 +25,10 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "MESIProtocol.h"
 
+#if (defined TM)
+#include "transCoherence.h"
+#endif
+
 // This cache works under the assumption that caches above it in the memory
 // hierarchy are write-through caches
 
@@ -64,6 +68,7 @@ SMPCache::SMPCache(SMemorySystem *dms, const char *section, const char *name)
   , writeRetry("%s:writeRetry", name)
   , invalDirty("%s:invalDirty", name)
   , allocDirty("%s:allocDirty", name)
+  , ffWriteBacks("%s:ffWriteBack", name)
 {
   MemObj *lowerLevel = NULL;
 
@@ -137,6 +142,10 @@ SMPCache::SMPCache(SMemorySystem *dms, const char *section, const char *name)
                                  ,MemPower
                                  ,EnergyMgr::get(section,"wrMissEnergy"));
 #endif
+
+#if (defined TM)
+  initTMOverflow(section, name);
+#endif
 }
 
 SMPCache::~SMPCache() 
@@ -210,6 +219,9 @@ void SMPCache::doRead(MemRequest *mreq)
 #ifdef SESC_ENERGY
     rdEnergy[0]->inc();
 #endif    
+#if (defined TM)
+    markSpec(mreq, l);
+#endif
     outsReq->retire(addr);
     mreq->goUp(hitDelay);
     return;
@@ -271,6 +283,9 @@ void SMPCache::doWrite(MemRequest *mreq)
     wrEnergy[0]->inc();
 #endif
     protocol->makeDirty(l);
+#if (defined TM)
+    markSpec(mreq, l);
+#endif
     outsReq->retire(addr);
     mreq->goUp(hitDelay);  
     return;
@@ -397,6 +412,7 @@ void SMPCache::realInvalidate(PAddr addr, ushort size, bool writeBack)
 	  doWriteBack(addr);
       } 
       l->invalidate();
+      notifyDrop(addr);
     }
     addr += cache->getLineSize();
     size -= cache->getLineSize();
@@ -505,11 +521,18 @@ void SMPCache::concludeAccess(MemRequest *mreq)
                               mreq->goDown(), so we can't rely on
                               mreq->goUp() to restore the memOp.
                             */
+#if (defined TM)
+  markSpec(mreq, cache->findLineNoEffect(addr));
+#endif
+
   mreq->goUp(0);
 
   outsReq->retire(addr);
   mutExclBuffer->retire(addr);
 
+  if (!pendBackInv.empty() && pendBackInv.find(calcTag(addr)) != pendBackInv.end())
+    backInvalidate(addr);
+
 }
 
 SMPCache::Line *SMPCache::allocateLine(PAddr addr, CallbackBase *cb, 
@@ -521,6 +544,7 @@ SMPCache::Line *SMPCache::allocateLine(PAddr addr, CallbackBase *cb,
 
   if(!l) {
     // need to schedule allocate line for next cycle
+    pendAlloc.insert(calcTag(addr));
     doAllocateLineCB::scheduleAbs(globalClock+1, this, addr, 0, cb);
     return 0;
   }
@@ -536,6 +560,10 @@ SMPCache::Line *SMPCache::allocateLine(PAddr addr, CallbackBase *cb,
     l->setTag(cache->calcTag(addr));
     return l;
   }
+
+#if (defined TM)
+  specEviction(l, rpl_addr);
+#endif
   
   if(isHighestLevel()) {
     if(l->isDirty()) {
@@ -546,10 +574,13 @@ SMPCache::Line *SMPCache::allocateLine(PAddr addr, CallbackBase *cb,
     if(canDestroyCB)
       cb->destroy();
     l->invalidate();
+    notifyDrop(rpl_addr);
     l->setTag(cache->calcTag(addr));
     return l;
   }
 
+  pendAlloc.insert(calcTag(addr));
+
   I(pendInvTable.find(rpl_addr) == pendInvTable.end());
   pendInvTable[rpl_addr].outsResps = getNumCachesInUpperLevels();
   pendInvTable[rpl_addr].cb = doAllocateLineCB::create(this, addr, rpl_addr, cb);
@@ -576,6 +607,8 @@ void SMPCache::doAllocateLine(PAddr addr, PAddr rpl_addr, CallbackBase *cb)
   // returns a line, then the line was successfully allocated, and all
   // that's left is to call the callback allocateLine has initially
   // received as a parameter
+  pendAlloc.erase(calcTag(addr));
+
   if(!rpl_addr) {
     Line *l = allocateLine(addr, cb, false);
 
@@ -596,6 +629,7 @@ void SMPCache::doAllocateLine(PAddr addr, PAddr rpl_addr, CallbackBase *cb)
     allocDirty.inc();
     doWriteBack(rpl_addr);
   }
+  notifyDrop(rpl_addr);
 
   I(cb);
   l->setTag(cache->calcTag(addr));
@@ -603,6 +637,182 @@ void SMPCache::doAllocateLine(PAddr addr, PAddr rpl_addr, CallbackBase *cb)
   cb->call();
 }
 
+int SMPCache::ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst)
+{
+  // a hit must refresh the LRU order, like a detailed access
+  Line *l = cache->findLine(addr);
+
+  if (l && l->isLocked())
+    return 0; // a detailed request owns it
+
+  if (l == 0 && !pendAlloc.empty() && pendAlloc.find(calcTag(addr)) != pendAlloc.end())
+    return 0; // a detailed request is allocating it
+
+  unsigned state = protocol->getFFState(write);
+
+  if (l && (write ? l->canBeWritten() : l->canBeRead())) {
+    if (write && state != SMP_INVALID)
+      l->changeStateTo(state);
+#if (defined TM)
+    markSpec(dinst, write, l);
+#endif
+    return 0;
+  }
+
+  // make room before the lower levels see the new line
+  if (l == 0 && state != SMP_INVALID) {
+    l = cache->findLine2Replace(addr);
+    if (l && l->isValid())
+      ffReplace(l);
+  }
+
+  int lev = 1;
+  if (!lowerLevel.empty())
+    lev += lowerLevel[0]->ffAccess(addr, write, this, dinst);
+
+  if (l == 0) {
+    // all locked, do not keep it
+    notifyDrop(addr);
+    return lev;
+  }
+
+  if (state == SMP_INVALID)
+    return lev;
+
+  if (!l->isValid())
+    l->setTag(cache->calcTag(addr));
+  l->changeStateTo(state);
+#if (defined TM)
+  markSpec(dinst, write, l);
+#endif
+
+  return lev;
+}
+
+void SMPCache::ffReplace(Line *l)
+{
+  PAddr rpl_addr = cache->calcAddr4Tag(l->getTag());
+
+#if (defined TM)
+  specEviction(l, rpl_addr);
+#endif
+
+  bool dirty = l->isDirty();
+  if (!isHighestLevel() && ffInvUpperLevel(rpl_addr))
+    dirty = true;
+
+  l->invalidate();
+  notifyDrop(rpl_addr);
+
+  if (dirty) {
+    ffWriteBacks.inc();
+    MemObj::ffWriteBack(rpl_addr); // to the lower level
+  }
+}
+
+void SMPCache::ffWriteBack(PAddr addr)
+{
+  Line *l = cache->findLineNoEffect(addr);
+  unsigned state = protocol->getFFState(true);
+
+  if (l && l->isValid() && !l->isLocked() && state != SMP_INVALID) {
+    l->changeStateTo(state);
+    return;
+  }
+
+  MemObj::ffWriteBack(addr);
+}
+
+bool SMPCache::ffInvalidate(PAddr addr)
+{
+  bool dirty = ffInvUpperLevel(addr);
+
+  Line *l = cache->findLineNoEffect(addr);
+  if (l == 0 || !l->isValid())
+    return dirty;
+
+  if (l->isLocked()) {
+    // dropped when its request concludes
+    pendBackInv.insert(calcTag(addr));
+    return dirty;
+  }
+
+#if (defined TM)
+  specEviction(l, addr);
+#endif
+
+  if (l->isDirty())
+    dirty = true;
+  l->invalidate();
+  notifyDrop(addr);
+
+  return dirty;
+}
+
+int SMPCache::ffLevel(PAddr addr)
+{
+  Line *l = cache->findLineNoEffect(addr);
+  if (l && l->isValid())
+    return 0;
+
+  if (lowerLevel.empty())
+    return 1;
+
+  return 1 + lowerLevel[0]->ffLevel(addr);
+}
+
+void SMPCache::ffSnoop(PAddr addr, bool write)
+{
+  Line *l = cache->findLineNoEffect(addr);
+  if (l == 0 || !l->isValid() || l->isLocked())
+    return;
+
+  unsigned state = protocol->getFFState(false);
+
+  if (write) {
+    // the writer gets the data, the upper levels lose it too
+    ffInvUpperLevel(addr);
+    l->invalidate();
+    notifyDrop(addr);
+  } else if (l->canBeWritten() && state != SMP_INVALID) {
+    if (l->isDirty()) {
+      ffWriteBacks.inc();
+      MemObj::ffWriteBack(addr); // to the lower level
+    }
+    l->changeStateTo(state);
+  }
+}
+
+void SMPCache::notifyDrop(PAddr addr)
+{
+  if (!pendBackInv.empty())
+    pendBackInv.erase(calcTag(addr));
+
+  if (!lowerLevel.empty())
+    lowerLevel[0]->lineDropped(addr, this);
+}
+
+void SMPCache::backInvalidate(PAddr addr)
+{
+  Line *l = cache->findLineNoEffect(addr);
+  if (l == 0)
+    return;
+
+  if (l->isLocked()) {
+    // it ignores the snoops until then, as it does with the broadcast
+    pendBackInv.insert(calcTag(addr));
+    return;
+  }
+
+  nextSlot(); // counts for occupancy to invalidate line
+  if (l->isDirty()) {
+    invalDirty.inc();
+    doWriteBack(addr);
+  }
+  l->invalidate();
+  notifyDrop(addr);
+}
+
 SMPCache::Line *SMPCache::getLine(PAddr addr)
 {
   nextSlot(); 
@@ -636,6 +846,140 @@ void SMPCache::invalidateLine(PAddr addr, CallbackBase *cb, bool writeBack)
   doInvalidate(addr, cache->getLineSize());
 }
 
+#if (defined TM)
+void SMPCache::initTMOverflow(const char *section, const char *name)
+{
+  tmOverflow = TMNone;
+
+  if (!SescConf->checkCharPtr(section, "tmOverflow"))
+    return;
+
+  const char *pol = SescConf->getCharPtr(section, "tmOverflow");
+  if (strcasecmp(pol, "abort") == 0) {
+    tmOverflow = TMAbort;
+  } else if (strcasecmp(pol, "victim") == 0) {
+    tmOverflow = TMVictim;
+  } else if (strcasecmp(pol, "log") == 0) {
+    tmOverflow = TMLog;
+  } else {
+    MSG("%s:unknown tmOverflow [%s] (abort, victim or log)", name, pol);
+    SescConf->notCorrect();
+    return;
+  }
+
+  tmVictimSize = 8;
+  if (SescConf->checkInt(section, "tmVictimSize")) {
+    SescConf->isGT(section, "tmVictimSize", 0);
+    tmVictimSize = SescConf->getInt(section, "tmVictimSize");
+  }
+  tmLogDelay = 20;
+  if (SescConf->checkInt(section, "tmLogDelay")) {
+    SescConf->isGT(section, "tmLogDelay", -1);
+    tmLogDelay = SescConf->getInt(section, "tmLogDelay");
+  }
+
+  tmOverflowRd = new GStatsCntr("%s:tmOverflowRd", name);
+  tmOverflowWr = new GStatsCntr("%s:tmOverflowWr", name);
+  tmAborts     = new GStatsCntr("%s:tmOverflowAborts", name);
+  tmVictimFull = new GStatsCntr("%s:tmVictimFull", name);
+  tmLogStall   = new GStatsCntr("%s:tmLogStallCycles", name);
+  tmVictimMax  = new GStatsMax("%s:tmVictimMax", name);
+}
+
+void SMPCache::markSpec(DInst *dinst, bool write, Line *l)
+{
+  // the processor requests only reach the highest level with their
+  // DInst
+  if (tmOverflow == TMNone || l == 0 || !isHighestLevel())
+    return;
+
+  if (dinst == 0 || dinst->transType == transNT)
+    return;
+
+  int pid = dinst->transPid;
+  long long utid = transGCM->getRunningUtid(pid);
+  if (utid < 0)
+    return;
+
+  if (l->specUtid != utid || l->specPid != pid) {
+    l->specUtid  = utid;
+    l->specPid   = pid;
+    l->specRead  = false;
+    l->specWrite = false;
+
+    // the line is back in the cache
+    for(size_t i = 0; i < tmVictims.size(); i++) {
+      if (tmVictims[i].tag == l->getTag() && tmVictims[i].pid == pid) {
+        tmVictims.erase(tmVictims.begin() + i);
+        break;
+      }
+    }
+  }
+
+  if (write)
+    l->specWrite = true;
+  else
+    l->specRead = true;
+}
+
+void SMPCache::specEviction(Line *l, PAddr addr)
+{
+  if (tmOverflow == TMNone || l->specUtid < 0)
+    return;
+
+  int pid        = l->specPid;
+  long long utid = l->specUtid;
+  l->specUtid = -1;
+
+  if (transGCM->getRunningUtid(pid) != utid)
+    return; // the transaction already finished
+
+  if (l->specWrite)
+    tmOverflowWr->inc();
+  else
+    tmOverflowRd->inc();
+
+  switch(tmOverflow) {
+  case TMAbort:
+    tmAborts->inc();
+    transGCM->overflowAbort(pid, addr);
+    break;
+  case TMVictim: {
+    // entries of finished transactions are free
+    size_t j = 0;
+    for(size_t i = 0; i < tmVictims.size(); i++) {
+      if (transGCM->getRunningUtid(tmVictims[i].pid) == tmVictims[i].utid)
+        tmVictims[j++] = tmVictims[i];
+    }
+    tmVictims.resize(j);
+
+    if ((int)tmVictims.size() >= tmVictimSize) {
+      tmVictimFull->inc();
+      tmAborts->inc();
+      transGCM->overflowAbort(pid, addr);
+      break;
+    }
+
+    TMVictimEntry v;
+    v.tag  = l->getTag();
+    v.pid  = pid;
+    v.utid = utid;
+    tmVictims.push_back(v);
+    tmVictimMax->sample(tmVictims.size());
+    break;
+  }
+  case TMLog:
+    if (l->specWrite) {
+      transGCM->addStall(pid, tmLogDelay);
+      tmLogStall->add(tmLogDelay);
+    }
+    break;
+  default:
+    I(0);
+  }
+}
+#endif
+
 #ifdef SESC_SMP_DEBUG
 void SMPCache::inclusionCheck(PAddr addr) {
   const LevelType* la = getUpperLevel();
@@ -73,6 +73,18 @@ protected:
 
   PendInvTable pendInvTable; // pending invalidate table
 
+  // lines to drop when their request concludes (backInvalidate)
+  HASH_SET<PAddr> pendBackInv;
+
+  // lines that wait in doAllocateLine for a free way
+  HASH_SET<PAddr> pendAlloc;
+
+  // tells the lower level that the line is not here anymore
+  void notifyDrop(PAddr addr);
+
+  // functional replacement of a valid line (ffAccess)
+  void ffReplace(Line *l);
+
   // BEGIN statistics
   GStatsCntr readHit;
   GStatsCntr writeHit;
@@ -89,6 +101,7 @@ protected:
 
   GStatsCntr invalDirty;
   GStatsCntr allocDirty;
+  GStatsCntr ffWriteBacks;
 
 #ifdef SESC_ENERGY
   static unsigned cacheID;
@@ -99,6 +112,45 @@ protected:
 
   // END statistics
 
+#if (defined TM)
+  // Bounded HTM (tmOverflow in the cache section). The highest level
+  // cache keeps the read/write set bits of the running transaction;
+  // when one of those lines is displaced:
+  //   abort  : the transaction aborts
+  //   victim : the line goes to a tmVictimSize entries buffer, the
+  //            transaction aborts if it is full
+  //   log    : written lines are logged to memory, the processor
+  //            stalls tmLogDelay cycles. Read lines are kept in a
+  //            signature (no cost)
+  enum TMOverflow { TMNone, TMAbort, TMVictim, TMLog };
+  TMOverflow tmOverflow;
+
+  int tmVictimSize;
+  int tmLogDelay;
+
+  class TMVictimEntry {
+  public:
+    PAddr     tag;
+    int       pid;
+    long long utid;
+  };
+  std::vector<TMVictimEntry> tmVictims;
+
+  GStatsCntr *tmOverflowRd;
+  GStatsCntr *tmOverflowWr;
+  GStatsCntr *tmAborts;
+  GStatsCntr *tmVictimFull;
+  GStatsCntr *tmLogStall;
+  GStatsMax  *tmVictimMax;
+
+  void initTMOverflow(const char *section, const char *name);
+  void markSpec(DInst *dinst, bool write, Line *l);
+  void markSpec(MemRequest *mreq, Line *l) {
+    markSpec(mreq->getDInst(), mreq->getMemOperation() != MemRead, l);
+  }
+  void specEviction(Line *l, PAddr addr);
+#endif
+
   SMPProtocol *protocol;
 
   // interface with upper level
@@ -163,6 +215,16 @@ public:
   void doInvalidate(PAddr addr, ushort size);
   void realInvalidate(PAddr addr, ushort size, bool writeBack);
 
+  // Functional access (MemObj::ffAccess). Replacements follow
+  // allocateLine (TM overflow, write back of dirty lines, upper level
+  // invalidations) without timing. Locked lines and lines waiting in
+  // doAllocateLine are left to the detailed requests
+  int  ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst);
+  int  ffLevel(PAddr addr);
+  void ffSnoop(PAddr addr, bool write);
+  void ffWriteBack(PAddr addr);
+  bool ffInvalidate(PAddr addr);
+
   // END MemObj interface
 
    // BEGIN protocol interface 
@@ -190,6 +252,11 @@ public:
                          &SMPCache::doAllocateLine> doAllocateLineCB;
 
   PAddr calcTag(PAddr addr) { return cache->calcTag(addr); }
+  uint getLineSize() const { return cache->getLineSize(); }
+
+  // Bus snoop filter: the line leaves the cache (dirty lines are written
+  // back). A line with a request in flight leaves when it concludes
+  void backInvalidate(PAddr addr);
 
   // END protocol interface
 
@@ -51,9 +51,22 @@ private:
 protected:
   uint state;
 public:
+#if (defined TM)
+  // read/write set bits of the transaction specUtid running in
+  // specPid. They are stale once that transaction finishes (see
+  // SMPCache::markSpec)
+  long long specUtid;
+  int  specPid;
+  bool specRead;
+  bool specWrite;
+#endif
+
   SMPCacheState() 
       : StateGeneric<>() {
       state = SMP_INVALID;
+#if (defined TM)
+      specUtid = -1;
+#endif
     }
 
     // BEGIN CacheCore interface 
@@ -67,6 +80,9 @@ public:
       GI(isLocked(), (state & SMP_TRANS_BIT) && (state & SMP_INV_BIT));
       clearTag();
       state = SMP_INVALID;
+#if (defined TM)
+      specUtid = -1;
+#endif
     }
     
     bool isLocked() const {
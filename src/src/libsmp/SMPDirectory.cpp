@@ -0,0 +1,430 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <strings.h>
+
+#include "SMPDirectory.h"
+#include "SMPCache.h"
+#include "SMPDebug.h"
+#include "InterConn.h"
+
+/*******************************
+       SMPDirNode
+*******************************/
+
+SMPDirNode::SMPDirNode(SMPDirectory *d, InterConnection *net, RouterID_t rID)
+  : ProtocolBase(net, rID)
+  ,dir(d)
+{
+  ProtocolCBBase *pcb;
+
+  pcb = new ProtocolCB<SMPDirNode, &SMPDirNode::homeHandler>(this);
+  registerHandler(pcb, DirReqRdMsg);
+  registerHandler(pcb, DirReqWrMsg);
+  registerHandler(pcb, DirReqMemMsg);
+  registerHandler(pcb, DirWrBackMsg);
+  registerHandler(pcb, DirAckMsg);
+  registerHandler(pcb, DirDataAckMsg);
+
+  pcb = new ProtocolCB<SMPDirNode, &SMPDirNode::snoopHandler>(this);
+  registerHandler(pcb, DirFwdRdMsg);
+  registerHandler(pcb, DirInvMsg);
+
+  pcb = new ProtocolCB<SMPDirNode, &SMPDirNode::replyHandler>(this);
+  registerHandler(pcb, DirReplyMsg);
+  registerHandler(pcb, DirDataReplyMsg);
+}
+
+void SMPDirNode::homeHandler(Message *msg)
+{
+  dir->homeMsg(static_cast<PMessage *>(msg));
+}
+
+void SMPDirNode::snoopHandler(Message *msg)
+{
+  dir->snoopMsg(static_cast<PMessage *>(msg));
+}
+
+void SMPDirNode::replyHandler(Message *msg)
+{
+  dir->replyMsg(static_cast<PMessage *>(msg));
+}
+
+void SMPDirNode::send(MessageType t, SMPDirNode *dst, MemRequest *mreq, size_t size)
+{
+  PMessage *msg = PMessage::createMsg(t, this, dst, mreq);
+  if (size)
+    msg->setSize(size); // data messages depend on the line size
+
+  sendMsg(msg);
+}
+
+/*******************************
+       SMPDirectory
+*******************************/
+
+SMPDirectory::SMPDirectory(SMemorySystem *dms, const char *section, const char *name)
+  : SMPSystemBus(dms, section, name)
+  ,dirReads("%s:dirReads", name)
+  ,dirWrites("%s:dirWrites", name)
+  ,dirWriteBacks("%s:dirWriteBacks", name)
+  ,dirMemReqs("%s:dirMemReqs", name)
+  ,dirQueued("%s:dirQueued", name)
+{
+  const char *netSection = SescConf->getCharPtr(section, "network");
+
+  lineSize     = 0;
+  log2LineSize = 0;
+
+  // The mesh routing assumes width*width routers, one per cpucore
+  if (strcasecmp(SescConf->getCharPtr(netSection, "type"), "mesh") == 0) {
+    int nCPUs = SescConf->getRecordSize("", "cpucore");
+    int width = SescConf->getInt(netSection, "width");
+    if (width*width != nCPUs) {
+      MSG("%s:mesh width %d in section [%s] does not match the %d cpucore"
+          , name, width, netSection, nCPUs);
+      SescConf->notCorrect();
+      net = 0;
+      return;
+    }
+  }
+
+  net = new InterConnection(netSection);
+
+  for(RouterID_t i = 0; i < net->getnRouters(); i++) {
+    nodes.push_back(new SMPDirNode(this, net, i));
+
+    char portName[100];
+    sprintf(portName, "%s_dir(%d)", name, i);
+    dirPort.push_back(PortGeneric::create(portName,
+                                          SescConf->getInt(section, "numPorts"),
+                                          SescConf->getInt(section, "portOccp")));
+  }
+}
+
+SMPDirectory::~SMPDirectory()
+{
+  // do nothing
+}
+
+void SMPDirectory::initNodes()
+{
+  // upperLevel is complete only after the memory system is built
+  if (upperLevel.size() > DirSharers::MaxCaches) {
+    MSG("%s:too many upper levels (%d), the limit is %d", getSymbolicName()
+        , (int)upperLevel.size(), DirSharers::MaxCaches);
+    exit(-1);
+  }
+
+  for(uint i = 0; i < upperLevel.size(); i++) {
+    if (!upperLevel[i]->isCache()) {
+      MSG("%s:upper level %s is not a cache", getSymbolicName()
+          , upperLevel[i]->getSymbolicName());
+      exit(-1);
+    }
+    upperLevelPos[upperLevel[i]] = i;
+  }
+
+  // a directory entry per line, all the caches must agree on its size
+  lineSize = static_cast<SMPCache *>(upperLevel[0])->getLineSize();
+  for(uint i = 1; i < upperLevel.size(); i++) {
+    if (static_cast<SMPCache *>(upperLevel[i])->getLineSize() != lineSize) {
+      MSG("%s:upper levels %s and %s have different line sizes", getSymbolicName()
+          , upperLevel[0]->getSymbolicName(), upperLevel[i]->getSymbolicName());
+      exit(-1);
+    }
+  }
+  log2LineSize = log2i(lineSize);
+}
+
+Time_t SMPDirectory::getNextFreeCycle() const
+{
+  return globalClock;
+}
+
+void SMPDirectory::access(MemRequest *mreq)
+{
+  SMPMemRequest *sreq = static_cast<SMPMemRequest *>(mreq);
+  MemOperation memOp  = mreq->getMemOperation();
+
+  int pos = getCachePos(sreq->getRequestor());
+  SMPDirNode *src  = getCacheNode(pos);
+  SMPDirNode *home = getHomeNode(mreq->getPAddr());
+
+  if (memOp == MemPush) {
+    src->send(DirWrBackMsg, home, mreq, 4 + lineSize);
+    return;
+  }
+
+  I(memOp == MemRead || memOp == MemReadW || memOp == MemWrite);
+
+  TransTable::iterator it = transTable.find(mreq);
+  if (it != transTable.end()) {
+    // snoop response from one of the caches
+    DirTrans &t = it->second;
+    I(!t.responders.empty());
+
+    int rpos = t.responders.front();
+    t.responders.pop_front();
+
+    if (sreq->getSupplier() == upperLevel[rpos])
+      getCacheNode(rpos)->send(DirDataAckMsg, home, mreq, 3 + lineSize);
+    else
+      getCacheNode(rpos)->send(DirAckMsg, home, mreq, 0);
+    return;
+  }
+
+  if (!sreq->needsSnoop())
+    src->send(DirReqMemMsg, home, mreq, 0);
+  else if (memOp == MemRead)
+    src->send(DirReqRdMsg, home, mreq, 0);
+  else
+    src->send(DirReqWrMsg, home, mreq, 0);
+}
+
+int SMPDirectory::ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst)
+{
+  // the other caches are snooped functionally, keeping them in the
+  // sharer vector is safe (superset)
+  if (src) {
+    int pos = getCachePos(src);
+    dirTable[addr >> log2LineSize].sharers.set(pos);
+  }
+
+  return SMPSystemBus::ffAccess(addr, write, src, dinst);
+}
+
+void SMPDirectory::homeMsg(PMessage *msg)
+{
+  // the directory controller of the home node processes the message
+  PortGeneric *port = dirPort[msg->getDstPB()->getRouterID()];
+
+  doHomeMsgCB::scheduleAbs(port->nextSlot() + delay, this, msg);
+}
+
+void SMPDirectory::doHomeMsg(PMessage *msg)
+{
+  MemRequest *mreq = msg->getMemRequest();
+  MessageType t    = msg->getType();
+
+  msg->garbageCollect();
+
+  switch(t) {
+  case DirReqRdMsg:
+    dirReads.inc();
+    homeRequest(mreq);
+    break;
+  case DirReqWrMsg:
+    dirWrites.inc();
+    homeRequest(mreq);
+    break;
+  case DirReqMemMsg:
+    dirMemReqs.inc();
+    mreq->goDown(0, lowerLevel[0]);
+    break;
+  case DirWrBackMsg: {
+    dirWriteBacks.inc();
+    SMPMemRequest *sreq = static_cast<SMPMemRequest *>(mreq);
+    DirTable::iterator it = dirTable.find(mreq->getPAddr() >> log2LineSize);
+    if (it != dirTable.end()) {
+      it->second.sharers.reset(getCachePos(sreq->getRequestor()));
+      if (it->second.isIdle())
+        dirTable.erase(it);
+    }
+    mreq->goDown(0, lowerLevel[0]);
+    break;
+  }
+  case DirAckMsg:
+  case DirDataAckMsg:
+    // SMPSystemBus counts the responses and calls finalizeRead/Write
+    if (mreq->getMemOperation() == MemRead)
+      SMPSystemBus::doRead(mreq);
+    else
+      SMPSystemBus::doWrite(mreq);
+    break;
+  default:
+    I(0);
+  }
+}
+
+void SMPDirectory::homeRequest(MemRequest *mreq)
+{
+  DirEntry &e = dirTable[mreq->getPAddr() >> log2LineSize];
+
+  if (e.owner) {
+    // the line is busy, served when the current request is answered
+    dirQueued.inc();
+    e.waiting.push_back(mreq);
+    return;
+  }
+
+  e.owner = mreq;
+  startSnoop(mreq);
+}
+
+void SMPDirectory::startSnoop(MemRequest *mreq)
+{
+  SMPMemRequest *sreq = static_cast<SMPMemRequest *>(mreq);
+  I(pendReqsTable.find(mreq) == pendReqsTable.end());
+
+  int pos = getCachePos(sreq->getRequestor());
+  DirEntry &e = dirTable[mreq->getPAddr() >> log2LineSize];
+  I(e.owner == mreq);
+  DirSharers &sharers = e.sharers;
+
+  DirSharers targets = sharers;
+  targets.reset(pos);
+
+  if (mreq->getMemOperation() == MemRead) {
+    sharers.set(pos);
+  } else {
+    // everybody else is invalidated
+    sharers.clear();
+    sharers.set(pos);
+  }
+
+  unsigned numSnoops = 0;
+  for(uint i = 0; i < upperLevel.size(); i++) {
+    if (targets.test(i))
+      numSnoops++;
+  }
+
+  unsigned numBcast = getNumSnoopCaches(sreq);
+  snoopsSent->add(numSnoops);
+  snoopsFiltered->add(numBcast - numSnoops);
+  if (numBcast)
+    snoopsFilteredRatio->msamples(numBcast - numSnoops, numBcast);
+
+  if (numSnoops == 0) {
+    // nobody else has the line
+    finishSnoop(mreq);
+    return;
+  }
+
+  pendReqsTable[mreq] = numSnoops;
+  DirTrans &t = transTable[mreq];
+  t.targets = targets;
+  I(t.responders.empty());
+
+  // one message per node, the node delivers it to all its target caches
+  MessageType mt = mreq->getMemOperation() == MemRead ? DirFwdRdMsg : DirInvMsg;
+  SMPDirNode *home = getHomeNode(mreq->getPAddr());
+
+  for(uint n = 0; n < nodes.size() && n < upperLevel.size(); n++) {
+    for(uint i = n; i < upperLevel.size(); i += nodes.size()) {
+      if (targets.test(i)) {
+        home->send(mt, nodes[n], mreq, 0);
+        break;
+      }
+    }
+  }
+}
+
+void SMPDirectory::snoopMsg(PMessage *msg)
+{
+  MemRequest *mreq = msg->getMemRequest();
+  uint n = msg->getDstPB()->getRouterID();
+
+  msg->garbageCollect();
+
+  TransTable::iterator it = transTable.find(mreq);
+  I(it != transTable.end());
+  DirTrans &t = it->second;
+
+  for(uint i = n; i < upperLevel.size(); i += nodes.size()) {
+    if (t.targets.test(i)) {
+      t.responders.push_back(i);
+      upperLevel[i]->returnAccess(mreq);
+    }
+  }
+}
+
+void SMPDirectory::finalizeRead(MemRequest *mreq)
+{
+  finishSnoop(mreq);
+}
+
+void SMPDirectory::finalizeWrite(MemRequest *mreq)
+{
+  finishSnoop(mreq);
+}
+
+void SMPDirectory::finishSnoop(MemRequest *mreq)
+{
+  SMPMemRequest *sreq = static_cast<SMPMemRequest *>(mreq);
+
+  pendReqsTable.erase(mreq);
+  transTable.erase(mreq);
+
+  if (sreq->needsData() && !sreq->isFound()) {
+    // no cache supplied it, the home asks the memory. noSnoop tells the
+    // requestor that the reply already comes from memory
+    dirMemReqs.inc();
+    sreq->noSnoop();
+    mreq->goDown(0, lowerLevel[0]);
+    return;
+  }
+
+  sendReply(mreq, sreq->needsData());
+}
+
+void SMPDirectory::sendReply(MemRequest *mreq, bool data)
+{
+  SMPMemRequest *sreq = static_cast<SMPMemRequest *>(mreq);
+
+  SMPDirNode *home = getHomeNode(mreq->getPAddr());
+  SMPDirNode *dst  = getCacheNode(getCachePos(sreq->getRequestor()));
+
+  DirTable::iterator it = dirTable.find(mreq->getPAddr() >> log2LineSize);
+  if (it != dirTable.end() && it->second.owner == mreq) {
+    // the line is not busy anymore, serve the next request
+    DirEntry &e = it->second;
+    e.owner = 0;
+    if (!e.waiting.empty()) {
+      e.owner = e.waiting.front();
+      e.waiting.pop_front();
+
+      PortGeneric *port = dirPort[home->getRouterID()];
+      startSnoopCB::scheduleAbs(port->nextSlot() + delay, this, e.owner);
+    }else if (e.isIdle()) {
+      dirTable.erase(it);
+    }
+  }
+
+  if (data)
+    home->send(DirDataReplyMsg, dst, mreq, 3 + lineSize);
+  else
+    home->send(DirReplyMsg, dst, mreq, 0);
+}
+
+void SMPDirectory::returnAccess(MemRequest *mreq)
+{
+  // answer from memory (read or write back ack), forward it to the
+  // requestor
+  sendReply(mreq, mreq->getMemOperation() != MemPush);
+}
+
+void SMPDirectory::replyMsg(PMessage *msg)
+{
+  MemRequest *mreq = msg->getMemRequest();
+
+  msg->garbageCollect();
+
+  mreq->goUp(0);
+}
@@ -0,0 +1,180 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef SMPDIRECTORY_H
+#define SMPDIRECTORY_H
+
+#include <deque>
+#include <vector>
+
+#include "SMPSystemBus.h"
+#include "ProtocolBase.h"
+#include "PMessage.h"
+
+class SMPDirectory;
+
+// Full map sharer vector, one bit per upper level cache
+class DirSharers {
+public:
+  enum { MaxCaches = 256, nWords = MaxCaches/64 };
+
+  unsigned long long w[nWords];
+
+  DirSharers() { clear(); }
+
+  void clear() {
+    for(int i = 0; i < nWords; i++)
+      w[i] = 0;
+  }
+  void set(int i)        { w[i>>6] |=  (1ULL << (i & 63)); }
+  void reset(int i)      { w[i>>6] &= ~(1ULL << (i & 63)); }
+  bool test(int i) const { return (w[i>>6] >> (i & 63)) & 1; }
+  bool empty() const {
+    for(int i = 0; i < nWords; i++) {
+      if (w[i])
+        return false;
+    }
+    return true;
+  }
+};
+
+// Network interface of a mesh node. It just hands the messages to the
+// directory.
+class SMPDirNode : public ProtocolBase {
+private:
+  SMPDirectory *dir;
+
+public:
+  SMPDirNode(SMPDirectory *d, InterConnection *net, RouterID_t rID);
+
+  void homeHandler(Message *msg);
+  void snoopHandler(Message *msg);
+  void replyHandler(Message *msg);
+
+  void send(MessageType t, SMPDirNode *dst, MemRequest *mreq, size_t size);
+};
+
+// Directory based coherence for SMPCache. Drop-in replacement of
+// SMPSystemBus (deviceType = 'meshdir'): same protocol with the caches,
+// but instead of broadcasting each miss on a bus, the request travels
+// over a libnet network to the home node of the line, the home sends
+// invalidations/forwards only to the caches in the sharer vector and
+// collects the acks before answering the requestor.
+//
+// Cache i is attached to router i % nRouters, lines are interleaved
+// across home nodes. Clean evictions are silent, so the sharer vector is
+// a superset of the real sharers (a stale sharer just acks). Data
+// supplied by another cache goes through the home (4 hops).
+//
+// A line is busy at its home from the request until the reply is sent,
+// the requests that arrive meanwhile wait in order at the home. When no
+// cache supplies the data, the home gets it from memory before replying,
+// so the requestor does not need a second round trip.
+class SMPDirectory : public SMPSystemBus {
+private:
+  InterConnection *net;
+
+  std::vector<SMPDirNode *>  nodes;
+  std::vector<PortGeneric *> dirPort; // directory controller of each node
+
+  uint lineSize;
+  uint log2LineSize;
+
+  class DirEntry {
+  public:
+    DirSharers sharers;
+    MemRequest *owner;               // request being served, 0 if none
+    std::deque<MemRequest *> waiting; // requests arrived meanwhile
+
+    DirEntry() { owner = 0; }
+
+    bool isIdle() const {
+      return owner == 0 && waiting.empty() && sharers.empty();
+    }
+  };
+
+  // only the lines cached somewhere or busy have an entry
+  typedef HASH_MAP<PAddr, DirEntry> DirTable;
+  DirTable dirTable;
+
+  // snoops in flight for a request. Caches answer in the same order
+  // that they receive the snoop
+  class DirTrans {
+  public:
+    DirSharers targets;
+    std::deque<int> responders;
+  };
+
+  typedef HASH_MAP<MemRequest *, DirTrans, SMPMemReqHashFunc> TransTable;
+  TransTable transTable;
+
+  GStatsCntr dirReads;
+  GStatsCntr dirWrites;
+  GStatsCntr dirWriteBacks;
+  GStatsCntr dirMemReqs;
+  GStatsCntr dirQueued;
+
+  void initNodes();
+
+  int getCachePos(MemObj *obj) {
+    if (upperLevelPos.empty())
+      initNodes();
+    return getUpperLevelPos(obj);
+  }
+  SMPDirNode *getCacheNode(int pos) const {
+    return nodes[pos % nodes.size()];
+  }
+  SMPDirNode *getHomeNode(PAddr addr) const {
+    return nodes[(addr >> log2LineSize) % nodes.size()];
+  }
+
+  void homeRequest(MemRequest *mreq);
+  void startSnoop(MemRequest *mreq);
+  void finishSnoop(MemRequest *mreq);
+  void sendReply(MemRequest *mreq, bool data);
+
+  typedef CallbackMember1<SMPDirectory, MemRequest *, &SMPDirectory::startSnoop>
+    startSnoopCB;
+
+protected:
+  void finalizeRead(MemRequest *mreq);
+  void finalizeWrite(MemRequest *mreq);
+
+public:
+  SMPDirectory(SMemorySystem *gms, const char *section, const char *name);
+  ~SMPDirectory();
+
+  Time_t getNextFreeCycle() const;
+
+  void access(MemRequest *mreq);
+  void returnAccess(MemRequest *mreq);
+
+  int ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst);
+
+  // called by SMPDirNode when a message arrives
+  void homeMsg(PMessage *msg);
+  void doHomeMsg(PMessage *msg);
+  void snoopMsg(PMessage *msg);
+  void replyMsg(PMessage *msg);
+
+  typedef CallbackMember1<SMPDirectory, PMessage *, &SMPDirectory::doHomeMsg>
+    doHomeMsgCB;
+};
+
+#endif // SMPDIRECTORY_H
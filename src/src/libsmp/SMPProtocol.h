@@ -67,6 +67,10 @@ public:
   virtual void write(MemRequest *mreq);
   virtual void writeBack(MemRequest *mreq);
   virtual void returnAccess(MemRequest *mreq);
+
+  // state of a line brought by a functional access (SMPCache::ffAccess),
+  // SMP_INVALID if the protocol does not support them
+  virtual unsigned getFFState(bool write) const { return SMP_INVALID; }
   // END interface with cache
 
   // BEGIN interface of Protocol
@@ -48,6 +48,19 @@ SMPSystemBus::SMPSystemBus(SMemorySystem *dms, const char *section, const char *
                                 SescConf->getInt(section, "numPorts"), 
                                 SescConf->getInt(section, "portOccp"));
 
+  snoopFilter = false;
+  filter      = 0;
+  if (SescConf->checkCharPtr(section, "snoopFilter")) {
+    const char *sfSection = SescConf->getCharPtr(section, "snoopFilter");
+    filter = SnoopFilter::create(sfSection, "", "%s_snoopFilter", name);
+    snoopFilter = true;
+  }
+
+  snoopsSent          = new GStatsCntr("%s:snoopsSent", name);
+  snoopsFiltered      = new GStatsCntr("%s:snoopsFiltered", name);
+  snoopsFilteredRatio = new GStatsAvg("%s:snoopsFilteredRatio", name);
+  snoopFilterBackInv  = new GStatsCntr("%s:snoopFilterBackInv", name);
+
 #ifdef SESC_ENERGY
   busEnergy = new GStatsEnergy("busEnergy", "SMPSystemBus", 0,
                                MemPower,
@@ -147,10 +160,11 @@ void SMPSystemBus::doRead(MemRequest *mreq)
 
   if(pendReqsTable.find(mreq) == pendReqsTable.end()) {
 
-    unsigned numSnoops = getNumSnoopCaches(sreq);
+    SharerMask targets = 0;
+    unsigned numSnoops = getSnoopTargets(sreq, targets);
 
     // operation is starting now, add it to the pending requests buffer
-    pendReqsTable[mreq] = getNumSnoopCaches(sreq);
+    pendReqsTable[mreq] = numSnoops;
 
     if(!numSnoops) { 
       // nothing to snoop on this chip
@@ -161,11 +175,7 @@ void SMPSystemBus::doRead(MemRequest *mreq)
     }
 
     // distribute requests to other caches, wait for responses
-         for(uint i = 0; i < upperLevel.size(); i++) {
-      if(upperLevel[i] != static_cast<SMPMemRequest *>(mreq)->getRequestor()) {
-        upperLevel[i]->returnAccess(mreq);
-      }
-    }
+    sendSnoops(mreq, targets);
   } 
   else {
     // operation has already been sent to other caches, receive responses
@@ -184,6 +194,152 @@ void SMPSystemBus::doRead(MemRequest *mreq)
   }
 }
 
+void SMPSystemBus::initSnoopFilter()
+{
+  // upperLevel is complete only after the memory system is built
+  if (upperLevel.size() > 64) {
+    MSG("%s:snoopFilter disabled, more than 64 upper levels", getSymbolicName());
+    snoopFilter = false;
+    return;
+  }
+
+  for(uint i = 0; i < upperLevel.size(); i++) {
+    // back invalidations do not go up the hierarchy
+    if (!upperLevel[i]->isCache() || !upperLevel[i]->isHighestLevel()) {
+      MSG("%s:snoopFilter disabled, upper level %s is not a first level cache"
+          , getSymbolicName(), upperLevel[i]->getSymbolicName());
+      snoopFilter = false;
+      return;
+    }
+    if (static_cast<SMPCache *>(upperLevel[i])->getLineSize() != filter->getLineSize()) {
+      MSG("%s:snoopFilter disabled, its bsize is not the line size of %s"
+          , getSymbolicName(), upperLevel[i]->getSymbolicName());
+      snoopFilter = false;
+      return;
+    }
+    upperLevelPos[upperLevel[i]] = i;
+  }
+}
+
+int SMPSystemBus::ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst)
+{
+  for(uint i = 0; i < upperLevel.size(); i++) {
+    if (upperLevel[i] != src)
+      upperLevel[i]->ffSnoop(addr, write);
+  }
+
+  if (snoopFilter && upperLevelPos.empty())
+    initSnoopFilter();
+
+  // the cache tells if it does not keep the line
+  if (snoopFilter && src)
+    addSharer(addr, getUpperLevelPos(src));
+
+  return MemObj::ffAccess(addr, write, src, dinst);
+}
+
+int SMPSystemBus::getUpperLevelPos(MemObj *obj)
+{
+  std::map<MemObj *, int>::const_iterator it = upperLevelPos.find(obj);
+  I(it != upperLevelPos.end());
+
+  return it->second;
+}
+
+void SMPSystemBus::addSharer(PAddr addr, int pos)
+{
+  SFLine *l = filter->findLine(addr);
+  if (l) {
+    l->sharers |= 1ULL << pos;
+    return;
+  }
+
+  l = filter->findLine2Replace(addr);
+  I(l); // filter entries are never locked
+
+  PAddr      rplAddr    = filter->calcAddr4Tag(l->getTag());
+  SharerMask rplSharers = l->isValid() ? l->sharers : 0;
+
+  l->setTag(filter->calcTag(addr));
+  l->sharers = 1ULL << pos;
+
+  // the replaced line can not be tracked anymore, its sharers drop it
+  for(uint i = 0; rplSharers; i++, rplSharers >>= 1) {
+    if (rplSharers & 1) {
+      snoopFilterBackInv->inc();
+      static_cast<SMPCache *>(upperLevel[i])->backInvalidate(rplAddr);
+    }
+  }
+}
+
+void SMPSystemBus::lineDropped(PAddr addr, MemObj *src)
+{
+  if (!snoopFilter || upperLevelPos.empty())
+    return;
+
+  SFLine *l = filter->findLineNoEffect(addr);
+  if (l == 0)
+    return;
+
+  l->sharers &= ~(1ULL << getUpperLevelPos(src));
+  if (l->sharers == 0)
+    l->invalidate();
+}
+
+unsigned SMPSystemBus::getSnoopTargets(SMPMemRequest *sreq, SharerMask &targets)
+{
+  unsigned numSnoops = getNumSnoopCaches(sreq);
+
+  if (snoopFilter && upperLevelPos.empty())
+    initSnoopFilter();
+
+  if (!snoopFilter || numSnoops == 0) {
+    snoopsSent->add(numSnoops);
+    return numSnoops;
+  }
+
+  PAddr addr = sreq->getPAddr();
+  int reqPos = getUpperLevelPos(sreq->getRequestor());
+
+  SFLine *l = filter->findLineNoEffect(addr);
+  if (l)
+    targets = l->sharers & ~(1ULL << reqPos);
+
+  unsigned nSent = 0;
+  for(SharerMask t = targets; t; t >>= 1)
+    nSent += t & 1;
+
+  // the requestor has the line allocated until it drops it
+  addSharer(addr, reqPos);
+
+  snoopsSent->add(nSent);
+  snoopsFiltered->add(numSnoops - nSent);
+  snoopsFilteredRatio->msamples(numSnoops - nSent, numSnoops);
+
+  return nSent;
+}
+
+void SMPSystemBus::sendSnoops(MemRequest *mreq, SharerMask targets)
+{
+  MemObj *requestor = static_cast<SMPMemRequest *>(mreq)->getRequestor();
+
+  if (!snoopFilter) {
+    for(uint i = 0; i < upperLevel.size(); i++) {
+      if(upperLevel[i] != requestor) {
+        upperLevel[i]->returnAccess(mreq);
+      }
+    }
+    return;
+  }
+
+  for(uint i = 0; targets; i++, targets >>= 1) {
+    if (targets & 1) {
+      I(upperLevel[i] != requestor);
+      upperLevel[i]->returnAccess(mreq);
+    }
+  }
+}
+
 void SMPSystemBus::finalizeRead(MemRequest *mreq)
 {
   finalizeAccess(mreq);
@@ -201,10 +357,11 @@ void SMPSystemBus::doWrite(MemRequest *mreq)
 
   if(pendReqsTable.find(mreq) == pendReqsTable.end()) {
 
-    unsigned numSnoops = getNumSnoopCaches(sreq);
+    SharerMask targets = 0;
+    unsigned numSnoops = getSnoopTargets(sreq, targets);
 
     // operation is starting now, add it to the pending requests buffer
-    pendReqsTable[mreq] = getNumSnoopCaches(sreq);
+    pendReqsTable[mreq] = numSnoops;
 
     if(!numSnoops) { 
       // nothing to snoop on this chip
@@ -215,11 +372,7 @@ void SMPSystemBus::doWrite(MemRequest *mreq)
     }
 
     // distribute requests to other caches, wait for responses
-         for(uint i = 0; i < upperLevel.size(); i++) {
-      if(upperLevel[i] != static_cast<SMPMemRequest *>(mreq)->getRequestor()) {
-        upperLevel[i]->returnAccess(mreq);
-      }
-    }
+    sendSnoops(mreq, targets);
   } 
   else {
     // operation has already been sent to other caches, receive responses
@@ -26,6 +26,24 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "MemObj.h"
 #include "Port.h"
 #include "estl.h"
+#include "CacheCore.h"
+
+#include <map>
+
+class SnoopFilterState : public StateGeneric<PAddr> {
+public:
+  typedef unsigned long long SharerMask;
+
+  SharerMask sharers;
+
+  SnoopFilterState() {
+    sharers = 0;
+  }
+  void invalidate() {
+    clearTag();
+    sharers = 0;
+  }
+};
 
 class SMPSystemBus : public MemObj {
 private:
@@ -44,6 +62,33 @@ protected:
 
   PendReqsTable pendReqsTable;
 
+  // Snoop filter (optional, snoopFilter in the bus section names the
+  // section with its size, assoc, bsize and replPolicy). A bit per
+  // upper level cache for the lines that it may have. The bit is set
+  // when the cache requests the line and cleared when the cache drops it
+  // (lineDropped), entries without sharers are freed. The entry replaced
+  // to track a new line invalidates that line in its sharers, so the
+  // filter never drops a snoop that the broadcast would need. It does
+  // not look at the cache tags.
+  typedef SnoopFilterState::SharerMask SharerMask;
+  typedef CacheGeneric<SnoopFilterState, PAddr, false>            SnoopFilter;
+  typedef CacheGeneric<SnoopFilterState, PAddr, false>::CacheLine SFLine;
+
+  bool snoopFilter;
+  SnoopFilter *filter;
+  std::map<MemObj *, int> upperLevelPos; // position in upperLevel
+
+  GStatsCntr *snoopsSent;
+  GStatsCntr *snoopsFiltered;
+  GStatsAvg  *snoopsFilteredRatio;
+  GStatsCntr *snoopFilterBackInv;
+
+  void initSnoopFilter();
+  int getUpperLevelPos(MemObj *obj);
+  void addSharer(PAddr addr, int pos);
+  unsigned getSnoopTargets(SMPMemRequest *sreq, SharerMask &targets);
+  void sendSnoops(MemRequest *mreq, SharerMask targets);
+
   // interface with upper level
   void read(MemRequest *mreq);
   void write(MemRequest *mreq);
@@ -90,8 +135,15 @@ public:
   void invalidate(PAddr addr, ushort size, MemObj *oc);
   void doInvalidate(PAddr addr, ushort size);
 
+  // an upper level cache does not have the line anymore
+  void lineDropped(PAddr addr, MemObj *src);
+
   bool canAcceptStore(PAddr addr) { return true; }
 
+  // functional access: the other caches see it and the snoop filter
+  // learns the new sharer
+  int ffAccess(PAddr addr, bool write, MemObj *src, DInst *dinst);
+
   // END MemObj interface
 
 };
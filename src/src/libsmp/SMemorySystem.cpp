@@ -22,6 +22,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "SMemorySystem.h"
 #include "SMPCache.h"
 #include "SMPSystemBus.h"
+#include "SMPDirectory.h"
 #include <math.h>
 
 #include "SMPDebug.h" // debugging defines
@@ -42,6 +43,8 @@ MemObj *SMemorySystem::buildMemoryObj(const char *type,
     obj = new SMPCache(this, section, name);
   } else if (!strcasecmp(type, "systembus")) {
     obj = new SMPSystemBus(this, section, name);
+  } else if (!strcasecmp(type, "meshdir")) {
+    obj = new SMPDirectory(this, section, name);
   } else {
     obj = MemorySystem::buildMemoryObj(type, section, name);
   }
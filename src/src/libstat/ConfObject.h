@@ -27,6 +27,17 @@ class ConfObject
       /* Variables */
 
       /* Functions */
+
+      // Parameters are read once. Some callers run per instruction, so
+      // they must use this instead of creating a new ConfObject
+      static ConfObject *getConf(void)
+      {
+         static ConfObject *conf = 0;
+         if(conf == 0)
+            conf = new ConfObject;
+         return conf;
+      }
+
       UINT_8 readFile(void)
       {
          update_printContents(SescConf->getBool("StatisticalModel","conf_debug_printContents"));
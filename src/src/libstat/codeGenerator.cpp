@@ -997,7 +997,7 @@ void writeOutSynthetic(Synthetic *syntheticThreads[], UINT_32 arraySize)
 {
    /* Variable Declaraion */
    CodeLogic *syntheticCodeBlock = new CodeLogic(totalNumThreads);
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    UINT_32 numThreads = totalNumThreads;
 
    string fileName = Synthesis::statPaths.return_rootDirectory() + Synthesis::statPaths.return_synthDirectory() + Synthesis::statPaths.return_outputFileName();
@@ -1050,7 +1050,6 @@ void writeOutSynthetic(Synthetic *syntheticThreads[], UINT_32 arraySize)
       }
    }
 
-   delete statConf;
    delete syntheticCodeBlock;
 
    outputFile.close();
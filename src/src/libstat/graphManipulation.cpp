@@ -94,7 +94,7 @@ void generateSFGNodeIDs()
 **/
 void writeSFGDots(string name)
 {
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    UINT_32 numThreads = totalNumThreads;
    INT_32 rSize = statConf->return_reductionFactor();
    UINT_32 threadCounter = 0;
@@ -116,8 +116,6 @@ void writeSFGDots(string name)
       outputFile.close();
    }
 
-   delete statConf;
-
    std::cout << "...Finished" << std::flush;
 }
 
@@ -137,7 +135,7 @@ void updateGraph(BasicBlock *basicBlockIn, THREAD_ID threadID)
    BOOL found;
    BOOL inserted;
    BOOL unique;
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    ADDRESS_INT basicBlockAddress;
    BasicBlock localBBObject;
    BBVertexMap::iterator masterMapIterator;
@@ -259,8 +257,6 @@ void updateGraph(BasicBlock *basicBlockIn, THREAD_ID threadID)
 
    localBBObject.update_isSpawn(0);                                 //only set at thread generation
    localBBObject.update_isDestroy(0);                               //only set at thread generation
-
-   delete statConf;
 }//---------------------------------------------------------------------	// End updateGraph //
 
 /**
@@ -296,7 +292,7 @@ UINT_32 getBasicBlockSize(THREAD_ID threadID, UINT_32 totalInstructions)
 void reduceSFG()
 {
    /* Variable Declaration */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    float BBCount;
    UINT_32 numThreads = totalNumThreads;
    UINT_64 reductionFactor = (UINT_32)statConf->return_reductionFactor();
@@ -387,8 +383,6 @@ void reduceSFG()
       }
    }
 
-   delete statConf;
-
    std::cout << "...Finished" << std::flush;
 }//---------------------------------------------------------------------	// End reduceSFG //
 
@@ -403,7 +397,7 @@ void reduceSFG()
 void walkSFG(THREAD_ID threadID, Synthetic *syntheticThreads[], UINT_32 arraySize)
 {
    /* Variable Declaraion */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    float edgeTransit = 0;
    UINT_32 bbcount_out = 0;
 
@@ -482,7 +476,6 @@ void walkSFG(THREAD_ID threadID, Synthetic *syntheticThreads[], UINT_32 arraySiz
    }while(bbcount_out < maxBB && num_vertices(*myCFG[threadID]) > 0);
 
    syntheticThreads[threadID] = tempSynth;
-   delete statConf;
 }//---------------------------------------------------------------------	// End walkSFG //
 
 /**
@@ -496,7 +489,7 @@ void walkSFG(THREAD_ID threadID, Synthetic *syntheticThreads[], UINT_32 arraySiz
 float walkSFG(THREAD_ID threadID, Synthetic *tempSynth, float numInstructions)
 {
    /* Variable Declaraion */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    UINT_32 iterations = 0;
    float edgeTransit = 0;
    UINT_32 bbcount_out = 0;
@@ -681,8 +674,6 @@ float walkSFG(THREAD_ID threadID, Synthetic *tempSynth, float numInstructions)
    std::cout << "+Added " << instructions_out << " to T" << threadID << "  with weight of " << numInstructions << std::endl;
    #endif
 
-   delete statConf;
-
    return instructions_out;
 }//---------------------------------------------------------------------	// End walkSFG //
 
@@ -698,7 +689,7 @@ float walkSFG(THREAD_ID threadID, Synthetic *tempSynth, float numInstructions)
 float walkSFG(THREAD_ID threadID, ADDRESS_INT startPC, Synthetic *tempSynth, float numInstructions)
 {
    /* Variable Declaraion */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    float edgeTransit = 0;
    UINT_32 bbcount_out = 0;
    float instructions_out = 0;
@@ -899,8 +890,6 @@ float walkSFG(THREAD_ID threadID, ADDRESS_INT startPC, Synthetic *tempSynth, flo
    std::cout << "*Added " << instructions_out << " to T" << threadID << "  with weight of " << numInstructions << std::endl;
    #endif
 
-   delete statConf;
-
    return instructions_out;
 }//---------------------------------------------------------------------	// End walkSFG //
 
@@ -917,7 +906,7 @@ float walkSFG(THREAD_ID threadID, ADDRESS_INT startPC, Synthetic *tempSynth, flo
 float walkSFG(THREAD_ID threadID, Synthetic *tempSynth, float numInstructions, FlowNode flowNodeIn, std::vector< FlowVertex > foundNodes)
 {
    /* Variable Declaraion */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    float edgeTransit = 0;
    UINT_32 bbcount_out = 0;
    float instructions_out = 0;
@@ -1181,8 +1170,6 @@ float walkSFG(THREAD_ID threadID, Synthetic *tempSynth, float numInstructions, F
    std::cout << "Added " << instructions_out << " to T" << threadID << "  with weight of " << numInstructions << std::endl;
    #endif
 
-   delete statConf;
-
    return instructions_out;
 }//---------------------------------------------------------------------	// End walkSFG //
 
@@ -1402,7 +1389,7 @@ void generatePCFGNodeIDs()
 **/
 void writePCFGDots(string name)
 {
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    UINT_32 numThreads = totalNumThreads;
    INT_32 rSize = statConf->return_reductionFactor();
    UINT_32 threadCounter = 0;
@@ -1421,8 +1408,6 @@ void writePCFGDots(string name)
    write_graphviz(outputFile, myPCFG, make_label_writer(nodeName), make_label_writer(edgeWeight));
    outputFile.close();
 
-   delete statConf;
-
    std::cout << "...Finished" << std::flush;
 }
 
@@ -1435,7 +1420,7 @@ void writePCFGDots(string name)
 void reducePCFG(const std::vector < UINT_64 > &numInstructions)
 {
    /* Variable Declaraion */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    float minInstructionCount = MAX_INSTRUCTIONS;
    std::vector< UINT_64 > newInstructionCount (totalNumThreads,0);
 
@@ -1480,8 +1465,6 @@ void reducePCFG(const std::vector < UINT_64 > &numInstructions)
 
    std::cout << minInstructionCount << flush;
 
-   delete statConf;
-
    std::cout << "...Finished" << std::flush;
 }//---------------------------------------------------------------------	// End reducePCFG //
 
@@ -1496,7 +1479,7 @@ void reducePCFG(const std::vector < UINT_64 > &numInstructions)
 void walkPCFG(THREAD_ID threadID, Synthetic *syntheticThreads[], const UINT_32 &arraySize)
 {
    /* Variable Declaraion */
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    UINT_32 maxBB = statConf->return_maxBasicBlocks();
    UINT_32 bbcount_out = 0;
    float   totalInstructions = 0;
@@ -1671,7 +1654,6 @@ void walkPCFG(THREAD_ID threadID, Synthetic *syntheticThreads[], const UINT_32 &
       std::cout << "Finished" << std::flush;
 
    syntheticThreads[threadID] = tempSynth;
-   delete statConf;
 }//---------------------------------------------------------------------	// End walkPCFG //
 
 
@@ -1688,7 +1670,7 @@ FlowVertex addPCFGNode(const FlowNode &flowNodeIn)
    BOOL found;
    BOOL inserted;
    BOOL unique;
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    THREAD_ID threadID = flowNodeIn.return_threadID();
 
    graph_traits <PCFG>::edge_descriptor edgeDesc;
@@ -1714,8 +1696,6 @@ FlowVertex addPCFGNode(const FlowNode &flowNodeIn)
 
    lastInsertedNode[threadID] = myPCFG_VertexA;       //set up for next iteration -- need per-thread
 
-   delete statConf;
-
    return myPCFG_VertexA;
 }
 
@@ -1733,7 +1713,7 @@ void finalizePCFG()
    BOOL found;
    BOOL inserted;
    BOOL unique;
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
 
    graph_traits <PCFG>::edge_descriptor edgeDesc;
    flowNode_name_map_t flowNode = get(flowNode_t(), myPCFG);
@@ -1795,8 +1775,6 @@ std::cerr << "---------->   parentThreadID:  " << parentThreadID << "(" << threa
 //       lastInsertedNode[threadID] = myPCFG_VertexA;       //set up for next iteration -- need per-thread
    }
 
-   delete statConf;
-
 }
 //END PCFG--------------------------------------------------------------------------------------------------
 
@@ -286,7 +286,7 @@ and the address of its direct descendents.
 void printSFGStructure()
 {
    /* Variable Declaration */
-   ConfObject* statConf = new ConfObject;
+   ConfObject* statConf = ConfObject::getConf();
    UINT_32 numThreads = totalNumThreads;
    graph_traits <BBGraph>::vertex_iterator vertexIterator, vertexEnd;
    graph_traits <BBGraph>::out_edge_iterator outEdgeIterator, outEdgeEnd;
@@ -370,7 +370,6 @@ void printSFGStructure()
       graphOutputFile << "\n***************************************************************************************\n";
 
    graphOutputFile.close();
-   delete statConf;
 
    std::cout << "...Finished" << std::flush;
 }//---------------------------------------------------------------------	// End printSFGStructure //
@@ -565,7 +564,7 @@ and the address of its direct descendents.
 void printPCFGStructure()
 {
    /* Variable Declaration */
-   ConfObject* statConf = new ConfObject;
+   ConfObject* statConf = ConfObject::getConf();
    UINT_32 numThreads = totalNumThreads;
    graph_traits <PCFG>::vertex_iterator vertexIterator, vertexEnd;
    graph_traits <PCFG>::out_edge_iterator outEdgeIterator, outEdgeEnd;
@@ -642,7 +641,6 @@ void printPCFGStructure()
       graphOutputFile << "\n***************************************************************************************\n";
 
    graphOutputFile.close();
-   delete statConf;
 
    std::cout << "...Finished" << std::flush;
 }
@@ -14,6 +14,7 @@
 //
 
 #include "stat_synthesis.h"
+#include "HostProf.h"
 
 //NOTE woo
 AddressMap                    uniqueBBMap;
@@ -165,8 +166,9 @@ void instructionCounts(void)
  */
 void analysis(tuple<DInst, Time_t>  tempTuple)
 {
+   HOSTPROF_SCOPE(HP_Analysis);
    bool skip = 0;
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    DInst tempDinst = tempTuple.get<0>();
    THREAD_ID threadID = tempDinst.get_threadID();
 
@@ -700,8 +702,6 @@ void analysis(tuple<DInst, Time_t>  tempTuple)
       }
    }
 
-   delete statConf;
-
 //FIXME The initial thread skips the last few instructions -- these should be flushed
    //If the last block does not end with a branch, we still need to flush to the graph
    if(tempDinst.getInst()->getICode()->func == mint_exit)
@@ -778,7 +778,7 @@ void finished(void)
 {
    /* Variables */
    UINT_32 numBasicBlocks[totalNumThreads];
-   ConfObject *statConf = new ConfObject;
+   ConfObject *statConf = ConfObject::getConf();
    string reduced = "reduced";
 
    /* Processes */
@@ -866,7 +866,6 @@ void finished(void)
    }
 
    cleanup();
-   delete statConf;
 }
 
 
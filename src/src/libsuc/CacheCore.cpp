@@ -30,6 +30,11 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include <stdarg.h>
 #include <string.h>
 #include <strings.h>
+#include <stdlib.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "CacheCore.h"
 #include "SescConf.h"
@@ -37,12 +42,17 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #define k_RANDOM     "RANDOM"
 #define k_LRU        "LRU"
+#define k_PLRU       "PLRU"
+#define k_DIP        "DIP"
+#define k_SRRIP      "SRRIP"
+#define k_BRRIP      "BRRIP"
+#define k_DRRIP      "DRRIP"
 
 //
 // Class CacheGeneric, the combinational logic of Cache
 //
 template<class State, class Addr_t, bool Energy>
-CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create(int size, int assoc, int bsize, int addrUnit, const char *pStr, bool skew)
+CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create(int size, int assoc, int bsize, int addrUnit, const char *pStr, bool skew, bool packed)
 {
   CacheGeneric *cache;
 
@@ -52,6 +62,10 @@ CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create
   }else if (assoc==1) {
     // Direct Map cache
     cache = new CacheDM<State, Addr_t, Energy>(size, bsize, addrUnit, pStr);
+  }else if (assoc <= 64 && ReplPolicy::isKnown(pStr)) {
+    cache = new CacheAssocRepl<State, Addr_t, Energy>(size, assoc, bsize, addrUnit, pStr);
+  }else if (packed && assoc <= 64) {
+    cache = new CacheAssocPacked<State, Addr_t, Energy>(size, assoc, bsize, addrUnit, pStr);
   }else if(size == (assoc * bsize)) {
     // TODO: Fully assoc can use STL container for speed
     cache = new CacheAssoc<State, Addr_t, Energy>(size, assoc, bsize, addrUnit, pStr);
@@ -152,6 +166,7 @@ CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create
   char assoc[STR_BUF_SIZE];
   char repl[STR_BUF_SIZE];
   char skew[STR_BUF_SIZE];
+  char packed[STR_BUF_SIZE];
 
   snprintf(size ,STR_BUF_SIZE,"%sSize" ,append);
   snprintf(bsize,STR_BUF_SIZE,"%sBsize",append);
@@ -159,6 +174,7 @@ CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create
   snprintf(assoc,STR_BUF_SIZE,"%sAssoc",append);
   snprintf(repl ,STR_BUF_SIZE,"%sReplPolicy",append);
   snprintf(skew ,STR_BUF_SIZE,"%sSkew",append);
+  snprintf(packed,STR_BUF_SIZE,"%sPackedTags",append);
 
   int s = SescConf->getInt(section, size);
   int a = SescConf->getInt(section, assoc);
@@ -166,6 +182,9 @@ CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create
   bool sk = false;
   if (SescConf->checkBool(section, skew))
     sk = SescConf->getBool(section, skew);
+  bool pk = false;
+  if (SescConf->checkBool(section, packed))
+    pk = SescConf->getBool(section, packed);
   
   //For now, tolerate caches that don't have this defined.
   int u;
@@ -187,9 +206,16 @@ CacheGeneric<State, Addr_t, Energy> *CacheGeneric<State, Addr_t, Energy>::create
      SescConf->isPower2(section, size) && 
      SescConf->isPower2(section, bsize) &&
      SescConf->isPower2(section, assoc) &&
-     SescConf->isInList(section, repl, k_RANDOM, k_LRU)) {
+     SescConf->isInList(section, repl, k_RANDOM, k_LRU, k_PLRU, k_DIP,
+                        k_SRRIP, k_BRRIP, k_DRRIP)) {
+
+    if (a > 64 && ReplPolicy::isKnown(pStr)) {
+      MSG("%s::%s=%s needs an associativity of 64 or less"
+          ,section, repl, pStr);
+      SescConf->notCorrect();
+    }
 
-    cache = create(s, a, b, u, pStr, sk);
+    cache = create(s, a, b, u, pStr, sk, pk);
   } else {
     // this is just to keep the configuration going, 
     // sesc will abort before it begins
@@ -393,6 +419,379 @@ typename CacheAssoc<State, Addr_t, Energy>::Line
   return tmp;
 }
 
+/*********************************************************
+ *  CacheAssocPacked
+ *********************************************************/
+
+template<class State, class Addr_t, bool Energy>
+CacheAssocPacked<State, Addr_t, Energy>::CacheAssocPacked(int size, int assoc, int blksize, int addrUnit, const char *pStr) 
+  : CacheGeneric<State, Addr_t, Energy>(size, assoc, blksize, addrUnit) 
+{
+  I(numLines>0);
+  I(assoc>1 && assoc<=64);
+  
+  if (strcasecmp(pStr, k_RANDOM) == 0) 
+    policy = RANDOM;
+  else if (strcasecmp(pStr, k_LRU)    == 0) 
+    policy = LRU;
+  else {
+    MSG("Invalid cache policy [%s]",pStr);
+    exit(0);
+  }
+
+  // Multiple of 16 bytes so that each set starts aligned
+  uint perVector = 16/sizeof(Addr_t);
+  if (perVector == 0)
+    perVector = 1;
+  tagStride = ((assoc + perVector - 1)/perVector)*perVector;
+
+  wayMask = (assoc == 64) ? ~static_cast<WayMask>(0) : ((static_cast<WayMask>(1) << assoc) - 1);
+
+  // order is padded to 16 bytes
+  orderOffset = tagStride*sizeof(Addr_t);
+  staleOffset = orderOffset + ((assoc + 15) & ~15);
+
+  // Cache line aligned, power of two
+  uint setBytes = 64;
+  log2SetBytes  = 6;
+  while(setBytes < staleOffset + sizeof(WayMask)) {
+    setBytes <<= 1;
+    log2SetBytes++;
+  }
+
+  void *ptr;
+  if (posix_memalign(&ptr, 64, sets*setBytes)) {
+    MSG("CacheAssocPacked could not allocate the tag array");
+    exit(-1);
+  }
+  meta = static_cast<char *>(ptr);
+  mem  = new Line [numLines + 1];
+
+  for(uint i = 0; i < numLines; i++) {
+    mem[i].initialize(this);
+    mem[i].invalidate();
+  }
+  for(uint set = 0; set < sets; set++) {
+    Addr_t *t = getTags(set);
+    uchar  *o = getOrder(set);
+    for(uint i = 0; i < tagStride; i++)
+      t[i] = (i < this->assoc) ? mem[set*assoc + i].getTag() : 0;
+    for(uint i = 0; i < ((this->assoc + 15) & ~15U); i++)
+      o[i] = (i < this->assoc) ? i : 0xFF;
+    getStale(set) = 0;
+  }
+  
+  irand = 0;
+}
+
+template<class State, class Addr_t, bool Energy>
+CacheAssocPacked<State, Addr_t, Energy>::~CacheAssocPacked()
+{
+  delete [] mem;
+  free(meta);
+}
+
+template<class State, class Addr_t, bool Energy>
+typename CacheAssocPacked<State, Addr_t, Energy>::WayMask
+CacheAssocPacked<State, Addr_t, Energy>::matchTags(const Addr_t *t, Addr_t tag) const
+{
+  WayMask m = 0;
+
+#ifdef __SSE2__
+  if (sizeof(Addr_t) == 4) {
+    const __m128i key = _mm_set1_epi32(static_cast<int>(tag));
+    const __m128i *v  = reinterpret_cast<const __m128i *>(t);
+    for(uint i = 0; i < tagStride; i += 4, v++) {
+      __m128i eq = _mm_cmpeq_epi32(_mm_load_si128(v), key);
+      // one byte per tag in the low 4 bytes
+      eq = _mm_packs_epi32(eq, eq);
+      eq = _mm_packs_epi16(eq, eq);
+      m |= static_cast<WayMask>(_mm_movemask_epi8(eq) & 0xF) << i;
+    }
+    return m & wayMask;
+  }
+#endif
+
+  for(uint i = 0; i < assoc; i++) {
+    if (t[i] == tag)
+      m |= (static_cast<WayMask>(1) << i);
+  }
+
+  return m;
+}
+
+// Returns the way with the tag (-1 if none) excluding the MRU way (the
+// callers check it directly). The mirror matches are checked first, then
+// the stale ways. The tag mirror is refreshed, and the stale bit cleared,
+// for all the ways touched.
+template<class State, class Addr_t, bool Energy>
+int CacheAssocPacked<State, Addr_t, Energy>::lookup(uint set, Addr_t tag)
+{
+  Addr_t  *t = getTags(set);
+  WayMask &stale = getStale(set);
+  Line    *l = &mem[set << log2Assoc];
+
+  WayMask mru  = static_cast<WayMask>(1) << getOrder(set)[0];
+  WayMask cand = matchTags(t, tag) & ~mru;
+  WayMask checked = cand | mru;
+
+  bool checkedStale = false;
+  while(1) {
+    while(cand) {
+      uint way = __builtin_ctzll(cand);
+      WayMask bit = static_cast<WayMask>(1) << way;
+      cand &= ~bit;
+
+      Addr_t lineTag = l[way].getTag();
+      t[way] = lineTag;
+      stale &= ~bit;
+      if (lineTag == tag)
+        return way;
+    }
+    if (checkedStale)
+      break;
+
+    cand = stale & ~checked;
+    checkedStale = true;
+  }
+
+  return -1;
+}
+
+template<class State, class Addr_t, bool Energy>
+void CacheAssocPacked<State, Addr_t, Energy>::moveToMRU(uint set, uint pos)
+{
+  uchar *o  = getOrder(set);
+  uchar way = o[pos];
+
+  // The MRU line is not tracked in the mirror (users can retag it). From
+  // now on the mirror has its tag
+  Line *theSet = &mem[set << log2Assoc];
+  getTags(set)[o[0]] = theSet[o[0]].getTag();
+  getStale(set) &= ~(static_cast<WayMask>(1) << o[0]);
+
+  memmove(o + 1, o, pos);
+  o[0] = way;
+}
+
+template<class State, class Addr_t, bool Energy>
+uint CacheAssocPacked<State, Addr_t, Energy>::findPos(uint set, uint way) const
+{
+  const uchar *o = getOrder(set);
+
+  uint pos = 0;
+  while(o[pos] != way)
+    pos++;
+  I(pos < assoc);
+  return pos;
+}
+
+template<class State, class Addr_t, bool Energy>
+typename CacheAssocPacked<State, Addr_t, Energy>::Line *CacheAssocPacked<State, Addr_t, Energy>::findLinePrivate(Addr_t addr)
+{
+  Addr_t tag = calcTag(addr);
+
+  GI(Energy, goodInterface); // If modeling energy. Do not use this
+                             // interface directly. use readLine and
+                             // writeLine instead. If it is called
+                             // inside debugging only use
+                             // findLineDebug instead
+
+  uint   set = calcSet4Tag(tag);
+  uchar *o   = getOrder(set);
+  Line  *theSet = &mem[set << log2Assoc];
+
+  // Check most typical case (no need to go through the mirror)
+  if (theSet[o[0]].getTag() == tag) {
+    //this assertion is not true for SMP; it is valid to return invalid line
+#if !defined(SESC_SMP) && !defined(SESC_CRIT)
+    I(theSet[o[0]].isValid());  
+#endif
+    return &theSet[o[0]];
+  }
+
+  int way = lookup(set, tag);
+  if (way < 0)
+    return 0;
+
+  Line *line = &theSet[way];
+  I(line->isValid());
+
+  uint pos = findPos(set, way);
+  I(pos > 0 && pos < assoc);
+
+  // No matter what is the policy, move the hit to the MRU position
+  moveToMRU(set, pos);
+
+  return line;
+}
+
+template<class State, class Addr_t, bool Energy>
+typename CacheAssocPacked<State, Addr_t, Energy>::Line 
+*CacheAssocPacked<State, Addr_t, Energy>::findLine2Replace(Addr_t addr, bool ignoreLocked)
+{ 
+  Addr_t tag = calcTag(addr);
+  uint   set = calcSet4Tag(tag);
+  Line  *theSet = &mem[set << log2Assoc];
+  uchar *o = getOrder(set);
+
+  // Check most typical case
+  if (theSet[o[0]].getTag() == tag) {
+    GI(tag,theSet[o[0]].isValid());
+    return &theSet[o[0]];
+  }
+
+  int way = lookup(set, tag);
+  if (way >= 0) {
+    GI(tag,theSet[way].isValid());
+    return &theSet[way];
+  }
+
+  // Order of preference, invalid, locked. Positions in LRU order. Start
+  // in reverse order so that get the youngest invalid possible, and the
+  // oldest isLocked possible (lineFree)
+  int lineFree = -1;
+  for(int pos = assoc - 1; pos >= 0; pos--) {
+    Line *l = &theSet[o[pos]];
+
+    if (!l->isValid())
+      lineFree = pos;
+    else if (lineFree < 0 && !l->isLocked())
+      lineFree = pos;
+
+    // If line is invalid, isLocked must be false
+    GI(!l->isValid(), !l->isLocked()); 
+  }
+
+  if(lineFree < 0 && !ignoreLocked)
+    return 0;
+
+  if (lineFree < 0) {
+    I(ignoreLocked);
+    if (policy == RANDOM) {
+      lineFree = irand;
+      irand = (irand + 1) & maskAssoc;
+    }else{
+      I(policy == LRU);
+      // Get the oldest line possible
+      lineFree = assoc - 1;
+    }
+  }else if(ignoreLocked) {
+    if (policy == RANDOM && theSet[o[lineFree]].isValid()) {
+      lineFree = irand;
+      irand = (irand + 1) & maskAssoc;
+    }
+  }
+
+  way = o[lineFree];
+  GI(!ignoreLocked, !theSet[way].isValid() || !theSet[way].isLocked());
+
+  // The caller is going to set the tag, while it is the MRU line
+  if (lineFree != 0)
+    moveToMRU(set, lineFree);
+
+  return &theSet[way];
+}
+
+/*********************************************************
+ *  CacheAssocRepl
+ *********************************************************/
+
+template<class State, class Addr_t, bool Energy>
+CacheAssocRepl<State, Addr_t, Energy>::CacheAssocRepl(int size, int assoc, int blksize, int addrUnit, const char *pStr) 
+  : CacheGeneric<State, Addr_t, Energy>(size, assoc, blksize, addrUnit) 
+{
+  I(numLines>0);
+  I(assoc>1 && assoc<=64);
+
+  repl = ReplPolicy::create(pStr, sets, assoc);
+  if (repl == 0) {
+    MSG("Invalid cache policy [%s]",pStr);
+    exit(0);
+  }
+
+  mem = new Line [numLines + 1];
+  for(uint i = 0; i < numLines; i++) {
+    mem[i].initialize(this);
+    mem[i].invalidate();
+  }
+}
+
+template<class State, class Addr_t, bool Energy>
+typename CacheAssocRepl<State, Addr_t, Energy>::Line *CacheAssocRepl<State, Addr_t, Energy>::findLinePrivate(Addr_t addr)
+{
+  Addr_t tag = calcTag(addr);
+
+  GI(Energy, goodInterface); // If modeling energy. Do not use this
+                             // interface directly. use readLine and
+                             // writeLine instead. If it is called
+                             // inside debugging only use
+                             // findLineDebug instead
+
+  uint  set    = calcSet4Tag(tag);
+  Line *theSet = &mem[set << log2Assoc];
+
+  for(uint way = 0; way < assoc; way++) {
+    if (theSet[way].getTag() == tag) {
+      repl->touch(set, way);
+      return &theSet[way];
+    }
+  }
+
+  return 0;
+}
+
+template<class State, class Addr_t, bool Energy>
+typename CacheAssocRepl<State, Addr_t, Energy>::Line 
+*CacheAssocRepl<State, Addr_t, Energy>::findLine2Replace(Addr_t addr, bool ignoreLocked)
+{ 
+  Addr_t tag    = calcTag(addr);
+  uint   set    = calcSet4Tag(tag);
+  Line  *theSet = &mem[set << log2Assoc];
+
+  // Order of preference: hit, invalid, policy victim among the unlocked
+  // lines, policy victim among all the lines (ignoreLocked)
+  int     lineFree = -1;
+  WayMask unlocked = 0;
+  for(uint way = 0; way < assoc; way++) {
+    Line *l = &theSet[way];
+
+    if (l->getTag() == tag) {
+      GI(tag,l->isValid());
+      repl->touch(set, way);
+      return l;
+    }
+
+    if (!l->isValid()) {
+      if (lineFree < 0)
+        lineFree = way;
+    }else if (!l->isLocked()) {
+      unlocked |= (static_cast<WayMask>(1) << way);
+    }
+
+    // If line is invalid, isLocked must be false
+    GI(!l->isValid(), !l->isLocked()); 
+  }
+
+  if (lineFree < 0) {
+    if (unlocked) {
+      lineFree = repl->victim(set, unlocked);
+    }else if (ignoreLocked) {
+      WayMask all = (assoc == 64) ? ~static_cast<WayMask>(0) : ((static_cast<WayMask>(1) << assoc) - 1);
+      lineFree = repl->victim(set, all);
+    }else{
+      return 0;
+    }
+  }
+
+  GI(!ignoreLocked, !theSet[lineFree].isValid() || !theSet[lineFree].isLocked());
+
+  // The caller is going to fill the line
+  repl->insert(set, lineFree);
+
+  return &theSet[lineFree];
+}
+
 /*********************************************************
  *  CacheDM
  *********************************************************/
@@ -30,6 +30,7 @@ Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "nanassert.h"
 #include "Snippets.h"
 #include "GStats.h"
+#include "ReplPolicy.h"
 
 enum    ReplacementPolicy  {LRU, RANDOM};
 
@@ -105,7 +106,7 @@ template<class State, class Addr_t = uint, bool Energy=true>
 
   public:
   // Do not use this interface, use other create
-  static CacheGeneric<State, Addr_t, Energy> *create(int size, int assoc, int blksize, int addrUnit, const char *pStr, bool skew);
+  static CacheGeneric<State, Addr_t, Energy> *create(int size, int assoc, int blksize, int addrUnit, const char *pStr, bool skew, bool packed=false);
   static CacheGeneric<State, Addr_t, Energy> *create(const char *section, const char *append, const char *format, ...);
   void destroy() {
   }
@@ -270,6 +271,136 @@ public:
   Line *findLine2Replace(Addr_t addr, bool ignoreLocked=false);
 };
 
+// Same behavior as CacheAssoc, different layout. The tags of each set are
+// mirrored in a contiguous aligned array, and the LRU order is kept as way
+// numbers in a byte array instead of shuffling Line pointers. Tags, LRU
+// order and stale bits of a set share a cache line aligned block. A hit
+// does not dereference any line except the matching one.
+//
+// Users can change the tag of a line behind the cache back (setTag on a
+// line returned by findLine2Replace or findLine) as long as it is still
+// the MRU line of its set, which is what all the callers do. The MRU line
+// is always checked directly, and its mirror entry is refreshed when it
+// stops being the MRU. Lines returned by getPLine can be invalidated at
+// any time; they are marked stale, and a lookup that misses in the mirror
+// re-reads their tag from the line. A refreshed mirror entry is no longer
+// stale.
+//
+// Enabled with xxxPackedTags = true (2 <= assoc <= 64). misc/CacheCoreCheck
+// runs it in lockstep with CacheAssoc.
+#ifdef SESC_ENERGY
+template<class State, class Addr_t = uint, bool Energy=true>
+#else
+template<class State, class Addr_t = uint, bool Energy=false>
+#endif
+class CacheAssocPacked : public CacheGeneric<State, Addr_t, Energy> {
+  using CacheGeneric<State, Addr_t, Energy>::numLines;
+  using CacheGeneric<State, Addr_t, Energy>::assoc;
+  using CacheGeneric<State, Addr_t, Energy>::maskAssoc;
+  using CacheGeneric<State, Addr_t, Energy>::log2Assoc;
+  using CacheGeneric<State, Addr_t, Energy>::sets;
+  using CacheGeneric<State, Addr_t, Energy>::goodInterface;
+
+private:
+public:
+  typedef typename CacheGeneric<State, Addr_t, Energy>::CacheLine Line;
+  typedef unsigned long long WayMask;
+
+protected:
+
+  Line   *mem;       // Line for (set,way) is mem[set*assoc+way]
+  char   *meta;      // Per set: tags[tagStride], order[assoc], stale
+  uint    log2SetBytes;
+  uint    orderOffset;
+  uint    staleOffset;
+  uint    tagStride;
+  WayMask wayMask;
+  ushort  irand;
+  ReplacementPolicy policy;
+
+  friend class CacheGeneric<State, Addr_t, Energy>;
+  CacheAssocPacked(int size, int assoc, int blksize, int addrUnit, const char *pStr);
+
+  Addr_t *getTags(uint set) const {
+    return reinterpret_cast<Addr_t *>(meta + (set << log2SetBytes));
+  }
+  // Way numbers in LRU order, [0] is the MRU (padded to 16 with 0xFF)
+  uchar *getOrder(uint set) const {
+    return reinterpret_cast<uchar *>(meta + (set << log2SetBytes) + orderOffset);
+  }
+  // Ways whose tag mirror may be outdated
+  WayMask &getStale(uint set) const {
+    return *reinterpret_cast<WayMask *>(meta + (set << log2SetBytes) + staleOffset);
+  }
+
+  WayMask matchTags(const Addr_t *t, Addr_t tag) const;
+  int  lookup(uint set, Addr_t tag);
+  uint findPos(uint set, uint way) const;
+  void moveToMRU(uint set, uint pos);
+
+  Line *findLinePrivate(Addr_t addr);
+public:
+  virtual ~CacheAssocPacked();
+
+  Line *getPLine(uint l) {
+    // Lines [l..l+assoc] belong to the same set, in LRU order
+    I(l<numLines);
+    uint set = l >> log2Assoc;
+    uint way = getOrder(set)[l & maskAssoc];
+    getStale(set) |= (static_cast<WayMask>(1) << way);
+    return &mem[(set << log2Assoc) + way];
+  }
+
+  Line *findLine2Replace(Addr_t addr, bool ignoreLocked=false);
+};
+
+// Associative cache with the lines at a fixed (set,way) position and the
+// replacement decision delegated to a ReplPolicy (see ReplPolicy.h). A
+// hit only updates the policy metadata of the set.
+//
+// Enabled with xxxReplPolicy = PLRU, DIP, SRRIP, BRRIP or DRRIP
+// (2 <= assoc <= 64).
+#ifdef SESC_ENERGY
+template<class State, class Addr_t = uint, bool Energy=true>
+#else
+template<class State, class Addr_t = uint, bool Energy=false>
+#endif
+class CacheAssocRepl : public CacheGeneric<State, Addr_t, Energy> {
+  using CacheGeneric<State, Addr_t, Energy>::numLines;
+  using CacheGeneric<State, Addr_t, Energy>::assoc;
+  using CacheGeneric<State, Addr_t, Energy>::log2Assoc;
+  using CacheGeneric<State, Addr_t, Energy>::sets;
+  using CacheGeneric<State, Addr_t, Energy>::goodInterface;
+
+private:
+public:
+  typedef typename CacheGeneric<State, Addr_t, Energy>::CacheLine Line;
+  typedef ReplPolicy::WayMask WayMask;
+
+protected:
+
+  Line       *mem;   // Line for (set,way) is mem[set*assoc+way]
+  ReplPolicy *repl;
+
+  friend class CacheGeneric<State, Addr_t, Energy>;
+  CacheAssocRepl(int size, int assoc, int blksize, int addrUnit, const char *pStr);
+
+  Line *findLinePrivate(Addr_t addr);
+public:
+  virtual ~CacheAssocRepl() {
+    delete repl;
+    delete [] mem;
+  }
+
+  Line *getPLine(uint l) {
+    // Lines [l..l+assoc] belong to the same set, in way order
+    I(l<numLines);
+    return &mem[l];
+  }
+
+  Line *findLine2Replace(Addr_t addr, bool ignoreLocked=false);
+};
+
 #ifdef SESC_ENERGY
 template<class State, class Addr_t = uint, bool Energy=true>
 #else
@@ -0,0 +1,117 @@
+/* 
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+   Contributed by Jose Renau
+                  Luis Ceze
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "ConfParams.h"
+#include "ReportGen.h"
+
+ConfParams::ConfParams(const char *name)
+  : groupName(name)
+{
+}
+
+ConfParams::~ConfParams()
+{
+}
+
+void ConfParams::add(const char *block, const char *name, ParamType type, void *ptr)
+{
+  Param p;
+
+  p.block = block;
+  p.name  = name;
+  p.type  = type;
+  p.ptr   = ptr;
+
+  params.push_back(p);
+}
+
+void ConfParams::bindInt(Config *conf, const char *block, const char *name, int *v)
+{
+  conf->isInt(block, name);
+  *v = conf->getInt(block, name);
+
+  add(block, name, ParamInt, v);
+}
+
+void ConfParams::bindInt(Config *conf, const char *block, const char *name, int *v
+                         ,int llim, int ulim)
+{
+  conf->isInt(block, name);
+  conf->isBetween(block, name, llim, ulim);
+  *v = conf->getInt(block, name);
+
+  add(block, name, ParamInt, v);
+}
+
+void ConfParams::bindBool(Config *conf, const char *block, const char *name, bool *v)
+{
+  // Old configuration files use 0/1 for flags
+  if (conf->checkInt(block, name))
+    *v = conf->getInt(block, name) != 0;
+  else
+    *v = conf->getBool(block, name);
+
+  add(block, name, ParamBool, v);
+}
+
+void ConfParams::bindDouble(Config *conf, const char *block, const char *name, double *v)
+{
+  *v = conf->getDouble(block, name);
+
+  add(block, name, ParamDouble, v);
+}
+
+void ConfParams::bindCharPtr(Config *conf, const char *block, const char *name
+                             ,const char **v)
+{
+  conf->isCharPtr(block, name);
+  *v = conf->getCharPtr(block, name);
+
+  add(block, name, ParamCharPtr, v);
+}
+
+void ConfParams::dump() const
+{
+  Report::field("#BEGIN %s parameters", groupName);
+
+  for(ParamsType::const_iterator it = params.begin(); it != params.end(); it++) {
+    const Param &p = *it;
+
+    switch(p.type) {
+    case ParamInt:
+      Report::field("%s:%s=%d", groupName, p.name, *static_cast<int *>(p.ptr));
+      break;
+    case ParamBool:
+      Report::field("%s:%s=%s", groupName, p.name
+                    ,*static_cast<bool *>(p.ptr) ? "true" : "false");
+      break;
+    case ParamDouble:
+      Report::field("%s:%s=%e", groupName, p.name, *static_cast<double *>(p.ptr));
+      break;
+    case ParamCharPtr:
+      Report::field("%s:%s=\"%s\"", groupName, p.name, *static_cast<const char **>(p.ptr));
+      break;
+    }
+  }
+
+  Report::field("#END %s parameters", groupName);
+}
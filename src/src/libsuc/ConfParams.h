@@ -0,0 +1,96 @@
+/* 
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+   Contributed by Jose Renau
+                  Luis Ceze
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef CONFPARAMS_H
+#define CONFPARAMS_H
+
+#include <vector>
+
+#include "nanassert.h"
+#include "Config.h"
+
+// Typed view of a group of configuration parameters.
+//
+// SescConf->getInt & co hash two strings and scan the multimap on each
+// call. That is fine while building the simulator, but not in paths that
+// run during the simulation. A module that needs parameters at run time
+// derives from ConfParams, declares the parameters as plain fields, and
+// binds each one of them in the constructor:
+//
+// class MyParams : public ConfParams {
+// public:
+//   int  nPorts;
+//   bool enable;
+//   MyParams(Config *conf) : ConfParams("MyParams") {
+//     bindInt(conf, "mySection", "nPorts", &nPorts, 1, 64);
+//     bindBool(conf, "mySection", "enable", &enable);
+//   }
+// };
+//
+// All the reads and checks happen once. Constraint violations go
+// through the usual Config::notCorrect path, so the simulator stops
+// when the configuration is locked. dump() writes the effective values
+// in the report file.
+
+class ConfParams {
+private:
+  enum ParamType {
+    ParamInt = 0,
+    ParamBool,
+    ParamDouble,
+    ParamCharPtr
+  };
+
+  class Param {
+  public:
+    const char *block;
+    const char *name;
+    ParamType   type;
+    void       *ptr;
+  };
+
+  typedef std::vector<Param> ParamsType;
+
+  const char *groupName;
+  ParamsType  params;
+
+  void add(const char *block, const char *name, ParamType type, void *ptr);
+
+protected:
+  void bindInt(Config *conf, const char *block, const char *name, int *v);
+  void bindInt(Config *conf, const char *block, const char *name, int *v
+               ,int llim, int ulim);
+  void bindBool(Config *conf, const char *block, const char *name, bool *v);
+  void bindDouble(Config *conf, const char *block, const char *name, double *v);
+  void bindCharPtr(Config *conf, const char *block, const char *name
+                   ,const char **v);
+
+public:
+  ConfParams(const char *name);
+  virtual ~ConfParams();
+
+  const char *getName() const { return groupName; }
+
+  void dump() const;
+};
+
+#endif // CONFPARAMS_H
@@ -119,6 +119,8 @@ public:
 
   size_t size() const { return nElems; }
   bool empty()  const { return nElems == 0; }
+  // Number of ids (power of two, >= the size passed to the constructor)
+  size_t capacity() const { return pipeMask+1; }
 };
 #endif // FASTQUEUE_USE_QUEUE
 
@@ -631,6 +631,61 @@ void GStatsPeriodicHist::reportValue() const
   GStatsHist::reportValue();
 }
 
+/*********************** GStatsTimeSeries */
+
+GStatsTimeSeries::GStatsTimeSeries(int p, const char *format,...)
+{
+  char *str;
+  va_list ap;
+
+  va_start(ap, format);
+  str = getText(format, ap);
+  va_end(ap);
+
+  name = str;
+  subscribe();
+
+  I(p > 0);
+  period     = p;
+  lastUpdate = 0;
+  lastValue  = 0;
+  acc        = 0;
+}
+
+void GStatsTimeSeries::advance()
+{
+  Time_t end = (series.size() + 1) * period;
+
+  // close all the periods that finished since the last update
+  while(globalClock >= end) {
+    acc += static_cast<double>(lastValue) * (end - lastUpdate);
+    series.push_back(acc / period);
+
+    acc        = 0;
+    lastUpdate = end;
+    end       += period;
+  }
+
+  acc += static_cast<double>(lastValue) * (globalClock - lastUpdate);
+  lastUpdate = globalClock;
+}
+
+void GStatsTimeSeries::sample(const int v)
+{
+  if (lastUpdate != globalClock)
+    advance();
+
+  lastValue = v;
+}
+
+void GStatsTimeSeries::reportValue() const
+{
+  Report::field("%s_period=%llu", name, period);
+
+  for(size_t i = 0; i < series.size(); i++)
+    Report::field("%s(%lu)=%.2f", name, (unsigned long)i, series[i]);
+}
+
 /*********************** GStatsChangeHist */
 
 GStatsChangeHist::GStatsChangeHist(const char *format,...)
@@ -327,4 +327,29 @@ private:
   void inc();
 };
 
+// Time weighted average of a level (occupancy, queue size...) over each
+// period of cycles. Reported as a series, one value per period.
+class GStatsTimeSeries : public GStats {
+private:
+  Time_t period;
+  Time_t lastUpdate;
+  int    lastValue;
+  double acc; // lastValue * cycles in the current period
+
+  std::vector<float> series;
+
+  void advance();
+
+protected:
+  void prepareReport() { advance(); }
+
+public:
+  GStatsTimeSeries(int p, const char *format,...);
+
+  void reportValue() const;
+
+  // call on each change of the level
+  void sample(const int v);
+};
+
 #endif   // GSTATSD_H
@@ -0,0 +1,123 @@
+/* 
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+   Contributed by Jose Renau
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include "HostProf.h"
+
+#ifdef SESC_HOSTPROF
+
+#include "ReportGen.h"
+
+unsigned long long HostProf::ticks[HP_MaxId];
+unsigned long long HostProf::calls[HP_MaxId];
+
+const char *HostProf::names[HP_MaxId] = {
+  "exeInst",
+  "exeInstFast",
+  "advanceClock",
+  "memAccess",
+  "memReturnAccess",
+  "transCoherence",
+  "transReport",
+  "analysis"
+};
+
+HostProf::PhasesType HostProf::phases;
+
+unsigned long long HostProf::startTicks = HostProf::getTicks();
+timeval HostProf::startTime = HostProf::now();
+
+// The tick source may be the TSC. Calibrate it against the wall clock
+// over the whole run.
+double HostProf::getNSecsPerTick()
+{
+#if defined(__i386__) || defined(__x86_64__)
+  timeval t = now();
+  unsigned long long nowTicks = getTicks();
+
+  double nsecs = (t.tv_sec - startTime.tv_sec) * 1e9
+    + (t.tv_usec - startTime.tv_usec) * 1e3;
+
+  if (nowTicks == startTicks || nsecs <= 0)
+    return 0;
+
+  return nsecs / static_cast<double>(nowTicks - startTicks);
+#else
+  return 1000; // Ticks are usecs
+#endif
+}
+
+void HostProf::beginPhase(const char *name)
+{
+  if (phases.empty()) {
+    startTime  = now();
+    startTicks = getTicks();
+  }
+
+  unsigned long long t = getTicks();
+
+  if (!phases.empty()) {
+    phases.back().endTicks = t;
+    phases.back().endInst  = nInsts();
+  }
+
+  Phase p;
+  p.name       = name;
+  p.startTicks = t;
+  p.endTicks   = 0;
+  p.startInst  = nInsts();
+  p.endInst    = 0;
+
+  phases.push_back(p);
+}
+
+void HostProf::report()
+{
+  double nsPerTick = getNSecsPerTick();
+
+  for(int i = 0; i < HP_MaxId; i++) {
+    Report::field("HostProf:%s:secs=%g:calls=%lld:nsecsPerCall=%g"
+                  ,names[i]
+                  ,ticks[i]*nsPerTick/1e9
+                  ,calls[i]
+                  ,calls[i] ? ticks[i]*nsPerTick/calls[i] : 0);
+  }
+
+  // The last phase is still open
+  unsigned long long t = getTicks();
+  for(size_t i = 0; i < phases.size(); i++) {
+    const Phase &p = phases[i];
+    bool open = (i == phases.size() - 1);
+
+    unsigned long long endTicks = open ? t : p.endTicks;
+    unsigned long long endInst  = open ? nInsts() : p.endInst;
+
+    double secs  = (endTicks - p.startTicks)*nsPerTick/1e9;
+    unsigned long long nInst = endInst - p.startInst;
+
+    Report::field("HostProf(%s):secs=%g:nInst=%lld:KIPS=%g"
+                  ,p.name
+                  ,secs
+                  ,nInst
+                  ,secs > 0 ? nInst/secs/1000 : 0);
+  }
+}
+
+#endif // SESC_HOSTPROF
@@ -0,0 +1,136 @@
+/* 
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+   Contributed by Jose Renau
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef HOSTPROF_H
+#define HOSTPROF_H
+
+// Host self-profiling. Measures where the simulator (not the simulated
+// machine) spends its time. Compile with SESC_HOSTPROF defined
+// (make SESC_HOSTPROF=1) to enable it. Otherwise all the macros are
+// empty and there is no overhead at all.
+//
+// HOSTPROF_SCOPE(HP_xxx) at the beginning of a block accounts the host
+// time and the number of calls of the block. Times are inclusive (the
+// interpreter time is also accounted in the pipeline if exeInst is
+// called from advanceClock).
+//
+// HOSTPROF_PHASE("name") starts a new phase (rabbit, timing...). The
+// report shows the host seconds and the simulated KIPS of each phase.
+
+#ifdef SESC_HOSTPROF
+
+#include <sys/time.h>
+#include <vector>
+
+enum HostProfId {
+  HP_ExeInst = 0,       // ExecutionFlow::exeInst (MIPS_EMUL: executePC)
+  HP_ExeInstFast,       // ExecutionFlow::exeInstFast (rabbit mode)
+  HP_AdvanceClock,      // GProcessor::advanceClock
+  HP_MemAccess,         // MemObj::access
+  HP_MemReturnAccess,   // MemObj::returnAccess
+  HP_TransCoherence,    // transCoherence begin/read/write/commit/abort
+  HP_TransReport,       // transReport
+  HP_Analysis,          // Synthesis/Profiling analysis
+  HP_MaxId
+};
+
+class HostProf {
+private:
+  class Phase {
+  public:
+    const char *name;
+    unsigned long long startTicks;
+    unsigned long long endTicks;
+    unsigned long long startInst;
+    unsigned long long endInst;
+  };
+  typedef std::vector<Phase> PhasesType;
+
+  static unsigned long long ticks[HP_MaxId];
+  static unsigned long long calls[HP_MaxId];
+  static const char *names[HP_MaxId];
+
+  static PhasesType phases;
+
+  static unsigned long long startTicks;
+  static timeval startTime;
+
+  static double getNSecsPerTick();
+
+  static timeval now() {
+    timeval t;
+    gettimeofday(&t, 0);
+    return t;
+  }
+
+  // Instructions executed, timing and rabbit mode
+  static unsigned long long nInsts() {
+    return calls[HP_ExeInst] + calls[HP_ExeInstFast];
+  }
+
+public:
+  static unsigned long long getTicks() {
+#if defined(__i386__) || defined(__x86_64__)
+    unsigned int lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (static_cast<unsigned long long>(hi) << 32) | lo;
+#else
+    timeval t;
+    gettimeofday(&t, 0);
+    return static_cast<unsigned long long>(t.tv_sec)*1000000 + t.tv_usec;
+#endif
+  }
+
+  static void add(HostProfId id, unsigned long long t) {
+    ticks[id] += t;
+    calls[id]++;
+  }
+
+  static void beginPhase(const char *name);
+
+  static void report();
+};
+
+class HostProfScope {
+private:
+  const HostProfId id;
+  const unsigned long long start;
+public:
+  HostProfScope(HostProfId i)
+    : id(i)
+    , start(HostProf::getTicks()) {
+  }
+  ~HostProfScope() {
+    HostProf::add(id, HostProf::getTicks() - start);
+  }
+};
+
+#define HOSTPROF_SCOPE(id)   HostProfScope hostProfScope(id)
+#define HOSTPROF_PHASE(name) HostProf::beginPhase(name)
+
+#else
+
+#define HOSTPROF_SCOPE(id)
+#define HOSTPROF_PHASE(name)
+
+#endif // SESC_HOSTPROF
+
+#endif // HOSTPROF_H
@@ -95,6 +95,14 @@ MSHR<Addr_t, Cache_t> *MSHR<Addr_t, Cache_t>::create(const char *name, const cha
                                         aPolicy);
   }
 
+  if(SescConf->checkInt(section, "occInterval")) {
+    SescConf->isGT(section, "occInterval", 0);
+    mshr->initOccTrace(name, SescConf->getInt(section, "occInterval"));
+  }
+
+  if(SescConf->checkCharPtr(section, "shadowSizes"))
+    mshr->shadow = new MSHRShadow(name, section);
+
   return mshr;
 }
 
@@ -129,6 +137,13 @@ MSHR<Addr_t, Cache_t>::MSHR(const char *name, int size, int lineSize, int aPolic
   ,nCanNotAccept("%s_MSHR:nCanNotAccept", name)
   ,nCanNotAcceptConv("%s_MSHR:nCanNotAcceptConv", name)
   ,blockingCycles("%s_MSHR:blockingCycles",name)
+  ,nPrimary("%s_MSHR:nPrimary", name)
+  ,nSecondary("%s_MSHR:nSecondary", name)
+  ,mergeRate("%s_MSHR:mergeRate", name)
+  ,fullStallCycles("%s_MSHR:fullStallCycles", name)
+  ,lastStall(static_cast<Time_t>(-1))
+  ,occTrace(0)
+  ,shadow(0)
   ,allocPolicy(aPolicy)
   ,occStatsAttached(false)
   ,lowerCache(NULL)
@@ -173,6 +188,7 @@ bool MSHR<Addr_t, Cache_t>::canAcceptRequest(Addr_t paddr, MemOperation mo)
       else
 	blockingCycles.sample(1);
 
+      countStall();
       return false;
     }
   }
@@ -183,9 +199,74 @@ bool MSHR<Addr_t, Cache_t>::canAcceptRequest(Addr_t paddr, MemOperation mo)
 
   blockingCycles.sample((canAcceptSpecial)? 0 : 1);
 
+  if(!canAcceptSpecial)
+    countStall();
+
   return canAcceptSpecial;
 }
 
+template<class Addr_t, class Cache_t>
+void MSHR<Addr_t, Cache_t>::countStall()
+{
+  // several rejected requests in the same cycle are a single stall cycle
+  if(lastStall == globalClock)
+    return;
+
+  lastStall = globalClock;
+  fullStallCycles.inc();
+}
+
+template<class Addr_t, class Cache_t>
+bool MSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
+{
+  bool primary = issueSpecial(paddr, mo);
+
+  if(primary) {
+    nPrimary.inc();
+    mergeRate.sample(0);
+  } else if(hasEntry(paddr)) {
+    nSecondary.inc();
+    mergeRate.sample(100);
+  }
+
+  if(occTrace)
+    occTrace->sample(getnUsedEntries());
+  if(shadow)
+    shadow->issue(calcLineAddr(paddr));
+
+  return primary;
+}
+
+template<class Addr_t, class Cache_t>
+void MSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
+                                     CallbackBase *ovflwc, MemOperation mo)
+{
+  addEntrySpecial(paddr, c, ovflwc, mo);
+
+  if(occTrace)
+    occTrace->sample(getnUsedEntries());
+}
+
+template<class Addr_t, class Cache_t>
+bool MSHR<Addr_t, Cache_t>::retire(Addr_t paddr)
+{
+  bool rmEntry = retireSpecial(paddr);
+
+  if(occTrace)
+    occTrace->sample(getnUsedEntries());
+  if(shadow)
+    shadow->retire(calcLineAddr(paddr));
+
+  return rmEntry;
+}
+
+template<class Addr_t, class Cache_t>
+void MSHR<Addr_t, Cache_t>::initOccTrace(const char *name, int interval)
+{
+  I(occTrace == 0);
+  occTrace = new GStatsTimeSeries(interval, "%s_MSHR:occTrace", name);
+}
+
 template<class Addr_t, class Cache_t>
 MSHRentry<Addr_t>* MSHR<Addr_t, Cache_t>::selectEntryToDrop(Addr_t paddr)
 {
@@ -243,7 +324,7 @@ NoDepsMSHR<Addr_t, Cache_t>::NoDepsMSHR(const char *name, int size, int lineSize
 }
 
 template<class Addr_t, class Cache_t>
-bool NoDepsMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
+bool NoDepsMSHR<Addr_t, Cache_t>::issueSpecial(Addr_t paddr, MemOperation mo)
 {
   nUse.inc();
 
@@ -258,8 +339,8 @@ bool NoDepsMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
 
 
 template<class Addr_t, class Cache_t>
-void NoDepsMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
-                                           CallbackBase *ovflwc, MemOperation mo)
+void NoDepsMSHR<Addr_t, Cache_t>::addEntrySpecial(Addr_t paddr, CallbackBase *c,
+                                                  CallbackBase *ovflwc, MemOperation mo)
 {
   // by definition, calling addEntry in the NoDepsMSHR is overflowing
   OverflowField f;
@@ -276,7 +357,7 @@ void NoDepsMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
 }
 
 template<class Addr_t, class Cache_t>
-bool NoDepsMSHR<Addr_t, Cache_t>::retire(Addr_t paddr)
+bool NoDepsMSHR<Addr_t, Cache_t>::retireSpecial(Addr_t paddr)
 {
   maxUsedEntries.sample(nEntries - nFreeEntries);
 
@@ -326,7 +407,7 @@ FullMSHR<Addr_t, Cache_t>::FullMSHR(const char *name, int size, int lineSize, in
 }
 
 template<class Addr_t, class Cache_t>
-bool FullMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
+bool FullMSHR<Addr_t, Cache_t>::issueSpecial(Addr_t paddr, MemOperation mo)
 {
   nUse.inc();
 
@@ -349,7 +430,7 @@ bool FullMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
 }
 
 template<class Addr_t, class Cache_t>
-void FullMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c, CallbackBase *ovflwc, MemOperation mo)
+void FullMSHR<Addr_t, Cache_t>::addEntrySpecial(Addr_t paddr, CallbackBase *c, CallbackBase *ovflwc, MemOperation mo)
 {
   I(nFreeEntries>=0);
   I(nFreeEntries <= nEntries);
@@ -379,7 +460,7 @@ void FullMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c, Callback
 }
 
 template<class Addr_t, class Cache_t>
-bool FullMSHR<Addr_t, Cache_t>::retire(Addr_t paddr)
+bool FullMSHR<Addr_t, Cache_t>::retireSpecial(Addr_t paddr)
 {
   maxUsedEntries.sample((nEntries - nFreeEntries) + overflow.size());
 
@@ -465,7 +546,7 @@ SingleMSHR<Addr_t, Cache_t>::SingleMSHR(const char *name, int size,
 }
 
 template<class Addr_t, class Cache_t>
-bool SingleMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
+bool SingleMSHR<Addr_t, Cache_t>::issueSpecial(Addr_t paddr, MemOperation mo)
 {
   MSHRit it = ms.find(calcLineAddr(paddr));
 
@@ -630,8 +711,8 @@ void SingleMSHR<Addr_t, Cache_t>::checkOverflow()
 }
 
 template<class Addr_t, class Cache_t>
-void SingleMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
-                                           CallbackBase *ovflwc, MemOperation mo)
+void SingleMSHR<Addr_t, Cache_t>::addEntrySpecial(Addr_t paddr, CallbackBase *c,
+                                                  CallbackBase *ovflwc, MemOperation mo)
 {
   MSHRit it = ms.find(calcLineAddr(paddr));
   I(ovflwc); // for single MSHR, overflow handler REQUIRED!
@@ -674,7 +755,7 @@ void SingleMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
 }
 
 template<class Addr_t, class Cache_t>
-bool SingleMSHR<Addr_t, Cache_t>::retire(Addr_t paddr)
+bool SingleMSHR<Addr_t, Cache_t>::retireSpecial(Addr_t paddr)
 {
   bool rmEntry = false;
 
@@ -968,6 +1049,27 @@ BankedMSHR<Addr_t, Cache_t>::BankedMSHR(const char *name, int size, int lineSize
   checkingOverflow = false;
 }
 
+template<class Addr_t, class Cache_t>
+int BankedMSHR<Addr_t, Cache_t>::getnUsedEntries() const
+{
+  int n = 0;
+  for(int i = 0; i < nBanks; i++)
+    n += mshrBank[i]->getnUsedEntries();
+  return n;
+}
+
+template<class Addr_t, class Cache_t>
+void BankedMSHR<Addr_t, Cache_t>::initOccTrace(const char *name, int interval)
+{
+  MSHR<Addr_t, Cache_t>::initOccTrace(name, interval);
+
+  for(int i = 0; i < nBanks; i++) {
+    char mName[512];
+    sprintf(mName, "%s_set%d", name, i);
+    mshrBank[i]->initOccTrace(mName, interval);
+  }
+}
+
 template<class Addr_t, class Cache_t>
 bool BankedMSHR<Addr_t, Cache_t>::canAllocateEntry()
 {
@@ -1019,7 +1121,7 @@ bool BankedMSHR<Addr_t, Cache_t>::canAcceptRequestSpecial(Addr_t paddr,
 }
 
 template<class Addr_t, class Cache_t>
-bool BankedMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
+bool BankedMSHR<Addr_t, Cache_t>::issueSpecial(Addr_t paddr, MemOperation mo)
 {
   nUse.inc();
 
@@ -1042,8 +1144,8 @@ bool BankedMSHR<Addr_t, Cache_t>::issue(Addr_t paddr, MemOperation mo)
 }
 
 template<class Addr_t, class Cache_t>
-void BankedMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
-                                           CallbackBase *ovflwc, MemOperation mo)
+void BankedMSHR<Addr_t, Cache_t>::addEntrySpecial(Addr_t paddr, CallbackBase *c,
+                                                  CallbackBase *ovflwc, MemOperation mo)
 {
   if(!overflow.empty()) {
     toOverflow(paddr, c, ovflwc, mo);
@@ -1061,7 +1163,7 @@ void BankedMSHR<Addr_t, Cache_t>::addEntry(Addr_t paddr, CallbackBase *c,
 }
 
 template<class Addr_t, class Cache_t>
-bool BankedMSHR<Addr_t, Cache_t>::retire(Addr_t paddr)
+bool BankedMSHR<Addr_t, Cache_t>::retireSpecial(Addr_t paddr)
 {
   bool rmEntry;
   maxOutsReqs.sample(nOutsReqs);
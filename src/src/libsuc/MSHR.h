@@ -32,6 +32,7 @@
 #include "pool.h"
 
 #include "BloomFilter.h"
+#include "MSHRShadow.h"
 
 // This is an extremly fast MSHR implementation.  Given a number of
 // outstanding MSHR entries, it does a hash function to find a random
@@ -160,6 +161,16 @@ template<class Addr_t,class Cache_t>
   GStatsCntr nCanNotAcceptConv;
   GStatsTimingHist blockingCycles;
 
+  // coalescing and stall telemetry
+  GStatsCntr nPrimary;        // the request allocated a new entry
+  GStatsCntr nSecondary;      // merged with an outstanding miss
+  GStatsAvg  mergeRate;
+  GStatsCntr fullStallCycles; // cycles with at least one rejected request
+  Time_t lastStall;
+
+  GStatsTimeSeries *occTrace; // occInterval (optional)
+  MSHRShadow *shadow;         // shadowSizes (optional)
+
   int allocPolicy;  
 
   MSHRStats<Addr_t, Cache_t> *occStats;
@@ -167,6 +178,8 @@ template<class Addr_t,class Cache_t>
   
   Cache_t *lowerCache;
 
+  void countStall();
+
  public:
   static MSHR<Addr_t,Cache_t> *create(const char *name, const char *type, 
 				      int size, int lineSize, int nse = 16, 
@@ -181,6 +194,8 @@ template<class Addr_t,class Cache_t>
  public:
   virtual ~MSHR() { 
     if(!occStatsAttached) delete occStats;
+    delete occTrace;
+    delete shadow;
   }
   MSHR(const char *name, int size, int lineSize, int aPolicy);
 
@@ -192,14 +207,22 @@ template<class Addr_t,class Cache_t>
   bool canAcceptRequest(Addr_t paddr, MemOperation mo = MemRead);
   virtual bool isOnlyWrites(Addr_t paddr) { return false; }
 
+  // issue returns true if the request allocated a new entry (primary
+  // miss). Otherwise the caller must addEntry the request, it is either
+  // a secondary miss or the MSHR is full. One retire per request.
+  bool issue(Addr_t paddr, MemOperation mo = MemRead);
+  void addEntry(Addr_t paddr, CallbackBase *c, 
+		CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
+  bool retire(Addr_t paddr);
+
   // All derived classes must implement this interface
   
   virtual bool canAcceptRequestSpecial(Addr_t paddr, MemOperation mo = MemRead) = 0;
 
-  virtual bool issue(Addr_t paddr, MemOperation mo = MemRead) = 0;
-  virtual void addEntry(Addr_t paddr, CallbackBase *c, 
-			CallbackBase *ovflwc = 0, MemOperation mo = MemRead) = 0;
-  virtual bool retire(Addr_t paddr) = 0;
+  virtual bool issueSpecial(Addr_t paddr, MemOperation mo = MemRead) = 0;
+  virtual void addEntrySpecial(Addr_t paddr, CallbackBase *c, 
+			       CallbackBase *ovflwc = 0, MemOperation mo = MemRead) = 0;
+  virtual bool retireSpecial(Addr_t paddr) = 0;
 
   //This function is address independent, and implements conventional
   //assumption that a cache cannot accept a request unless it can be
@@ -211,6 +234,7 @@ template<class Addr_t,class Cache_t>
   Addr_t calcLineAddr(Addr_t paddr) const { return paddr >> Log2LineSize; }
 
   int getnEntries() const { return nEntries; }
+  virtual int getnUsedEntries() const { return nEntries - nFreeEntries; }
 
   virtual int  getnReads() const { return 1; }
   virtual int  getnWrites() const { return 1; }
@@ -237,6 +261,7 @@ template<class Addr_t,class Cache_t>
 
   // Statistics generation
   void updateOccHistogram(); 
+  virtual void initOccTrace(const char *name, int interval);
 
 
   // debugging methods
@@ -270,12 +295,12 @@ template<class Addr_t, class Cache_t>
     virtual ~NoMSHR() { }
     bool canAcceptRequestSpecial(Addr_t paddr, MemOperation mo = MemRead) { return true; }
 
-    bool issue(Addr_t paddr, MemOperation mo = MemRead) { nUse.inc(); return true; }
+    bool issueSpecial(Addr_t paddr, MemOperation mo = MemRead) { nUse.inc(); return true; }
 
-    void addEntry(Addr_t paddr, CallbackBase *c, 
-		  CallbackBase *ovflwc = 0, MemOperation mo = MemRead) { I(0); }
+    void addEntrySpecial(Addr_t paddr, CallbackBase *c, 
+			 CallbackBase *ovflwc = 0, MemOperation mo = MemRead) { I(0); }
 
-    bool retire(Addr_t paddr) { return true; }
+    bool retireSpecial(Addr_t paddr) { return true; }
 
     bool canAllocateEntry() { return true; }
 
@@ -317,12 +342,12 @@ template<class Addr_t, class Cache_t>
       return (nFreeEntries > 0); 
     }
 
-    bool issue(Addr_t paddr, MemOperation mo = MemRead); 
+    bool issueSpecial(Addr_t paddr, MemOperation mo = MemRead); 
 
-    void addEntry(Addr_t paddr, CallbackBase *c, 
-		  CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
+    void addEntrySpecial(Addr_t paddr, CallbackBase *c, 
+			 CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
 
-    bool retire(Addr_t paddr);
+    bool retireSpecial(Addr_t paddr);
 
     bool canAllocateEntry() { return nFreeEntries > 0; }
 
@@ -390,12 +415,12 @@ class FullMSHR : public MSHR<Addr_t, Cache_t> {
       return (nFreeEntries>0); 
     }
 
-    bool issue(Addr_t paddr, MemOperation mo = MemRead);
+    bool issueSpecial(Addr_t paddr, MemOperation mo = MemRead);
 
-    void addEntry(Addr_t paddr, CallbackBase *c, 
-		  CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
+    void addEntrySpecial(Addr_t paddr, CallbackBase *c, 
+			 CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
 
-    bool retire(Addr_t paddr);
+    bool retireSpecial(Addr_t paddr);
 
 
     bool canAllocateEntry() { return (nFreeEntries>0); } 
@@ -617,12 +642,12 @@ template<class Addr_t, class Cache_t>
     bool canAcceptRequestSpecial(Addr_t paddr, MemOperation mo = MemRead);
     bool isOnlyWrites(Addr_t paddr);
 
-    bool issue(Addr_t paddr, MemOperation mo = MemRead); 
+    bool issueSpecial(Addr_t paddr, MemOperation mo = MemRead); 
 
-    void addEntry(Addr_t paddr, CallbackBase *c, 
-		  CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
+    void addEntrySpecial(Addr_t paddr, CallbackBase *c, 
+			 CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
 
-    bool retire(Addr_t paddr);
+    bool retireSpecial(Addr_t paddr);
 
     int getnReads() const { return nReads; }
     int getnWrites() const { return nWrites; }
@@ -714,12 +739,12 @@ template<class Addr_t, class Cache_t>
       return mshrBank[calcBankIndex(paddr)]->isOnlyWrites(paddr);
     }
 
-    bool issue(Addr_t paddr, MemOperation mo = MemRead); 
+    bool issueSpecial(Addr_t paddr, MemOperation mo = MemRead); 
 
-    void addEntry(Addr_t paddr, CallbackBase *c, 
-		  CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
+    void addEntrySpecial(Addr_t paddr, CallbackBase *c, 
+			 CallbackBase *ovflwc = 0, MemOperation mo = MemRead);
 
-    bool retire(Addr_t paddr);
+    bool retireSpecial(Addr_t paddr);
 
     void attach( MSHR<Addr_t, Cache_t> *mshr ); 
 
@@ -750,6 +775,9 @@ template<class Addr_t, class Cache_t>
     void putEntry(MSHRentry<Addr_t> &me);
 
     bool isOverflowing() { return (overflow.size() > 0); }
+
+    int  getnUsedEntries() const;
+    void initOccTrace(const char *name, int interval);
   };
 
 
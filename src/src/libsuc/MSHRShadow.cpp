@@ -0,0 +1,182 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <stdlib.h>
+
+#include "SescConf.h"
+#include "MSHRShadow.h"
+
+MSHRShadow::Shadow::Shadow(const char *name, int s)
+  : size(s)
+  ,nUsed(0)
+{
+  nPrimary   = new GStatsCntr("%s_MSHR:shadow(%d):nPrimary", name, s);
+  nSecondary = new GStatsCntr("%s_MSHR:shadow(%d):nSecondary", name, s);
+  nStalls    = new GStatsCntr("%s_MSHR:shadow(%d):nStalls", name, s);
+  waitCycles = new GStatsAvg("%s_MSHR:shadow(%d):waitCycles", name, s);
+  maxUsed    = new GStatsMax("%s_MSHR:shadow(%d):maxUsedEntries", name, s);
+}
+
+void MSHRShadow::Shadow::allocate(LineAddr line, Entry &e, Time_t when)
+{
+  e.allocated = true;
+  e.start     = when;
+  nUsed++;
+  I(nUsed <= size);
+  maxUsed->sample(nUsed);
+
+  if (e.latKnown) {
+    Completion c;
+    c.when = when + e.lat;
+    c.line = line;
+    done.push(c);
+  }
+}
+
+void MSHRShadow::Shadow::drain()
+{
+  while(!done.empty() && done.top().when <= globalClock) {
+    Completion c = done.top();
+    done.pop();
+
+    entries.erase(c.line);
+    nUsed--;
+
+    while(nUsed < size && !waiting.empty()) {
+      Waiting w = waiting.front();
+      waiting.pop_front();
+
+      waitCycles->sample(static_cast<int>(c.when - w.arrival));
+      allocate(w.line, entries[w.line], c.when);
+    }
+  }
+}
+
+void MSHRShadow::Shadow::request(LineAddr line)
+{
+  drain();
+
+  EntryMap::iterator it = entries.find(line);
+  if (it != entries.end()) {
+    nSecondary->inc();
+    return;
+  }
+
+  nPrimary->inc();
+
+  Entry &e = entries[line];
+  e.allocated = false;
+  e.latKnown  = false;
+  e.lat       = 0;
+
+  if (nUsed < size) {
+    allocate(line, e, globalClock);
+    return;
+  }
+
+  nStalls->inc();
+  Waiting w;
+  w.line    = line;
+  w.arrival = globalClock;
+  waiting.push_back(w);
+}
+
+void MSHRShadow::Shadow::lineDone(LineAddr line, Time_t lat)
+{
+  drain();
+
+  EntryMap::iterator it = entries.find(line);
+  if (it == entries.end())
+    return; // already freed, the real line had merged into it
+
+  Entry &e = it->second;
+  if (e.latKnown)
+    return;
+
+  e.latKnown = true;
+  e.lat      = lat;
+
+  if (e.allocated) {
+    Completion c;
+    c.when = e.start + lat;
+    c.line = line;
+    done.push(c);
+  }
+}
+
+MSHRShadow::MSHRShadow(const char *name, const char *section)
+{
+  const char *sizes = SescConf->getCharPtr(section, "shadowSizes");
+
+  const char *p = sizes;
+  while(*p) {
+    char *end;
+    long s = strtol(p, &end, 10);
+    if (end == p) {
+      if (*p != ' ' && *p != ',' && *p != '\t') {
+        MSG("MSHR:invalid shadowSizes [%s] in section [%s]", sizes, section);
+        SescConf->notCorrect();
+        break;
+      }
+      p++;
+      continue;
+    }
+    if (s <= 0) {
+      MSG("MSHR:shadowSizes [%s] in section [%s] must be positive", sizes, section);
+      SescConf->notCorrect();
+    } else {
+      shadows.push_back(new Shadow(name, s));
+    }
+    p = end;
+  }
+}
+
+MSHRShadow::~MSHRShadow()
+{
+  for(size_t i = 0; i < shadows.size(); i++)
+    delete shadows[i];
+}
+
+void MSHRShadow::issue(LineAddr line)
+{
+  RealLine &r = real[line];
+  if (r.nReqs == 0)
+    r.start = globalClock;
+  r.nReqs++;
+
+  for(size_t i = 0; i < shadows.size(); i++)
+    shadows[i]->request(line);
+}
+
+void MSHRShadow::retire(LineAddr line)
+{
+  RealMap::iterator it = real.find(line);
+  if (it == real.end())
+    return;
+
+  it->second.nReqs--;
+  if (it->second.nReqs > 0)
+    return;
+
+  Time_t lat = globalClock - it->second.start;
+  real.erase(it);
+
+  for(size_t i = 0; i < shadows.size(); i++)
+    shadows[i]->lineDone(line, lat);
+}
@@ -0,0 +1,114 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef MSHRSHADOW_H
+#define MSHRSHADOW_H
+
+#include <deque>
+#include <queue>
+#include <vector>
+
+#include "estl.h"
+#include "nanassert.h"
+#include "GStats.h"
+#include "Snippets.h"
+
+// Shadow MSHRs (shadowSizes = "8 16 32" in the MSHR section). The
+// requests seen by the real MSHR are replayed against a fully
+// associative virtual MSHR for each size, so a single run tells how
+// many primary misses, merges and stalls each size would have.
+//
+// The latency of a line is the one observed by the real MSHR, from its
+// first request to its last retire. A virtual entry is freed that many
+// cycles after it is allocated; requests that do not find a free entry
+// wait in FIFO order. The request stream is not throttled by the
+// virtual stalls, so the waiting time of the small sizes is an upper
+// bound.
+class MSHRShadow {
+private:
+  typedef unsigned long LineAddr;
+
+  class RealLine {
+  public:
+    int    nReqs;
+    Time_t start;
+  };
+  typedef HASH_MAP<LineAddr, RealLine> RealMap;
+
+  class Entry {
+  public:
+    bool   allocated;
+    bool   latKnown;
+    Time_t start;
+    Time_t lat;
+  };
+  typedef HASH_MAP<LineAddr, Entry> EntryMap;
+
+  class Waiting {
+  public:
+    LineAddr line;
+    Time_t   arrival;
+  };
+
+  class Completion {
+  public:
+    Time_t   when;
+    LineAddr line;
+    // priority_queue returns the earliest first
+    bool operator<(const Completion &c) const { return when > c.when; }
+  };
+
+  class Shadow {
+  public:
+    int size;
+    int nUsed;
+
+    EntryMap entries; // allocated and waiting lines
+    std::deque<Waiting> waiting;
+    std::priority_queue<Completion> done;
+
+    GStatsCntr *nPrimary;
+    GStatsCntr *nSecondary;
+    GStatsCntr *nStalls;
+    GStatsAvg  *waitCycles;
+    GStatsMax  *maxUsed;
+
+    Shadow(const char *name, int s);
+
+    void request(LineAddr line);
+    void lineDone(LineAddr line, Time_t lat);
+    void drain();
+    void allocate(LineAddr line, Entry &e, Time_t when);
+  };
+
+  RealMap real; // outstanding lines of the real MSHR
+
+  std::vector<Shadow *> shadows;
+
+public:
+  MSHRShadow(const char *name, const char *section);
+  ~MSHRShadow();
+
+  // one call per request that goes through MSHR::issue and
+  // MSHR::retire (line address)
+  void issue(LineAddr line);
+  void retire(LineAddr line);
+};
+
+#endif // MSHRSHADOW_H
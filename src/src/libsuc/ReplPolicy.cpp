@@ -0,0 +1,268 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <strings.h>
+
+#include "ReplPolicy.h"
+
+bool ReplPolicy::isKnown(const char *name)
+{
+  return strcasecmp(name, "PLRU")  == 0
+    ||   strcasecmp(name, "DIP")   == 0
+    ||   strcasecmp(name, "SRRIP") == 0
+    ||   strcasecmp(name, "BRRIP") == 0
+    ||   strcasecmp(name, "DRRIP") == 0;
+}
+
+ReplPolicy *ReplPolicy::create(const char *name, uint sets, uint assoc)
+{
+  I(assoc > 1 && assoc <= 64);
+
+  if (strcasecmp(name, "PLRU") == 0)
+    return new PLRUReplPolicy(sets, assoc);
+  if (strcasecmp(name, "DIP") == 0)
+    return new DIPReplPolicy(sets, assoc);
+  if (strcasecmp(name, "SRRIP") == 0)
+    return new RRIPReplPolicy(sets, assoc, RRIPReplPolicy::SRRIP);
+  if (strcasecmp(name, "BRRIP") == 0)
+    return new RRIPReplPolicy(sets, assoc, RRIPReplPolicy::BRRIP);
+  if (strcasecmp(name, "DRRIP") == 0)
+    return new RRIPReplPolicy(sets, assoc, RRIPReplPolicy::DRRIP);
+
+  return 0;
+}
+
+/*********************************************************
+ *  SetDuel
+ *********************************************************/
+
+SetDuel::SetDuel(uint sets)
+{
+  // Up to MaxLeaders sets of each kind, and at least 4 sets per region
+  // so that there are followers
+  uint nLeaders = sets/4;
+  if (nLeaders > MaxLeaders)
+    nLeaders = MaxLeaders;
+
+  region = nLeaders ? sets/nLeaders : 0;
+  psel   = (1<<(PselBits-1)) - 1;
+}
+
+/*********************************************************
+ *  PLRUReplPolicy
+ *********************************************************/
+
+PLRUReplPolicy::PLRUReplPolicy(uint s, uint a)
+  : ReplPolicy(s, a)
+{
+  tree = new WayMask[sets];
+  for(uint i = 0; i < sets; i++)
+    tree[i] = 0;
+}
+
+PLRUReplPolicy::~PLRUReplPolicy()
+{
+  delete [] tree;
+}
+
+void PLRUReplPolicy::touch(uint set, uint way)
+{
+  WayMask &t = tree[set];
+
+  // point every node in the path away from way
+  uint node = 0;
+  uint lo   = 0;
+  uint hi   = assoc;
+  while(hi - lo > 1) {
+    uint mid = (lo + hi)/2;
+    if (way < mid) {
+      t |= (static_cast<WayMask>(1) << node);
+      node = 2*node + 1;
+      hi   = mid;
+    }else{
+      t &= ~(static_cast<WayMask>(1) << node);
+      node = 2*node + 2;
+      lo   = mid;
+    }
+  }
+}
+
+uint PLRUReplPolicy::victim(uint set, WayMask allowed)
+{
+  I(allowed);
+  WayMask t = tree[set];
+
+  // Follow the tree, but never go into a half without allowed ways
+  uint node = 0;
+  uint lo   = 0;
+  uint hi   = assoc;
+  while(hi - lo > 1) {
+    uint mid   = (lo + hi)/2;
+    bool right = (t >> node) & 1;
+    if (right && (allowed & rangeMask(mid, hi)) == 0)
+      right = false;
+    else if (!right && (allowed & rangeMask(lo, mid)) == 0)
+      right = true;
+
+    if (right) {
+      node = 2*node + 2;
+      lo   = mid;
+    }else{
+      node = 2*node + 1;
+      hi   = mid;
+    }
+  }
+
+  I((allowed >> lo) & 1);
+  return lo;
+}
+
+/*********************************************************
+ *  DIPReplPolicy
+ *********************************************************/
+
+DIPReplPolicy::DIPReplPolicy(uint s, uint a)
+  : ReplPolicy(s, a)
+  ,duel(s)
+{
+  rank = new uchar[sets*assoc];
+  for(uint set = 0; set < sets; set++) {
+    for(uint way = 0; way < assoc; way++)
+      rank[set*assoc + way] = way;
+  }
+}
+
+DIPReplPolicy::~DIPReplPolicy()
+{
+  delete [] rank;
+}
+
+void DIPReplPolicy::promote(uint set, uint way)
+{
+  uchar *r = &rank[set*assoc];
+  uchar pos = r[way];
+
+  for(uint i = 0; i < assoc; i++) {
+    if (r[i] < pos)
+      r[i]++;
+  }
+  r[way] = 0;
+}
+
+void DIPReplPolicy::demote(uint set, uint way)
+{
+  uchar *r = &rank[set*assoc];
+  uchar pos = r[way];
+
+  for(uint i = 0; i < assoc; i++) {
+    if (r[i] > pos)
+      r[i]--;
+  }
+  r[way] = assoc - 1;
+}
+
+void DIPReplPolicy::insert(uint set, uint way)
+{
+  duel.miss(set);
+
+  // BIP inserts in the LRU position, except 1 out of 32 fills
+  if (duel.useB(set) && !bimodalTick())
+    demote(set, way);
+  else
+    promote(set, way);
+}
+
+uint DIPReplPolicy::victim(uint set, WayMask allowed)
+{
+  I(allowed);
+  const uchar *r = &rank[set*assoc];
+
+  uint best = assoc;
+  for(uint way = 0; way < assoc; way++) {
+    if (((allowed >> way) & 1) == 0)
+      continue;
+    if (best == assoc || r[way] > r[best])
+      best = way;
+  }
+
+  I(best < assoc);
+  return best;
+}
+
+/*********************************************************
+ *  RRIPReplPolicy
+ *********************************************************/
+
+RRIPReplPolicy::RRIPReplPolicy(uint s, uint a, Mode m)
+  : ReplPolicy(s, a)
+  ,mode(m)
+  ,duel(s)
+{
+  rrpv = new uchar[sets*assoc];
+  for(uint i = 0; i < sets*assoc; i++)
+    rrpv[i] = MaxRRPV;
+}
+
+RRIPReplPolicy::~RRIPReplPolicy()
+{
+  delete [] rrpv;
+}
+
+void RRIPReplPolicy::insert(uint set, uint way)
+{
+  bool bimodal = (mode == BRRIP);
+  if (mode == DRRIP) {
+    duel.miss(set);
+    bimodal = duel.useB(set);
+  }
+
+  if (bimodal && !bimodalTick())
+    rrpv[set*assoc + way] = MaxRRPV;
+  else
+    rrpv[set*assoc + way] = MaxRRPV - 1;
+}
+
+uint RRIPReplPolicy::victim(uint set, WayMask allowed)
+{
+  I(allowed);
+  uchar *r = &rrpv[set*assoc];
+
+  // First allowed way with the largest RRPV. Aging all the ways until it
+  // reaches MaxRRPV is the same as adding the difference at once
+  uint best = assoc;
+  for(uint way = 0; way < assoc; way++) {
+    if (((allowed >> way) & 1) == 0)
+      continue;
+    if (best == assoc || r[way] > r[best])
+      best = way;
+    if (r[best] == MaxRRPV)
+      break;
+  }
+  I(best < assoc);
+
+  uchar age = MaxRRPV - r[best];
+  if (age) {
+    for(uint way = 0; way < assoc; way++) {
+      uint v = r[way] + age;
+      r[way] = v > (uint)MaxRRPV ? (uint)MaxRRPV : v;
+    }
+  }
+
+  return best;
+}
@@ -0,0 +1,180 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef REPLPOLICY_H
+#define REPLPOLICY_H
+
+#include "nanassert.h"
+#include "Snippets.h"
+
+// Replacement policies for CacheAssocRepl. The cache keeps the lines at a
+// fixed (set,way) position and the policy keeps its own per set metadata
+// array. The cache tells the policy about hits (touch) and fills
+// (insert), and asks it for a victim among the ways that can be replaced
+// (no invalid way left, locked ways excluded).
+//
+// xxxReplPolicy values handled here (2 <= assoc <= 64):
+//
+//  PLRU  : tree pseudo-LRU, assoc-1 bits per set
+//  DIP   : LRU stack, set dueling between LRU and bimodal (BIP) insertion
+//  SRRIP : 2-bit re-reference prediction, insert with long interval
+//  BRRIP : SRRIP, insert with distant interval (long 1 out of 32 fills)
+//  DRRIP : set dueling between SRRIP and BRRIP
+//
+// LRU and RANDOM are still handled by CacheAssoc/CacheAssocPacked.
+class ReplPolicy {
+public:
+  typedef unsigned long long WayMask;
+
+protected:
+  const uint sets;
+  const uint assoc;
+
+  uint bimodalCnt;
+
+  // true 1 out of 32 calls (BIP/BRRIP throttle)
+  bool bimodalTick() {
+    bimodalCnt = (bimodalCnt + 1) & 31;
+    return bimodalCnt == 0;
+  }
+
+  ReplPolicy(uint s, uint a)
+    : sets(s)
+    ,assoc(a)
+    ,bimodalCnt(0) {
+  }
+
+public:
+  virtual ~ReplPolicy() { }
+
+  // 0 if name is not a policy of this framework
+  static ReplPolicy *create(const char *name, uint sets, uint assoc);
+  static bool isKnown(const char *name);
+
+  // (set,way) was accessed
+  virtual void touch(uint set, uint way) = 0;
+  // (set,way) was filled with a new line (miss)
+  virtual void insert(uint set, uint way) = 0;
+  // way to evict, allowed has at least one bit set
+  virtual uint victim(uint set, WayMask allowed) = 0;
+};
+
+// Set dueling monitor. A few leader sets always use policy A, a few
+// always use B, and a saturating counter (PSEL) counts the misses of each
+// group. Follower sets use the policy with fewer misses.
+class SetDuel {
+private:
+  enum { PselBits = 10, MaxLeaders = 32 };
+
+  uint region; // one leader of each kind per region, 0 no dueling
+  int  psel;
+
+public:
+  SetDuel(uint sets);
+
+  // 0 follower, 1 leader of A, 2 leader of B
+  int getLeader(uint set) const {
+    if (region == 0)
+      return 0;
+    uint r   = set / region;
+    uint off = set % region;
+    if (off == r % region)
+      return 1;
+    if (off == (r + region/2) % region)
+      return 2;
+    return 0;
+  }
+
+  void miss(uint set) {
+    int l = getLeader(set);
+    if (l == 1 && psel < (1<<PselBits) - 1)
+      psel++;
+    else if (l == 2 && psel > 0)
+      psel--;
+  }
+
+  bool useB(uint set) const {
+    int l = getLeader(set);
+    if (l)
+      return l == 2;
+    return psel >= (1<<(PselBits-1));
+  }
+};
+
+class PLRUReplPolicy : public ReplPolicy {
+private:
+  // Node n has children 2n+1 and 2n+2, bit set means the victim is in
+  // the right half
+  WayMask *tree;
+
+  static WayMask rangeMask(uint lo, uint hi) {
+    if (hi - lo == 64)
+      return ~static_cast<WayMask>(0);
+    return ((static_cast<WayMask>(1) << (hi - lo)) - 1) << lo;
+  }
+
+public:
+  PLRUReplPolicy(uint s, uint a);
+  ~PLRUReplPolicy();
+
+  void touch(uint set, uint way);
+  void insert(uint set, uint way) { touch(set, way); }
+  uint victim(uint set, WayMask allowed);
+};
+
+// LRU stack kept as ranks (no pointer shuffling). Insertion position
+// chosen by set dueling between MRU (LRU) and bimodal (BIP).
+class DIPReplPolicy : public ReplPolicy {
+private:
+  uchar  *rank; // rank[set*assoc+way], 0 is the MRU
+  SetDuel duel;
+
+  void promote(uint set, uint way);
+  void demote(uint set, uint way);
+
+public:
+  DIPReplPolicy(uint s, uint a);
+  ~DIPReplPolicy();
+
+  void touch(uint set, uint way) { promote(set, way); }
+  void insert(uint set, uint way);
+  uint victim(uint set, WayMask allowed);
+};
+
+class RRIPReplPolicy : public ReplPolicy {
+public:
+  enum Mode { SRRIP, BRRIP, DRRIP };
+
+private:
+  enum { MaxRRPV = 3 };
+
+  const Mode mode;
+  uchar  *rrpv; // rrpv[set*assoc+way]
+  SetDuel duel; // A is SRRIP, B is BRRIP
+
+public:
+  RRIPReplPolicy(uint s, uint a, Mode m);
+  ~RRIPReplPolicy();
+
+  void touch(uint set, uint way) { rrpv[set*assoc + way] = 0; }
+  void insert(uint set, uint way);
+  uint victim(uint set, WayMask allowed);
+};
+
+#endif // REPLPOLICY_H
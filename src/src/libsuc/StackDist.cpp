@@ -0,0 +1,240 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#include <algorithm>
+
+#include "SescConf.h"
+#include "ReportGen.h"
+#include "Snippets.h"
+#include "StackDist.h"
+
+/*********************** FAStack */
+
+StackDist::FAStack::FAStack()
+  : next(0)
+  ,nLive(0)
+{
+  tree.resize(65536 + 1, 0);
+}
+
+void StackDist::FAStack::update(int pos, int v)
+{
+  for(int i = pos + 1; i < (int)tree.size(); i += i & (-i))
+    tree[i] += v;
+}
+
+int StackDist::FAStack::prefix(int pos) const
+{
+  int sum = 0;
+  for(int i = pos + 1; i > 0; i -= i & (-i))
+    sum += tree[i];
+  return sum;
+}
+
+void StackDist::FAStack::compact()
+{
+  // renumber the live positions 0..nLive-1 keeping their order
+  std::vector<std::pair<int, LineAddr> > order;
+  order.reserve(last.size());
+  for(LastMap::iterator it = last.begin(); it != last.end(); it++)
+    order.push_back(std::make_pair(it->second, it->first));
+
+  std::sort(order.begin(), order.end());
+
+  int cap = 2 * nLive;
+  if (cap < 65536)
+    cap = 65536;
+
+  for(int i = 0; i < nLive; i++)
+    last[order[i].second] = i;
+
+  // linear Fenwick build
+  tree.assign(cap + 1, 0);
+  for(int i = 1; i <= cap; i++) {
+    if (i <= nLive)
+      tree[i] += 1;
+    int parent = i + (i & (-i));
+    if (parent <= cap)
+      tree[parent] += tree[i];
+  }
+
+  next = nLive;
+}
+
+int StackDist::FAStack::access(LineAddr line)
+{
+  if (next + 1 >= (int)tree.size())
+    compact();
+
+  int dist = -1;
+
+  LastMap::iterator it = last.find(line);
+  if (it != last.end()) {
+    dist = nLive - prefix(it->second);
+    update(it->second, -1);
+    nLive--;
+  }
+
+  last[line] = next;
+  update(next, 1);
+  next++;
+  nLive++;
+
+  return dist;
+}
+
+/*********************** StackDist */
+
+StackDist::StackDist(const char *section, const char *format,...)
+  : Log2LineSize(log2i(SescConf->getInt(section, "bsize")))
+{
+  char *str;
+  va_list ap;
+
+  va_start(ap, format);
+  str = getText(format, ap);
+  va_end(ap);
+
+  name = str;
+  subscribe();
+
+  SescConf->isPower2(section, "bsize");
+  SescConf->isPower2(section, "minSets");
+  SescConf->isPower2(section, "maxSets");
+  SescConf->isBetween(section, "maxAssoc", 1, 1024);
+
+  minSets  = SescConf->getInt(section, "minSets");
+  maxSets  = SescConf->getInt(section, "maxSets");
+  maxAssoc = SescConf->getInt(section, "maxAssoc");
+
+  if (minSets > maxSets) {
+    MSG("StackDist:minSets (%d) larger than maxSets (%d) in section [%s]"
+        , minSets, maxSets, section);
+    SescConf->notCorrect();
+  }
+
+  for(int n = minSets; n <= maxSets; n *= 2) {
+    SetStacks s;
+    s.nSets = n;
+    s.lines.resize(n * maxAssoc, 0);
+    s.nValid.resize(n, 0);
+    s.hits.resize(maxAssoc, 0);
+    stacks.push_back(s);
+  }
+
+  fa = 0;
+  if (SescConf->checkBool(section, "fullAssoc") && SescConf->getBool(section, "fullAssoc"))
+    fa = new FAStack;
+
+  nAccess = 0;
+  nCold   = 0;
+}
+
+StackDist::~StackDist()
+{
+  delete fa;
+}
+
+void StackDist::accessSet(SetStacks &s, LineAddr line)
+{
+  int set = line & (s.nSets - 1);
+  LineAddr *stack = &s.lines[set * maxAssoc];
+  int n = s.nValid[set];
+
+  int d = 0;
+  while(d < n && stack[d] != line)
+    d++;
+
+  if (d < n) {
+    s.hits[d]++;
+  } else if (n < maxAssoc) {
+    s.nValid[set]++;
+  } else {
+    d = maxAssoc - 1; // LRU line is dropped
+  }
+
+  // move to the MRU position
+  for(int i = d; i > 0; i--)
+    stack[i] = stack[i - 1];
+  stack[0] = line;
+}
+
+void StackDist::access(unsigned long addr)
+{
+  LineAddr line = addr >> Log2LineSize;
+
+  nAccess++;
+
+  for(size_t i = 0; i < stacks.size(); i++)
+    accessSet(stacks[i], line);
+
+  if (fa == 0)
+    return;
+
+  int dist = fa->access(line);
+  if (dist < 0) {
+    nCold++;
+    return;
+  }
+
+  size_t b = dist ? log2i(dist) + 1 : 0;
+  if (b >= faHist.size())
+    faHist.resize(b + 1, 0);
+  faHist[b]++;
+}
+
+void StackDist::reportValue() const
+{
+  Report::field("%s:nAccess=%lld", name, nAccess);
+
+  double div = nAccess ? nAccess : 1;
+
+  for(size_t i = 0; i < stacks.size(); i++) {
+    const SetStacks &s = stacks[i];
+
+    long long hits = 0;
+    for(int a = 1; a <= maxAssoc; a++) {
+      hits += s.hits[a - 1];
+
+      // powers of two and the largest configuration only
+      if ((a & (a - 1)) && a != maxAssoc)
+        continue;
+
+      long long misses = nAccess - hits;
+      Report::field("%s_S%dA%d:size=%ld:misses=%lld:missRate=%.4f", name
+                    , s.nSets, a, (long)s.nSets * a << Log2LineSize
+                    , misses, misses / div);
+    }
+  }
+
+  if (fa == 0)
+    return;
+
+  Report::field("%s_FA:nCold=%lld", name, nCold);
+
+  // a cache of 2^c lines misses on the distances >= 2^c
+  long long hits = 0;
+  for(size_t c = 0; c < faHist.size(); c++) {
+    hits += faHist[c];
+
+    long long misses = nAccess - hits;
+    Report::field("%s_FA(%ld):size=%ld:misses=%lld:missRate=%.4f", name
+                  , 1L << c, (1L << c) << Log2LineSize, misses, misses / div);
+  }
+}
@@ -0,0 +1,109 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef STACKDIST_H
+#define STACKDIST_H
+
+#include <vector>
+
+#include "estl.h"
+#include "nanassert.h"
+#include "GStats.h"
+
+// Single pass LRU stack distance profiler. It computes in one run the
+// miss rate of every LRU cache with minSets..maxSets sets (powers of
+// two) and 1..maxAssoc ways:
+//
+//  - for each number of sets, each set keeps an LRU stack of maxAssoc
+//    lines. An access at depth d hits in every cache with more than d
+//    ways (inclusion property of LRU).
+//
+//  - for the fully associative caches (fullAssoc = true), the distance
+//    is the number of different lines touched since the last access to
+//    the line. It is counted with a Fenwick tree over the access times
+//    where only the last access of each line is marked.
+//
+// Configuration section:
+//   bsize     = 64        # line size
+//   minSets   = 16
+//   maxSets   = 4096
+//   maxAssoc  = 16
+//   fullAssoc = true      # optional
+//
+// The results are reported as "name_S<sets>A<assoc>" (and
+// "name_FA(lines)") with the cache size, number of misses and miss rate.
+class StackDist : public GStats {
+private:
+  typedef unsigned long LineAddr;
+
+  // Set associative stacks for one number of sets
+  class SetStacks {
+  public:
+    int nSets;
+    std::vector<LineAddr> lines;    // nSets * maxAssoc, MRU first
+    std::vector<int>      nValid;   // per set
+    std::vector<long long> hits;    // hits at each depth
+  };
+
+  // Fully associative stack
+  class FAStack {
+  private:
+    typedef HASH_MAP<LineAddr, int> LastMap;
+
+    LastMap last;               // line -> position of its last access
+    std::vector<int> tree;      // Fenwick tree, 1 for live positions
+    int next;
+    int nLive;
+
+    void update(int pos, int v);
+    int  prefix(int pos) const; // live positions <= pos
+    void compact();
+
+  public:
+    FAStack();
+
+    // returns -1 for the first access to the line
+    int access(LineAddr line);
+  };
+
+  const int Log2LineSize;
+  int minSets;
+  int maxSets;
+  int maxAssoc;
+
+  std::vector<SetStacks> stacks;
+
+  FAStack *fa;
+  std::vector<long long> faHist; // log2 buckets of distance+1
+
+  long long nAccess;
+  long long nCold;
+
+  void accessSet(SetStacks &s, LineAddr line);
+
+public:
+  StackDist(const char *section, const char *format,...);
+  ~StackDist();
+
+  void access(unsigned long addr);
+
+  void reportValue() const;
+};
+
+#endif // STACKDIST_H
@@ -0,0 +1,385 @@
+/*
+   SESC: Super ESCalar simulator
+   Copyright (C) 2003 University of Illinois.
+
+   Code based on Jose Martinez pool code (Thanks)
+
+   Contributed by Jose Renau
+                  Milos Prvulovic
+                  James Tuck
+
+This file is part of SESC.
+
+SESC is free software; you can redistribute it and/or modify it under the terms
+of the GNU General Public License as published by the Free Software Foundation;
+either version 2, or (at your option) any later version.
+
+SESC is    distributed in the  hope that  it will  be  useful, but  WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+You should  have received a copy of  the GNU General  Public License along with
+SESC; see the file COPYING.  If not, write to the  Free Software Foundation, 59
+Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+#ifndef _SPOOL_H
+#define _SPOOL_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <vector>
+
+#include "nanassert.h"
+#include "Snippets.h"
+#include "GStats.h"
+#include "ReportGen.h"
+
+// Sharded pool. Same interface as pool<> but the free list is split in
+// nShards lists (one per core/context). out(id) hands out nodes from the
+// shard id, and only one thread may call out() for a given shard.
+//
+// in() may be called from any thread. The node goes back to the inbound
+// list of the shard that handed it out, a lock free stack (one
+// compare&swap per in()). The owner takes the whole inbound list when its
+// free list runs dry.
+//
+// When a shard has too many free nodes, batches of Size nodes are moved to
+// a shared depot. When a shard runs dry and its inbound list is empty, it
+// grabs a batch from the depot before allocating new memory. The depot is
+// protected with a spinlock (rebalancing is rare).
+//
+// Holders are allocated in cache line aligned blocks, and each Holder
+// starts in its own cache line (false sharing between shards).
+//
+// The pool exports some statistics: maximum number of objects in flight
+// (sizing), number of nodes allocated, depot transfers and the average
+// reuse distance (number of out() of the shard between an in() and the
+// next out() of the same node; a node taken from the depot counts from
+// the transfer). They are kept per shard and added up at report time. The in flight maximum is the sum of the per shard maxima.
+
+#ifndef SPOOL_LINE_SIZE
+#define SPOOL_LINE_SIZE 64
+#endif
+
+template<class Ttype, int nShards=16>
+class spool {
+protected:
+  class Holder : public Ttype {
+  public:
+    Holder *holderNext;
+    unsigned long long inStamp; // nOuts of the shard holding it when it was freed
+    int     shard;              // shard that handed out the node
+    ID(bool inPool;)
+  };
+
+  class Shard {
+  public:
+    // Owner thread only
+    Holder *first;  // List of free nodes
+    long    nFree;
+
+    unsigned long long nOuts;
+    long long nAlloc;
+    long long nRebalance;
+    long long reuseDist;
+    long      maxInFlight;
+
+    // Any thread (in), own cache line
+    class Inbound {
+    public:
+      Holder   *first;
+      long long nIns;
+    } __attribute__ ((aligned (SPOOL_LINE_SIZE)));
+
+    Inbound inbound;
+  } __attribute__ ((aligned (SPOOL_LINE_SIZE)));
+
+  class Stats : public GStats {
+  private:
+    const spool *pool;
+  public:
+    Stats(const spool *p, const char *n) : pool(p) {
+      name = strdup(n);
+      subscribe();
+    }
+    void reportValue() const { pool->report(); }
+  };
+
+  static const size_t HolderStride
+    = (sizeof(Holder) + SPOOL_LINE_SIZE - 1) & ~(SPOOL_LINE_SIZE - 1);
+
+  Shard shards[nShards];
+
+  ID(bool deleted;)
+
+  const int Size;     // Reproduction size (per shard)
+  const int MaxFree;  // Free nodes per shard before giving a batch to the depot
+  const char *Name;
+
+  // Shared depot of free nodes (used only by rebalance)
+  Holder *depot;
+  long    nDepot;
+  volatile int depotLock;
+
+  std::vector<void *> blocks;
+
+  Stats *stats;
+
+  void lockDepot() {
+    while(__sync_lock_test_and_set(&depotLock, 1))
+      ;
+  }
+  void unlockDepot() {
+    __sync_lock_release(&depotLock);
+  }
+
+  void reproduce(Shard *s) {
+    I(s->first==0);
+
+    void *mem;
+    if (posix_memalign(&mem, SPOOL_LINE_SIZE, HolderStride*Size)) {
+      MSG("%s:spool could not allocate %d nodes", Name, Size);
+      exit(-1);
+    }
+    lockDepot();
+    blocks.push_back(mem);
+    unlockDepot();
+
+    char *ptr = static_cast<char *>(mem);
+    for(int i = 0; i < Size; i++) {
+      Holder *h = ::new(ptr + i*HolderStride) Holder;
+      h->holderNext = s->first;
+      h->inStamp    = s->nOuts;
+      IS(h->inPool = true);
+      s->first = h;
+    }
+    s->nFree  += Size;
+    s->nAlloc += Size;
+  }
+
+  // Move a batch of nodes from the shard to the depot
+  void giveToDepot(Shard *s) {
+    Holder *head = s->first;
+    Holder *tail = head;
+    for(int i = 1; i < Size; i++)
+      tail = tail->holderNext;
+    s->first  = tail->holderNext;
+    s->nFree -= Size;
+
+    lockDepot();
+    tail->holderNext = depot;
+    depot   = head;
+    nDepot += Size;
+    unlockDepot();
+
+    s->nRebalance++;
+  }
+
+  // Try to get a batch of nodes from the depot. false if depot empty
+  bool takeFromDepot(Shard *s) {
+    I(s->first==0);
+
+    lockDepot();
+    Holder *head = depot;
+    Holder *tail = 0;
+    Holder *h    = depot;
+    int n = 0;
+    while(h && n < Size) {
+      // The stamp was taken on the nOuts of another shard
+      h->inStamp = s->nOuts;
+      tail = h;
+      h    = h->holderNext;
+      n++;
+    }
+    depot   = h;
+    nDepot -= n;
+    unlockDepot();
+
+    if (n == 0)
+      return false;
+
+    tail->holderNext = 0;
+    s->first = head;
+    s->nFree = n;
+
+    s->nRebalance++;
+    return true;
+  }
+
+  // Take every node returned to the shard. false if there was none
+  bool takeInbound(Shard *s) {
+    I(s->first==0);
+
+    Holder *head;
+    do {
+      head = __atomic_load_n(&s->inbound.first, __ATOMIC_ACQUIRE);
+      if (head == 0)
+        return false;
+    }while(!__sync_bool_compare_and_swap(&s->inbound.first, head, (Holder *)0));
+
+    long n = 0;
+    for(Holder *h = head; h; h = h->holderNext)
+      n++;
+
+    s->first = head;
+    s->nFree = n;
+
+    while(s->nFree > MaxFree)
+      giveToDepot(s);
+
+    return true;
+  }
+
+  static void freeList(Holder *h) {
+    while(h) {
+      Holder *next = h->holderNext;
+      h->~Holder();
+      h = next;
+    }
+  }
+
+public:
+  spool(int s = 32, const char *n = "spool name not declared")
+    : Size(s)
+    , MaxFree(4*s)
+    , Name(n)
+    {
+    I(Size > 0);
+    IS(deleted=false);
+
+    depot     = 0;
+    nDepot    = 0;
+    depotLock = 0;
+
+    // Shards are populated lazily. Single threaded runs only pay for
+    // shard 0
+    for(int i = 0; i < nShards; i++) {
+      Shard *sh = &shards[i];
+      sh->first       = 0;
+      sh->nFree       = 0;
+      sh->nOuts       = 0;
+      sh->nAlloc      = 0;
+      sh->nRebalance  = 0;
+      sh->reuseDist   = 0;
+      sh->maxInFlight = 0;
+      sh->inbound.first = 0;
+      sh->inbound.nIns  = 0;
+    }
+    reproduce(&shards[0]);
+
+    stats = new Stats(this, Name);
+  }
+
+  ~spool() {
+    // Like pool, nodes still out are leaked. Memory blocks are only
+    // released if everything came back.
+    IS(deleted=true);
+    delete stats;
+
+    if (getInFlight())
+      return;
+
+    for(int i = 0; i < nShards; i++) {
+      freeList(shards[i].first);
+      freeList(shards[i].inbound.first);
+    }
+    freeList(depot);
+    for(size_t i = 0; i < blocks.size(); i++)
+      free(blocks[i]);
+    blocks.clear();
+  }
+
+  void in(Ttype *data) {
+    I(!deleted);
+    Holder *h = static_cast<Holder *>(data);
+
+    I(!h->inPool);
+    IS(h->inPool=true);
+
+    Shard *s = &shards[h->shard];
+
+    // Owner counter read from any thread, only used for the reuse distance
+    h->inStamp = __atomic_load_n(&s->nOuts, __ATOMIC_RELAXED);
+
+    Holder *head;
+    do {
+      head = __atomic_load_n(&s->inbound.first, __ATOMIC_RELAXED);
+      h->holderNext = head;
+    }while(!__sync_bool_compare_and_swap(&s->inbound.first, head, h));
+
+    __sync_fetch_and_add(&s->inbound.nIns, 1);
+  }
+
+  Ttype *out(int shardId = 0) {
+    I(!deleted);
+    I(shardId >= 0);
+
+    int sId = shardId % nShards;
+    if (sId < 0)
+      sId += nShards;
+    Shard *s = &shards[sId];
+
+    if (s->first == 0) {
+      if (!takeInbound(s) && !takeFromDepot(s))
+        reproduce(s);
+    }
+
+    Holder *h = s->first;
+    I(h);
+    I(h->inPool);
+    IS(h->inPool=false);
+
+    s->first = h->holderNext;
+    s->nFree--;
+
+    h->shard = sId;
+
+    // nOuts is read by in() from other threads (plain store on x86)
+    unsigned long long nOuts = s->nOuts;
+    s->reuseDist += nOuts - h->inStamp;
+    __atomic_store_n(&s->nOuts, nOuts + 1, __ATOMIC_RELAXED);
+
+    long inFlight = (long)(nOuts + 1 - __atomic_load_n(&s->inbound.nIns, __ATOMIC_RELAXED));
+    if (inFlight > s->maxInFlight)
+      s->maxInFlight = inFlight;
+
+    return h;
+  }
+
+  long getInFlight() const {
+    long n = 0;
+    for(int i = 0; i < nShards; i++)
+      n += (long)(shards[i].nOuts - __atomic_load_n(&shards[i].inbound.nIns, __ATOMIC_RELAXED));
+    return n;
+  }
+
+  long getMaxInFlight() const {
+    long n = 0;
+    for(int i = 0; i < nShards; i++)
+      n += shards[i].maxInFlight;
+    return n;
+  }
+
+  void report() const {
+    long long nOuts      = 0;
+    long long nAlloc     = 0;
+    long long nRebalance = 0;
+    long long reuseDist  = 0;
+    for(int i = 0; i < nShards; i++) {
+      nOuts      += shards[i].nOuts;
+      nAlloc     += shards[i].nAlloc;
+      nRebalance += shards[i].nRebalance;
+      reuseDist  += shards[i].reuseDist;
+    }
+
+    Report::field("%s:poolInFlight:max=%ld:n=%lld", Name, getMaxInFlight(), nOuts);
+    Report::field("%s:poolAlloc=%lld", Name, nAlloc);
+    Report::field("%s:poolRebalance=%lld", Name, nRebalance);
+    Report::field("%s:poolReuseDist:v=%g:n=%lld", Name
+                  ,nOuts ? (double)reuseDist/nOuts : 0, nOuts);
+  }
+};
+
+#endif  // _SPOOL_H
@@ -141,6 +141,25 @@ bool transCoherence::checkAbort(int pid, int tid)
     return false;
 }
 
+/**
+ * @ingroup transCoherence
+ * @brief a line of the read/write set of pid was displaced from the cache
+ * and the hardware cannot track it anymore. The transaction aborts at its
+ * next transactional access or commit
+ *
+ * @param pid Process ID
+ * @param raddr Address of the displaced line
+ */
+void transCoherence::overflowAbort(int pid, RAddr raddr)
+{
+  if(transState[pid].state != RUNNING && transState[pid].state != NACKED)
+    return;
+
+  transState[pid].state = DOABORT;
+  abortReason[pid].first =  pid;
+  abortReason[pid].second = addrToCacheLine(raddr);
+}
+
 /**************************************
  *   Standard Eager / Eager Methods   *
  **************************************/
@@ -24,6 +24,7 @@
 #include <map>
 #include <set>
 #include "icode.h"
+#include "HostProf.h"
 
 #define MAX_CPU_COUNT 2048
 
@@ -116,6 +117,14 @@ class transCoherence{
     {
       return transState[cpu].state == NACKED;
     }
+    //!  Extends the current stall of cpu (if any) by stall cycles
+    void addStall(int cpu, Time_t stall){
+      if(stallCycle[cpu] < globalClock)
+        stallCycle[cpu] = globalClock;
+      stallCycle[cpu] += stall;
+    }
+    long long getRunningUtid(int pid) const;
+    void overflowAbort(int pid, RAddr raddr);
 
 
   private:
@@ -154,28 +163,45 @@ inline RAddr transCoherence::addrToCacheLine(RAddr raddr){
 }
 
 inline GCMRet transCoherence::read(int pid, int tid, RAddr raddr){
+  HOSTPROF_SCOPE(HP_TransCoherence);
   return (this->*readPtr)(pid, tid, raddr);
 }
 
 inline GCMRet transCoherence::write(int pid, int tid, RAddr raddr){
+  HOSTPROF_SCOPE(HP_TransCoherence);
   return (this->*writePtr)(pid, tid, raddr);
 }
 
 inline struct GCMFinalRet transCoherence::abort(thread_ptr pthread, int tid){
+  HOSTPROF_SCOPE(HP_TransCoherence);
   return (this->*abortPtr)(pthread, tid);
 }
 
 inline struct GCMFinalRet transCoherence::commit(int pid, int tid){
+  HOSTPROF_SCOPE(HP_TransCoherence);
   return (this->*commitPtr)(pid, tid);
 }
 
 inline struct GCMFinalRet transCoherence::begin(int pid, icode_ptr picode){
+  HOSTPROF_SCOPE(HP_TransCoherence);
   return (this->*beginPtr)(pid, picode);
 }
 
 inline int transCoherence::getVersioning(){
   return versioning;
 }
+/**
+ * @brief utid of the transaction that pid is running, -1 if none. Used by
+ * the timing caches to know if their speculative bits are still valid
+ */
+inline long long transCoherence::getRunningUtid(int pid) const{
+  if(tmDepth[pid] == 0)
+    return -1;
+  condition s = transState[pid].state;
+  if(s != RUNNING && s != NACKED && s != COMMITTING)
+    return -1;
+  return transState[pid].utid;
+}
 
 extern transCoherence *transGCM;
 extern Time_t globalClock;
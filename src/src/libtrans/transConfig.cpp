@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @brief   This is the implementation for the transactional memory configuration module.
+ *
+ * @section LICENSE
+ * Copyright: See COPYING file that comes with this distribution
+ *
+ * @section DESCRIPTION
+ * C++ Implementation: transConfig
+ */
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "transConfig.h"
+
+transConfig *tmConfig = 0;
+
+/**
+ * @ingroup transConfig
+ * @brief   Constructor, binds and checks all the TM parameters
+ *
+ * @param conf Configuration file
+ */
+transConfig::transConfig(Config *conf)
+  : ConfParams("TransactionalMemory")
+{
+  const char *sec = "TransactionalMemory";
+
+  bindInt(conf, sec, "printDetailedTrace", &printDetailedTrace);
+  bindInt(conf, sec, "printTransactionalReport", &printTransactionalReport);
+  bindInt(conf, sec, "printTransactionalReportSummary", &printTransactionalReportSummary);
+  bindInt(conf, sec, "printSummaryReport", &printSummaryReport);
+  bindInt(conf, sec, "traceToFile", &traceToFile);
+  bindCharPtr(conf, sec, "traceFile", &traceFile);
+
+  bindInt(conf, sec, "conflictDetect", &conflictDetect, 0, 1);
+  bindInt(conf, sec, "versioning", &versioning, 0, 1);
+  bindInt(conf, sec, "cacheLineSize", &cacheLineSize, 1, 4096);
+
+  bindInt(conf, sec, "primaryBaseStallCycles", &primaryBaseStallCycles, 0, 1000000);
+  bindInt(conf, sec, "primaryVarStallCycles", &primaryVarStallCycles, 0, 1000000);
+  bindInt(conf, sec, "secondaryBaseStallCycles", &secondaryBaseStallCycles, 0, 1000000);
+  bindInt(conf, sec, "secondaryVarStallCycles", &secondaryVarStallCycles, 0, 1000000);
+  bindInt(conf, sec, "nackStallCycles", &nackStallCycles, 0, 1000000);
+  bindInt(conf, sec, "abortExpBackoff", &abortExpBackoff);
+  bindInt(conf, sec, "abortLinBackoff", &abortLinBackoff);
+  bindInt(conf, sec, "applyRandomization", &applyRandomization, 0, 100);
+
+  // Eager versioning pays on abort, lazy versioning pays on commit
+  if (versioning) {
+    abortBaseStallCycles  = primaryBaseStallCycles;
+    abortVarStallCycles   = primaryVarStallCycles;
+    commitBaseStallCycles = secondaryBaseStallCycles;
+    commitVarStallCycles  = secondaryVarStallCycles;
+  } else {
+    abortBaseStallCycles  = secondaryBaseStallCycles;
+    abortVarStallCycles   = secondaryVarStallCycles;
+    commitBaseStallCycles = primaryBaseStallCycles;
+    commitVarStallCycles  = primaryVarStallCycles;
+  }
+
+  bindInt(conf, sec, "memDebugTrace", &memDebugTrace);
+  bindInt(conf, sec, "calculateFullReadWriteSet", &calculateFullReadWriteSet);
+  bindInt(conf, sec, "limitAborts", &limitAborts);
+  bindInt(conf, sec, "maxAborts", &maxAborts);
+  bindInt(conf, sec, "tmDebugMode", &tmDebugMode);
+  bindInt(conf, sec, "printRealBCTimes", &printRealBCTimes);
+  bindInt(conf, sec, "printAllNacks", &printAllNacks);
+  bindInt(conf, sec, "recordTransMemRefs", &recordTransMemRefs);
+  bindInt(conf, sec, "enableBeginTMStats", &enableBeginTMStats);
+  bindInt(conf, sec, "transReportFlush", &transReportFlush);
+}
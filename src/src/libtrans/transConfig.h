@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief   This is the interface for the transactional memory configuration module.
+ *
+ * @section LICENSE
+ * Copyright: See COPYING file that comes with this distribution
+ *
+ * @section DESCRIPTION
+ * C++ Interface: transConfig \n
+ * All the [TransactionalMemory] parameters are read and checked once at
+ * startup. The TM modules (transContext, transReport, transCoherence and
+ * ThreadContext) use the fields of tmConfig instead of querying SescConf,
+ * since some of them are created on every tm_begin.
+ *
+ */
+/////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TRANSACTION_CONFIG
+#define TRANSACTION_CONFIG
+
+#include "ConfParams.h"
+
+/**
+ * @ingroup transConfig
+ * @brief   TM configuration parameters
+ *
+ * Typed copy of the TransactionalMemory section of the configuration file.
+ */
+class transConfig : public ConfParams
+{
+  public:
+    /* Constructor */
+    transConfig(Config *conf);
+
+    /* Output Options */
+    int         printDetailedTrace;
+    int         printTransactionalReport;
+    int         printTransactionalReportSummary;
+    int         printSummaryReport;
+    int         traceToFile;
+    const char *traceFile;
+
+    /* Coherence Protocol Options */
+    int         conflictDetect;
+    int         versioning;
+    int         cacheLineSize;
+
+    /* Stall Cycle Lengths */
+    int         primaryBaseStallCycles;
+    int         primaryVarStallCycles;
+    int         secondaryBaseStallCycles;
+    int         secondaryVarStallCycles;
+    int         nackStallCycles;
+    int         abortExpBackoff;
+    int         abortLinBackoff;
+    int         applyRandomization;
+
+    /* Derived from versioning (Primary is the long operation) */
+    int         abortBaseStallCycles;
+    int         abortVarStallCycles;
+    int         commitBaseStallCycles;
+    int         commitVarStallCycles;
+
+    /* Debugging Options */
+    int         memDebugTrace;
+    int         calculateFullReadWriteSet;
+    int         limitAborts;
+    int         maxAborts;
+    int         tmDebugMode;
+    int         printRealBCTimes;
+    int         printAllNacks;
+    int         recordTransMemRefs;
+    int         enableBeginTMStats;
+    int         transReportFlush;
+};
+
+extern transConfig *tmConfig;
+#endif
@@ -16,6 +16,7 @@
 #include <math.h>
 #include "transContext.h"
 #include "transReport.h"
+#include "transConfig.h"
 #include "ThreadContext.h"
 #include "transCoherence.h"
 #include "opcodes.h"
@@ -28,7 +29,7 @@
  */
 transactionContext::transactionContext()
 {
-  nackStallCycles = SescConf->getInt("TransactionalMemory","nackStallCycles");
+  nackStallCycles = tmConfig->nackStallCycles;
   nackInstruction = NULL;
 }
 
@@ -41,31 +42,17 @@ transactionContext::transactionContext()
  */
 transactionContext::transactionContext(thread_ptr pthread, icode_ptr picode)
 {
-  nackStallCycles = SescConf->getInt("TransactionalMemory","nackStallCycles");
+  nackStallCycles = tmConfig->nackStallCycles;
 
-  if( transGCM->getVersioning() == 0 )
-  {
-    abortBaseStallCycles = SescConf->getInt("TransactionalMemory","secondaryBaseStallCycles");
-    abortVarStallCycles = SescConf->getInt("TransactionalMemory","secondaryVarStallCycles");
-    commitBaseStallCycles = SescConf->getInt("TransactionalMemory","primaryBaseStallCycles");
-    commitVarStallCycles = SescConf->getInt("TransactionalMemory","primaryVarStallCycles");
-  }
-  else if (transGCM->getVersioning() == 1 )
-  {
-    abortBaseStallCycles = SescConf->getInt("TransactionalMemory","primaryBaseStallCycles");
-    abortVarStallCycles = SescConf->getInt("TransactionalMemory","primaryVarStallCycles");
-    commitBaseStallCycles = SescConf->getInt("TransactionalMemory","secondaryBaseStallCycles");
-    commitVarStallCycles = SescConf->getInt("TransactionalMemory","secondaryVarStallCycles");
-  }
-  else
-  {
-    fprintf(stderr,"Unsupported Versioning Provided\n");
-    exit(0);
-  }
+  // Already resolved for the versioning policy
+  abortBaseStallCycles = tmConfig->abortBaseStallCycles;
+  abortVarStallCycles = tmConfig->abortVarStallCycles;
+  commitBaseStallCycles = tmConfig->commitBaseStallCycles;
+  commitVarStallCycles = tmConfig->commitVarStallCycles;
 
-  abortExpBackoff = SescConf->getInt("TransactionalMemory","abortExpBackoff");
-  abortLinBackoff = SescConf->getInt("TransactionalMemory","abortLinBackoff");
-  applyRandomization = SescConf->getInt("TransactionalMemory","applyRandomization");
+  abortExpBackoff = tmConfig->abortExpBackoff;
+  abortLinBackoff = tmConfig->abortLinBackoff;
+  applyRandomization = tmConfig->applyRandomization;
 
   nackInstruction=NULL;
   beginTransaction(pthread,picode);
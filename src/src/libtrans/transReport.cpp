@@ -14,6 +14,8 @@
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "transReport.h"
+#include "transConfig.h"
+#include "HostProf.h"
 
 
 /**
@@ -29,7 +31,7 @@ transReport::transReport(const char *reportFileName)
     char filename[120],buffer[40];
     int i,j;
 
-    char *name = strdup(SescConf->getCharPtr("TransactionalMemory","traceFile"));
+    char *name = strdup(tmConfig->traceFile);
 
     if(strcmp(name,""))
       sprintf(filename,"%s-%s",reportFileName,name);
@@ -43,22 +45,22 @@ transReport::transReport(const char *reportFileName)
     strftime(buffer,40,"-%b%d.%Y-%H.%M.%S-tmDebug",timeinfo);
     strcat(filename,buffer);
 
-    if(SescConf->getInt("TransactionalMemory","traceToFile"))
+    if(tmConfig->traceToFile)
       outfile = fopen(filename,"a");
     else
       outfile = stderr;
 
-    if(SescConf->getInt("TransactionalMemory","printRealBCTimes"))
+    if(tmConfig->printRealBCTimes)
       printRealBCTimes = 1;
     else 
       printRealBCTimes = 0;
 
-    if(SescConf->getInt("TransactionalMemory","printDetailedTrace"))
+    if(tmConfig->printDetailedTrace)
       printDetailedTrace = 1;
     else
       printDetailedTrace = 0;
 
-    if(SescConf->getInt("TransactionalMemory","printSummaryReport"))
+    if(tmConfig->printSummaryReport)
       printSummaryReport = 1;
     else
       printSummaryReport = 0;
@@ -68,36 +70,36 @@ transReport::transReport(const char *reportFileName)
     printTransactionalReportSummary = 0;
     printTransactionalReportDetail = 0;
 
-    if( SescConf->getInt("TransactionalMemory","printTransactionalReport") )
+    if( tmConfig->printTransactionalReport )
     {
       transactionalReport = 1;
       printTransactionalReportDetail = 1;
       fprintf(outfile,"<Trans> tmReport:HEADER:UTID:PID:CPU:TID:PC:ABORT?:INST_COUNT:READ_SET_SIZE:READS:WRITE_SET_SIZE:WRITES:CYCLE_LENGTH:READ_SET:WRITE_SET:CONFLICT_LIST:FP_OP_COUNT:COMMITTED_INSTCOUNT_AT_BEGIN:STALLED_CYCLES\n");
     }
 
-    if (SescConf->getInt("TransactionalMemory","printTransactionalReportSummary") )
+    if (tmConfig->printTransactionalReportSummary )
     {
       transactionalReport = 1;
       printTransactionalReportSummary = 1;
     }
 
-    if(SescConf->getInt("TransactionalMemory","calculateFullReadWriteSet"))
+    if(tmConfig->calculateFullReadWriteSet)
     {
       transactionalReport = 1;
       calculateFullReadWriteSet = 1;
     }
 
-    if(SescConf->getInt("TransactionalMemory","printAllNacks"))
+    if(tmConfig->printAllNacks)
       printAllNacks = 1;
     else 
       printAllNacks = 0;
 
-    if(SescConf->getInt("TransactionalMemory","recordTransMemRefs"))
+    if(tmConfig->recordTransMemRefs)
       recordTransMemRefs = 1;
     else 
       recordTransMemRefs = 0;
 
-    maxCount = SescConf->getInt("TransactionalMemory","transReportFlush");
+    maxCount = tmConfig->transReportFlush;
     outCount = maxCount;
 
     summaryCommitCount = 0;
@@ -146,7 +148,7 @@ transReport::transReport(const char *reportFileName)
     }
 
 
-  if(SescConf->getInt("TransactionalMemory","enableBeginTMStats"))
+  if(tmConfig->enableBeginTMStats)
     recordTMStart = 1;
   else
     recordTMStart = 0;
@@ -165,6 +167,7 @@ transReport::transReport(const char *reportFileName)
  */
 void transReport::reportCommit(int pid)
 {
+  HOSTPROF_SCOPE(HP_TransReport);
   struct transRef temp = commits[pid].front();
   commits[pid].pop();
 
@@ -228,6 +231,7 @@ void transReport::reportCommit(int pid)
  */
 void transReport::reportBegin(int pid, int cpu)
 {
+  HOSTPROF_SCOPE(HP_TransReport);
   struct transRef temp = begins[pid].front();
   begins[pid].pop();
 
@@ -428,6 +432,7 @@ void transReport::reportNackCommitFN(ID utid, int pid, int tid, unsigned long lo
  * @param pid  Process ID
  */
 void transReport::reportLoad(int pid){
+  HOSTPROF_SCOPE(HP_TransReport);
   struct memRef temp = loads[pid].front();
   loads[pid].pop();
   tempInstCount[pid][transLoad]++;
@@ -460,6 +465,7 @@ void transReport::reportLoad(int pid){
  * @param pid  Process ID
  */
 void transReport::reportStore(int pid){
+  HOSTPROF_SCOPE(HP_TransReport);
   struct memRef temp = stores[pid].front();
   stores[pid].pop();
   tempInstCount[pid][transStore]++;
@@ -790,6 +796,8 @@ void transReport::reportNackCommit(ID utid,int pid, int tid, int nackPid, TIMEST
  */
 void transReport::reportAbort(ID utid,int pid, int tid, int nackPid, RAddr raddr, RAddr caddr, TIMESTAMP myTimestamp, TIMESTAMP nackTimestamp)
 {
+  HOSTPROF_SCOPE(HP_TransReport);
+
   //! Handle the case for the Eager approaches
   if(nackingAddr[pid] != 0)
   {
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ReportGen.h"
+#include "CacheCore.h"
+
+// Runs CacheAssocPacked (xxxPackedTags) in lockstep with CacheAssoc on a
+// random stream of lookups, replacements, retags, invalidations and lock
+// changes. Both must return the same line every time.
+
+class CheckState : public StateGeneric<> {
+public:
+  bool locked;
+
+  CheckState() {
+    locked = false;
+  }
+  bool isLocked() const {
+    return locked && isValid();
+  }
+  void invalidate() {
+    clearTag();
+    locked = false;
+  }
+};
+
+typedef CacheGeneric<CheckState> MyCacheType;
+typedef MyCacheType::CacheLine   Line;
+
+static bool sameLine(const Line *a, const Line *b)
+{
+  if (a == 0 || b == 0)
+    return a == b;
+
+  return a->getTag() == b->getTag() && a->locked == b->locked;
+}
+
+static void fail(const char *op, const char *policy, int assoc, int step)
+{
+  fprintf(stderr,"ERROR: %s differs (%s, assoc %d, access %d)\n"
+          ,op, policy, assoc, step);
+  exit(-1);
+}
+
+static int check(const char *policy, int assoc, int nAccesses)
+{
+  const int nSets  = 8;
+  const int bsize  = 64;
+  const int nAddrs = 3*assoc*nSets; // working set of 3 times the cache
+
+  MyCacheType *ref = MyCacheType::create(assoc*nSets*bsize, assoc, bsize, 1, policy, false, false);
+  MyCacheType *pck = MyCacheType::create(assoc*nSets*bsize, assoc, bsize, 1, policy, false, true);
+
+  // Lines held by the user across other accesses, retagged later
+  Line *heldRef = 0;
+  Line *heldPck = 0;
+
+  int hits = 0;
+  for(int i = 0; i < nAccesses; i++) {
+    ulong addr = (rand() % nAddrs + 1)*bsize;
+    int   op   = rand() % 10;
+
+    if (op < 5) {
+      Line *a = ref->findLineNoEffect(addr);
+      Line *b = pck->findLineNoEffect(addr);
+      if (!sameLine(a, b))
+        fail("findLine", policy, assoc, i);
+      if (a == 0)
+        continue;
+
+      hits++;
+      if (rand() % 20 == 0) {
+        a->invalidate();
+        b->invalidate();
+      }else if (rand() % 30 == 0) {
+        a->locked = !a->locked;
+        b->locked = a->locked;
+      }else if (rand() % 25 == 0 && heldRef == 0) {
+        heldRef = a;
+        heldPck = b;
+      }
+    }else if (op < 9) {
+      bool ignoreLocked = (rand() % 4) == 0;
+      Line *a = ref->findLine2Replace(addr, ignoreLocked);
+      Line *b = pck->findLine2Replace(addr, ignoreLocked);
+      if (!sameLine(a, b))
+        fail("findLine2Replace", policy, assoc, i);
+      if (a == 0)
+        continue;
+
+      a->setTag(ref->calcTag(addr));
+      b->setTag(pck->calcTag(addr));
+      a->locked = false;
+      b->locked = false;
+    }else{
+      uint l  = rand() % ref->getNumLines();
+      Line *a = ref->getPLine(l);
+      Line *b = pck->getPLine(l);
+      if (!sameLine(a, b))
+        fail("getPLine", policy, assoc, i);
+      if (rand() % 2) {
+        a->invalidate();
+        b->invalidate();
+      }
+    }
+
+    // Retag a held line after other accesses, if it is still the MRU
+    // line of its set (CacheAssocPacked contract), the new address is in
+    // the same set and not cached
+    if (heldRef && rand() % 10 == 0) {
+      ulong naddr = (rand() % nAddrs + 1)*bsize;
+      // Both lookups always happen, a hit changes the LRU order
+      Line *a = ref->findLineNoEffect(naddr);
+      Line *b = pck->findLineNoEffect(naddr);
+      if (!sameLine(a, b))
+        fail("findLine", policy, assoc, i);
+      uint set = ref->calcSet4Tag(heldRef->getTag());
+      if (a == 0 && heldRef->isValid()
+          && ref->getPLine(set*assoc) == heldRef
+          && ref->calcSet4Addr(naddr) == set) {
+        heldRef->setTag(ref->calcTag(naddr));
+        heldPck->setTag(pck->calcTag(naddr));
+      }
+      heldRef = 0;
+      heldPck = 0;
+    }
+  }
+
+  ref->destroy();
+  pck->destroy();
+
+  return hits;
+}
+
+int main(int argc, char **argv)
+{
+  int nAccesses = 400000;
+  if (argc == 2)
+    nAccesses = atoi(argv[1]);
+
+  const char *policy[2] = { "LRU", "RANDOM" };
+
+  for(int p = 0; p < 2; p++) {
+    for(int assoc = 2; assoc <= 64; assoc *= 2) {
+      srand(assoc + p);
+      int hits = check(policy[p], assoc, nAccesses);
+      fprintf(stderr,"%-6s assoc %2d: %d accesses, %d hits, same lines\n"
+              ,policy[p], assoc, nAccesses, hits);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "TraceInput.h"
+
+// Reads a generated trace file through TraceInput in the buffered,
+// asynchronous and mmap modes, with a block size that is not a multiple
+// of the read sizes, and checks every byte. It also deletes an
+// asynchronous input while its reader thread is still filling blocks.
+
+static unsigned char pattern(size_t i)
+{
+  return (unsigned char)((i * 2654435761UL) >> 13);
+}
+
+static void fail(const char *mode, size_t pos)
+{
+  fprintf(stderr,"ERROR: %s input differs at byte %lu\n", mode, (unsigned long)pos);
+  exit(-1);
+}
+
+static void check(const char *mode, TraceInput *in, size_t fileSize)
+{
+  unsigned char buf[4096];
+
+  // read sizes of the trace records (TT6, QEMU) and odd ones
+  const size_t sizes[] = { 1, 7, 16, 24, 100, 4096 };
+  const int nSizes = sizeof(sizes)/sizeof(sizes[0]);
+
+  size_t pos = 0;
+  int    r   = 0;
+  while(1) {
+    size_t n   = sizes[r++ % nSizes];
+    size_t got = in->read(buf, n);
+    for(size_t i = 0; i < got; i++) {
+      if (buf[i] != pattern(pos + i))
+        fail(mode, pos + i);
+    }
+    pos += got;
+    if (got < n)
+      break;
+  }
+
+  if (pos != fileSize)
+    fail(mode, pos);
+  if (in->read(buf, 1) != 0)
+    fail(mode, pos);
+
+  fprintf(stderr,"%-8s %lu bytes, same data\n", mode, (unsigned long)pos);
+}
+
+int main(int argc, char **argv)
+{
+  size_t fileSize = 12*1024*1024 + 13;
+  if (argc == 2)
+    fileSize = atol(argv[1]);
+
+  char fname[] = "/tmp/TraceInputCheckXXXXXX";
+  int fd = mkstemp(fname);
+  if (fd < 0) {
+    fprintf(stderr,"ERROR: could not create the trace file\n");
+    return -1;
+  }
+
+  {
+    unsigned char buf[65536];
+    for(size_t pos = 0; pos < fileSize; ) {
+      size_t n = fileSize - pos < sizeof(buf) ? fileSize - pos : sizeof(buf);
+      for(size_t i = 0; i < n; i++)
+        buf[i] = pattern(pos + i);
+      if (write(fd, buf, n) != (ssize_t)n) {
+        fprintf(stderr,"ERROR: could not write the trace file\n");
+        unlink(fname);
+        return -1;
+      }
+      pos += n;
+    }
+  }
+
+  const size_t blockSize = 64*1024 + 5;
+
+  TraceInput *in = new TraceInput(new FileTraceSource(fopen(fname, "rb")), blockSize, false);
+  check("buffered", in, fileSize);
+  delete in;
+
+  in = new TraceInput(new FileTraceSource(fopen(fname, "rb")), blockSize, true);
+  check("async", in, fileSize);
+  delete in;
+
+  void *map = mmap(0, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    fprintf(stderr,"ERROR: could not map the trace file\n");
+    unlink(fname);
+    return -1;
+  }
+  in = new TraceInput(static_cast<const unsigned char *>(map), fileSize);
+  check("mmap", in, fileSize);
+  delete in; // unmaps it
+
+  // stop the reader thread in the middle of the file
+  in = new TraceInput(new FileTraceSource(fopen(fname, "rb")), 4096, true);
+  unsigned char buf[100];
+  if (in->read(buf, sizeof(buf)) != sizeof(buf) || buf[99] != pattern(99))
+    fail("early", 0);
+  delete in;
+  fprintf(stderr,"early    delete with the reader thread running\n");
+
+  close(fd);
+  unlink(fname);
+
+  return 0;
+}